@@ -34,9 +34,12 @@
 module core
 #(parameter
     CLK_FREQ_MHZ               = 100,
-    MEMSIZE                    = 10240,
+    CWMAX                      = 12,      // SLZW maximum codeword width (9 to 16)
+    MEMSIZE                    = (5 * (1 << CWMAX)) / 2,
+    CODEC_CLK_SEL              = 0,       // SLZW codec core clock: 0 = clk, 1 = clk_x2, 2 = clk_div2
     ARUSER                     = 1'b1,    // If Cacheable accesses required, this must be 1
-    ARCACHE                    = 4'b1110  // For cacheable accesses, bit 3 must be 1, and the rest a valid value as per A4.4 of AXI4 spec.
+    ARCACHE                    = 4'b1110, // For cacheable accesses, bit 3 must be 1, and the rest a valid value as per A4.4 of AXI4 spec.
+    ACPWINBASE                 = 32'h0    // SLZW coherent job address offset. 0 whilst the AXI master is connected only to F2SDRAM
 )
 (
   input                        clk,
@@ -98,6 +101,8 @@ module core
   // AXI write address bus     
   output [31:0]                axm_awaddr,
   output  [7:0]                axm_awlen,
+  output  [3:0]                axm_awcache,
+  output                       axm_awuser,
   output  [2:0]                axm_awprot,
   output                       axm_awvalid,
   input                        axm_awready,
@@ -131,6 +136,7 @@ module core
 // ---------------------------------------------------------
 
 localparam MEM_BIT_WIDTH               = 32;
+localparam CORE_ID                     = 32'h534c5a57; // "SLZW"
 
 // ---------------------------------------------------------
 // Signal declarations
@@ -147,6 +153,9 @@ wire         slzw_codec_write;
 wire         slzw_codec_read;
 wire  [31:0] slzw_codec_readdata;
 
+wire         codec_core_clk;
+wire         codec_core_reset_n;
+
 // ---------------------------------------------------------
 // Tie off unused signals and ports
 // ---------------------------------------------------------
@@ -229,6 +238,8 @@ end
 
     .scratch                   (),
     .clk_freq_mhz              (CLK_FREQ_MHZ[9:0]),
+    .acp_win_base              (ACPWINBASE),
+    .core_id                   (CORE_ID),
 
     .avs_address               (avs_csr_address[4:0]),
     .avs_write                 (local_write),
@@ -241,17 +252,34 @@ end
 // SLZW codec
 // --------------------------------------------------------
 
+// Codec core clock, and its reset synchronised to it
+assign codec_core_clk          = (CODEC_CLK_SEL == 1) ? clk_x2   :
+                                 (CODEC_CLK_SEL == 2) ? clk_div2 :
+                                                        clk;
+
+  slzw_reset_sync codec_reset_sync_i
+  (
+    .clk                         (codec_core_clk),
+    .reset_n_in                  (reset_n),
+    .reset_n                     (codec_core_reset_n)
+  );
+
   slzw_codec
   #(
+    .CWMAX                       (CWMAX),
     .MEMSIZE                     (MEMSIZE),
     .ARUSER                      (ARUSER),
-    .ARCACHE                     (ARCACHE)
+    .ARCACHE                     (ARCACHE),
+    .ACPWINBASE                  (ACPWINBASE)
   ) slzw_codec_i
   (
     .clk                         (clk),
     .reset_n                     (reset_n),
+
+    .core_clk                    (codec_core_clk),
+    .core_reset_n                (codec_core_reset_n),
   
-    .avs_csr_address             (avs_csr_address[3:0]),
+    .avs_csr_address             (avs_csr_address[4:0]),
     .avs_csr_write               (slzw_codec_write),
     .avs_csr_writedata           (avs_csr_writedata),
     .avs_csr_read                (slzw_codec_read),
@@ -259,6 +287,8 @@ end
   
     .axm_awaddr                  (axm_awaddr),
     .axm_awlen                   (axm_awlen),
+    .axm_awcache                 (axm_awcache),
+    .axm_awuser                  (axm_awuser),
     .axm_awprot                  (axm_awprot),
     .axm_awvalid                 (axm_awvalid),
     .axm_awready                 (axm_awready),
@@ -62,12 +62,29 @@ set_parameter_property CLK_FREQ_MHZ UNITS None
 set_parameter_property CLK_FREQ_MHZ ALLOWED_RANGES -2147483648:2147483647
 set_parameter_property CLK_FREQ_MHZ DESCRIPTION "Must match pll_0's outclk0 frequency"
 set_parameter_property CLK_FREQ_MHZ HDL_PARAMETER true
-add_parameter MEMSIZE INTEGER 10240
+add_parameter CWMAX INTEGER 12 "SLZW maximum codeword width"
+set_parameter_property CWMAX DEFAULT_VALUE 12
+set_parameter_property CWMAX DISPLAY_NAME CWMAX
+set_parameter_property CWMAX TYPE INTEGER
+set_parameter_property CWMAX UNITS None
+set_parameter_property CWMAX ALLOWED_RANGES 9:16
+set_parameter_property CWMAX DESCRIPTION "SLZW maximum codeword width"
+set_parameter_property CWMAX HDL_PARAMETER true
+add_parameter MEMSIZE INTEGER 10240 "Dictionary entries. Nominally 2.5 x 2^CWMAX"
 set_parameter_property MEMSIZE DEFAULT_VALUE 10240
 set_parameter_property MEMSIZE DISPLAY_NAME MEMSIZE
 set_parameter_property MEMSIZE TYPE INTEGER
 set_parameter_property MEMSIZE UNITS None
+set_parameter_property MEMSIZE DESCRIPTION "Dictionary entries. Nominally 2.5 x 2^CWMAX"
 set_parameter_property MEMSIZE HDL_PARAMETER true
+add_parameter CODEC_CLK_SEL INTEGER 0 "SLZW codec core clock: 0 = clk, 1 = clk_x2, 2 = clk_div2"
+set_parameter_property CODEC_CLK_SEL DEFAULT_VALUE 0
+set_parameter_property CODEC_CLK_SEL DISPLAY_NAME CODEC_CLK_SEL
+set_parameter_property CODEC_CLK_SEL TYPE INTEGER
+set_parameter_property CODEC_CLK_SEL UNITS None
+set_parameter_property CODEC_CLK_SEL ALLOWED_RANGES 0:2
+set_parameter_property CODEC_CLK_SEL DESCRIPTION "SLZW codec core clock: 0 = clk, 1 = clk_x2, 2 = clk_div2"
+set_parameter_property CODEC_CLK_SEL HDL_PARAMETER true
 add_parameter ARUSER STD_LOGIC_VECTOR 1
 set_parameter_property ARUSER DEFAULT_VALUE 1
 set_parameter_property ARUSER DISPLAY_NAME ARUSER
@@ -331,6 +348,8 @@ set_interface_property altera_axi4_master SVD_ADDRESS_GROUP ""
 
 add_interface_port altera_axi4_master axm_awaddr awaddr Output 32
 add_interface_port altera_axi4_master axm_awlen awlen Output 8
+add_interface_port altera_axi4_master axm_awcache awcache Output 4
+add_interface_port altera_axi4_master axm_awuser awuser Output 1
 add_interface_port altera_axi4_master axm_awprot awprot Output 3
 add_interface_port altera_axi4_master axm_awvalid awvalid Output 1
 add_interface_port altera_axi4_master axm_awready awready Input 1
@@ -9,6 +9,11 @@
 // -----------------------------------------------------------------------------
 //  Description:
 //  This block defines the functions for the ELF reader code
+//
+//  read_elf() streams the file and writes each word with write_mem().
+//  load_elf() maps the file, validates the headers in place, and copies
+//  each PT_LOAD segment to a mapped memory with aligned multi-word copies,
+//  zero filling any .bss, and reporting the load statistics.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2022 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -30,6 +35,12 @@
 
 #include <cstdio>
 #include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "elf.h"
 #include "main.h"
@@ -47,6 +58,9 @@
 #define MEM_RD_ACCESS_WORD                             6
 #define MEM_RD_ACCESS_INSTR                            7
 
+// Words per block in burst copies
+#define BURST_WORDS                                    8
+
 // ----------------------------------
 // read_elf()
 //
@@ -189,3 +203,170 @@ int read_elf (const char * const filename)
     return 0;
 }
 
+
+// ----------------------------------
+// burst_copy()
+//
+// Copy words as blocks of BURST_WORDS,
+// loading a whole block before storing
+// it so that load and store multiples
+// are used, followed by any remainder.
+// A NULL src zero fills.
+//
+void burst_copy (uint32_t* dst, const uint32_t* src, uint32_t words)
+{
+    static const uint32_t zeros[BURST_WORDS] = {0};
+
+    const uint32_t* s   = src ? src : zeros;
+    const uint32_t  inc = src ? BURST_WORDS : 0;
+
+    for (; words >= BURST_WORDS; words -= BURST_WORDS, dst += BURST_WORDS, s += inc)
+    {
+        uint32_t w0 = s[0], w1 = s[1], w2 = s[2], w3 = s[3];
+        uint32_t w4 = s[4], w5 = s[5], w6 = s[6], w7 = s[7];
+
+        dst[0] = w0; dst[1] = w1; dst[2] = w2; dst[3] = w3;
+        dst[4] = w4; dst[5] = w5; dst[6] = w6; dst[7] = w7;
+    }
+
+    for (uint32_t idx = 0; idx < words; idx++)
+    {
+        dst[idx] = src ? s[idx] : 0;
+    }
+}
+
+// ----------------------------------
+// load_elf()
+//
+// Map ELF formatted executable from
+// filename, and load its PT_LOAD
+// segments to memory at mem (of
+// memBytes size), which corresponds
+// to address 0.
+//
+int load_elf (const char * const filename, uint32_t* mem, const uint32_t memBytes, elfLoadStats_t* stats)
+{
+    struct stat     st;
+    struct timespec start, end;
+    elfLoadStats_t  local;
+    int             fd;
+    int             status = 0;
+
+    elfLoadStats_t* s = stats ? stats : &local;
+    memset(s, 0, sizeof(elfLoadStats_t));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if ((fd = open(filename, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+    {
+        fprintf(stderr, "*** load_elf(): Unable to open file %s for reading\n", filename);
+        return USER_ERROR;
+    }
+
+    if ((size_t)st.st_size < sizeof(Elf32_Ehdr))
+    {
+        fprintf(stderr, "*** load_elf(): file too small for ELF header\n");
+        close(fd);
+        return USER_ERROR;
+    }
+
+    const uint8_t* image = (const uint8_t*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (image == MAP_FAILED)
+    {
+        fprintf(stderr, "*** load_elf(): Unable to map file %s\n", filename);
+        return USER_ERROR;
+    }
+
+    const uint32_t    size = st.st_size;
+    const Elf32_Ehdr* h    = (const Elf32_Ehdr*)image;
+
+    // Validate the headers in place
+    if (memcmp(h->e_ident, ELF_IDENT, 4) != 0)
+    {
+        fprintf(stderr, "*** load_elf(): not an ELF file\n");
+        status = USER_ERROR;
+    }
+    else if (h->e_ident[EI_CLASS] != ELFCLASS32 || h->e_ident[EI_DATA] != ELFDATA2LSB)
+    {
+        fprintf(stderr, "*** load_elf(): not a 32 bit little endian ELF file\n");
+        status = USER_ERROR;
+    }
+    else if (h->e_type != ET_EXEC)
+    {
+        fprintf(stderr, "*** load_elf(): not an executable ELF file\n");
+        status = USER_ERROR;
+    }
+    else if (h->e_machine != EM_RISCV)
+    {
+        fprintf(stderr, "*** load_elf(): not a RISC-V ELF file (e_machine=0x%03x)\n", h->e_machine);
+        status = USER_ERROR;
+    }
+    else if (h->e_phentsize != sizeof(Elf32_Phdr) ||
+             ((uint64_t)h->e_phoff + (uint64_t)h->e_phnum * sizeof(Elf32_Phdr)) > size)
+    {
+        fprintf(stderr, "*** load_elf(): program headers outside of file\n");
+        status = USER_ERROR;
+    }
+
+    // Load each PT_LOAD segment, in program header order
+    for (uint32_t pcount = 0; status == 0 && pcount < h->e_phnum; pcount++)
+    {
+        const Elf32_Phdr* ph = (const Elf32_Phdr*)(image + h->e_phoff) + pcount;
+
+        if (ph->p_type != PT_LOAD || ph->p_memsz == 0)
+        {
+            continue;
+        }
+
+        if (ph->p_filesz > ph->p_memsz || ((uint64_t)ph->p_offset + ph->p_filesz) > size)
+        {
+            fprintf(stderr, "*** load_elf(): segment %d data outside of file\n", pcount);
+            status = USER_ERROR;
+        }
+        else if (((uint64_t)ph->p_vaddr + ph->p_memsz) > memBytes)
+        {
+            fprintf(stderr, "*** load_elf(): segment memory footprint outside of internal memory range\n");
+            status = USER_ERROR;
+        }
+        else if ((ph->p_vaddr & 3) || (ph->p_offset & 3))
+        {
+            fprintf(stderr, "*** load_elf(): segment %d not word aligned\n", pcount);
+            status = USER_ERROR;
+        }
+        else
+        {
+            uint32_t*       dst      = mem + ph->p_vaddr/4;
+            const uint32_t* src      = (const uint32_t*)(image + ph->p_offset);
+            uint32_t        words    = ph->p_filesz / 4;
+            uint32_t        tail     = ph->p_filesz & 3;
+            uint32_t        memWords = (ph->p_memsz + 3) / 4;
+
+            burst_copy(dst, src, words);
+
+            // Zero padded final partial word
+            if (tail)
+            {
+                uint32_t word = 0;
+                memcpy(&word, src + words, tail);
+                dst[words++] = word;
+            }
+
+            // Zero fill .bss
+            burst_copy(dst + words, NULL, memWords - words);
+
+            s->segments++;
+            s->bytesCopied += ph->p_filesz;
+            s->bytesZeroed += ph->p_memsz - ph->p_filesz;
+        }
+    }
+
+    munmap((void*)image, size);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    s->usecs = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+
+    return status;
+}
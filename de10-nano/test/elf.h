@@ -66,6 +66,14 @@
 
 #define ELF_IDENT                 "\177ELF"
 
+#define EI_CLASS                  4
+#define EI_DATA                   5
+#define ELFCLASS32                1
+#define ELFDATA2LSB               1
+
+#define PT_NULL                   0
+#define PT_LOAD                   1
+
 #define ELF_MAX_NUM_PHDR          4
 
 #define PF_X                      0x1             /* Executable. */
@@ -114,6 +122,18 @@ typedef struct {
     Elf32_Word p_align;
 } Elf32_Phdr, *pElf32_Phdr;
 
+// Load statistics returned by load_elf()
+typedef struct {
+    uint32_t segments;            // PT_LOAD segments loaded
+    uint32_t bytesCopied;         // Bytes copied from the file image
+    uint32_t bytesZeroed;         // Bytes zero filled (.bss)
+    uint32_t usecs;               // Load time in microseconds
+} elfLoadStats_t;
+
 extern int read_elf (const char * const filename);
+extern int load_elf (const char * const filename, uint32_t* mem, const uint32_t memBytes, elfLoadStats_t* stats = NULL);
+
+// Word copy in multi-word blocks (zero fill if src is NULL)
+extern void burst_copy (uint32_t* dst, const uint32_t* src, uint32_t words);
 
 #endif
@@ -0,0 +1,295 @@
+// -----------------------------------------------------------------------------
+//  Title      : FPGA software device model
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : fpga_model.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-03
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods of the FPGA software device model
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "../build/hps_0.h"
+#include "fpga_model.h"
+#include "slzw_model.h"
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+fpgaModel::fpgaModel() : running(false)
+{
+    csr       = (uint8_t*)createShm(FPGA_MODEL_CSR_SHM,   FPGA_MODEL_CSR_SIZE);
+    sdram     = (uint8_t*)createShm(FPGA_MODEL_SDRAM_SHM, FPGA_MODEL_SDRAM_SIZE);
+    codecRegs = csr ? (volatile uint32_t*)(csr + CORE_0_BASE + FPGA_MODEL_CODEC_OFFSET) : NULL;
+
+    if (csr != NULL && sdram != NULL)
+    {
+        reset();
+
+        running = true;
+        device  = std::thread(&fpgaModel::deviceThread, this);
+    }
+}
+
+// --------------------------------------------------
+// Destructor
+// --------------------------------------------------
+
+fpgaModel::~fpgaModel()
+{
+    if (running)
+    {
+        running = false;
+        device.join();
+    }
+
+    if (csr != NULL)
+    {
+        munmap(csr, FPGA_MODEL_CSR_SIZE);
+        shm_unlink(FPGA_MODEL_CSR_SHM);
+    }
+
+    if (sdram != NULL)
+    {
+        munmap(sdram, FPGA_MODEL_SDRAM_SIZE);
+        shm_unlink(FPGA_MODEL_SDRAM_SHM);
+    }
+
+    for (size_t idx = 0; idx < localRegions.size(); idx++)
+    {
+        munmap(localRegions[idx], localSizes[idx]);
+    }
+}
+
+// --------------------------------------------------
+// Create and map a shared memory object
+// --------------------------------------------------
+
+void* fpgaModel::createShm(const char* name, const uint32_t size)
+{
+    int fd;
+
+    shm_unlink(name);
+
+    if ((fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666)) < 0)
+    {
+        fprintf(stderr, "*** fpgaModel::createShm(): could not create %s\n", name);
+        return NULL;
+    }
+
+    if (ftruncate(fd, size) < 0)
+    {
+        fprintf(stderr, "*** fpgaModel::createShm(): could not size %s\n", name);
+        close(fd);
+        return NULL;
+    }
+
+    void* vaddr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    return (vaddr == MAP_FAILED) ? NULL : vaddr;
+}
+
+// --------------------------------------------------
+// Return the memory backing a physical region. The
+// CSR and SDRAM windows are the shared memory
+// objects, and any other region (e.g. the reset
+// manager and SDRAM controller) is local memory.
+// --------------------------------------------------
+
+void* fpgaModel::map(const uint32_t paddr, const uint32_t range)
+{
+    if (paddr == FPGA_MODEL_CSR_PADDR && range <= FPGA_MODEL_CSR_SIZE)
+    {
+        return csr;
+    }
+
+    if (paddr == FPGA_MODEL_SDRAM_PADDR && range <= FPGA_MODEL_SDRAM_SIZE)
+    {
+        return sdram;
+    }
+
+    void* vaddr = mmap(NULL, range, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (vaddr == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    localRegions.push_back(vaddr);
+    localSizes.push_back(range);
+
+    return vaddr;
+}
+
+// --------------------------------------------------
+// Put the registers in their reset state
+// --------------------------------------------------
+
+void fpgaModel::reset()
+{
+    if (csr == NULL)
+    {
+        return;
+    }
+
+    memset(csr, 0, FPGA_MODEL_CSR_SIZE);
+
+    *(volatile uint32_t*)(csr + CORE_0_BASE + FPGA_MODEL_CLK_FREQ_REG) = FPGA_MODEL_CLK_FREQ_MHZ;
+    *(volatile uint32_t*)(csr + CORE_0_BASE + FPGA_MODEL_CORE_ID_REG)  = FPGA_MODEL_CORE_ID;
+
+    // Control resets with ACP window enabled and compression mode
+    codecRegs[ctrlReg]   = 0x01 | ctrlModeBit;
+    codecRegs[statusReg] = statusFinBit;
+    codecRegs[configReg] = SLZW_DEFAULT_MAXCWLEN | (SLZW_DEFAULT_MEMSIZE << 5) | configCsumBit;
+
+    // No events are traced by the model
+    codecRegs[traceStatReg] = traceEmptyBit;
+
+    // The config register's sg_depth field is left 0, as the segment list
+    // pushes can't be seen by the device thread, so the driver rejects
+    // scatter-gather jobs rather than have them run with partial lists.
+}
+
+// --------------------------------------------------
+// Run a codec job with the software model, from the
+// programmed registers. Returns the status register
+// error bits.
+// --------------------------------------------------
+
+uint32_t fpgaModel::runJob(const uint32_t ctrl)
+{
+    const uint32_t rxAddr = codecRegs[rxAddrReg];
+    const uint32_t rxLen  = codecRegs[rxLenReg];
+    const uint32_t txAddr = codecRegs[txAddrReg];
+    const uint32_t txLen  = codecRegs[txLenReg];
+
+    codecRegs[txOutLenReg] = 0;
+    codecRegs[checksumReg] = 0;
+
+    // Accesses outside of the SDRAM window are dropped
+    if (rxAddr < FPGA_MODEL_SDRAM_PADDR || txAddr < FPGA_MODEL_SDRAM_PADDR ||
+        ((uint64_t)rxAddr - FPGA_MODEL_SDRAM_PADDR + rxLen) > FPGA_MODEL_SDRAM_SIZE ||
+        ((uint64_t)txAddr - FPGA_MODEL_SDRAM_PADDR + txLen) > FPGA_MODEL_SDRAM_SIZE)
+    {
+        fprintf(stderr, "fpgaModel::runJob() : transfer outside of SDRAM window\n");
+        return 0;
+    }
+
+    slzwConfig_t cfg;
+    cfg.policy       = (ctrl & ctrlPolicyBit) ? SLZW_RESET_ADAPTIVE : SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth = SLZW_DEFAULT_MAXCWLEN;
+    cfg.memSize      = SLZW_DEFAULT_MEMSIZE;
+    cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+    slzwModel model(&cfg);
+    uint32_t  olen;
+    int       status;
+
+    model.setChecksum((ctrl & ctrlCsumBit) ? SLZW_CSUM_ADLER32 : SLZW_CSUM_CRC32);
+
+    const uint8_t* rx = sdram + (rxAddr - FPGA_MODEL_SDRAM_PADDR);
+    uint8_t*       tx = sdram + (txAddr - FPGA_MODEL_SDRAM_PADDR);
+
+    // Output beyond tx_len is truncated, as for the hardware. The model stops
+    // at the overflow, so tx_out_len is the bytes written rather than counting
+    // the dropped bytes, as the hardware's does.
+    if (ctrl & ctrlModeBit)
+    {
+        status = model.compress(rx, rxLen, tx, txLen, olen);
+    }
+    else
+    {
+        status = model.decompress(rx, rxLen, tx, txLen, olen);
+    }
+
+    codecRegs[txOutLenReg] = olen;
+    codecRegs[checksumReg] = model.getChecksum();
+
+    return (status == SLZW_ERR_OVERFLOW) ? statusOvflBit : 0;
+}
+
+// --------------------------------------------------
+// Device thread, implementing the codec register
+// semantics. Writes can't be trapped, so the thread
+// polls for a start. The previous job's status is
+// cleared before the start bit, so that the driver,
+// waiting for the start bit to read back clear, never
+// sees a stale finished status.
+// --------------------------------------------------
+
+void fpgaModel::deviceThread()
+{
+    volatile uint32_t* pCtrl = &codecRegs[ctrlReg];
+
+    while (running)
+    {
+        uint32_t ctrl = __atomic_load_n(pCtrl, __ATOMIC_ACQUIRE);
+
+        if (ctrl & (ctrlClrBit | ctrlStartBit))
+        {
+            uint32_t errBits = 0;
+
+            if (ctrl & ctrlStartBit)
+            {
+                __atomic_store_n(&codecRegs[statusReg], 0, __ATOMIC_RELEASE);
+            }
+
+            // Start and clear are self clearing
+            __atomic_and_fetch(pCtrl, ~(ctrlClrBit | ctrlStartBit), __ATOMIC_ACQ_REL);
+
+            if (ctrl & ctrlStartBit)
+            {
+                // The job cycle count is of the model's run time at the modelled clock
+                struct timespec start, end;
+
+                clock_gettime(CLOCK_MONOTONIC, &start);
+
+                errBits = runJob(ctrl);
+
+                clock_gettime(CLOCK_MONOTONIC, &end);
+
+                codecRegs[jobCyclesReg] = (uint32_t)(((end.tv_sec - start.tv_sec) * 1000000000LL +
+                                                      (end.tv_nsec - start.tv_nsec)) * FPGA_MODEL_CLK_FREQ_MHZ / 1000);
+            }
+
+            __atomic_store_n(&codecRegs[statusReg], statusFinBit | errBits, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+}
@@ -0,0 +1,137 @@
+// -----------------------------------------------------------------------------
+//  Title      : FPGA software device model
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : fpga_model.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-03
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definition of a software model of the FPGA, used
+//  as an fpgaSupport backend so that the host code runs on a machine without
+//  the platform. The lightweight bridge (CSR) window and the reserved SDRAM
+//  window are backed by shared memory objects, and other regions by local
+//  memory.
+//
+//  A device thread implements the slzw_codec register semantics, running
+//  jobs with the SLZW software model: a start (or clr) written to the
+//  control register is cleared, finished is deasserted (before the start is
+//  cleared) whilst the job runs,
+//  and the data is read from, and written to, the SDRAM window at the
+//  programmed rx/tx addresses. The config register and the core's clock
+//  frequency register are set, and other registers behave as plain memory.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _FPGA_MODEL_H_
+#define _FPGA_MODEL_H_
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+// Shared memory objects backing the CSR and SDRAM windows
+#define FPGA_MODEL_CSR_SHM        "/slzw_fpga_csr"
+#define FPGA_MODEL_SDRAM_SHM      "/slzw_fpga_sdram"
+
+#define FPGA_MODEL_CSR_PADDR      0xff200000
+#define FPGA_MODEL_CSR_SIZE       0x200000
+#define FPGA_MODEL_SDRAM_PADDR    0x20000000
+#define FPGA_MODEL_SDRAM_SIZE     0x10000000
+
+// Core register byte offsets from the core's base (CORE_0_BASE): the local clock
+// frequency and ID registers, and the slzw_codec block (core.json)
+#define FPGA_MODEL_CLK_FREQ_REG   0x00004
+#define FPGA_MODEL_CORE_ID_REG    0x0000c
+#define FPGA_MODEL_CODEC_OFFSET   0x20000
+
+// Modelled build parameters
+#define FPGA_MODEL_CLK_FREQ_MHZ   100
+#define FPGA_MODEL_CORE_ID        0x534c5a57
+
+// --------------------------------------------------
+// CLASS DEFINITION
+// --------------------------------------------------
+
+class fpgaModel
+{
+public:
+    fpgaModel();
+    ~fpgaModel();
+
+    // Return the model's memory backing the physical region, or NULL
+    void*    map             (const uint32_t paddr, const uint32_t range);
+
+    // Reset the register state
+    void     reset           ();
+
+private:
+    // slzw_codec register word indexes (doc/slzw_codec.json)
+    static const uint32_t ctrlReg       = 0;
+    static const uint32_t statusReg     = 1;
+    static const uint32_t rxAddrReg     = 2;
+    static const uint32_t rxLenReg      = 3;
+    static const uint32_t txAddrReg     = 4;
+    static const uint32_t txLenReg      = 5;
+    static const uint32_t configReg     = 6;
+    static const uint32_t traceStatReg  = 8;
+    static const uint32_t txOutLenReg   = 14;
+    static const uint32_t checksumReg   = 15;
+    static const uint32_t jobCyclesReg  = 16;
+
+    // Control register fields
+    static const uint32_t ctrlModeBit   = 0x02;
+    static const uint32_t ctrlClrBit    = 0x08;
+    static const uint32_t ctrlStartBit  = 0x10;
+    static const uint32_t ctrlPolicyBit = 0x20;
+    static const uint32_t ctrlCsumBit   = 0x100;
+
+    // Status register fields
+    static const uint32_t statusFinBit  = 0x01;
+    static const uint32_t statusOvflBit = 0x02;
+    static const uint32_t traceEmptyBit = 0x01;
+
+    // Config register fields
+    static const uint32_t configCsumBit = 0x80000000;
+
+    void*    createShm       (const char* name, const uint32_t size);
+    uint32_t runJob          (const uint32_t ctrl);
+    void     deviceThread    ();
+
+    uint8_t*                  csr;
+    uint8_t*                  sdram;
+    volatile uint32_t*        codecRegs;
+    std::vector<void*>        localRegions;
+    std::vector<uint32_t>     localSizes;
+
+    std::atomic<bool>         running;
+    std::thread               device;
+};
+
+#endif
@@ -11,6 +11,15 @@
 //  This code defines a class to support running test code on FPGA platform.
 //  It provide means to reset the FPGA, and to get virtual address to 
 //  the CSR lightweight bridge, the SDRAM controller, and memory mapped RAM
+//
+//  After an FPGA reset, readiness is polled by writing and reading back a
+//  scratch register over the lightweight bridge, when one is given, with
+//  a bounded timeout, rather than waiting a fixed time.
+//
+//  The regions are normally mapped from /dev/mem. With the model backend,
+//  selected by the constructor or by setting the FPGA_BACKEND environment
+//  variable to "model", they are instead backed by a software model of the
+//  FPGA (see fpga_model.h), so that host code runs without the platform.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2022 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -36,6 +45,15 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "../build/hps_0.h"
+#include "fpga_model.h"
 
 #ifndef _FPGA_SUPPORT_H_
 #define _FPGA_SUPPORT_H_
@@ -49,6 +67,23 @@
 #define HPS_RST_MGR_PADDR   0xffd05000
 #define START_FPGA_PHY_MEM  0x20000000
 
+// Reset recovery: no ready register to poll, default timeout and
+// scratch test pattern
+#define FPGA_NO_READY_REG      0xffffffff
+#define FPGA_RESET_TIMEOUT_US  1000000
+#define FPGA_READY_PATTERN     0x5a3cc3a5
+
+// Core ID register (core.json core_id) byte offset from the first core's base
+// (CORE_0_BASE, from hps_0.h), and its value. Polled on reset recovery when
+// no ready register is given.
+#define FPGA_CORE_ID_OFFSET    0x0000c
+#define FPGA_CORE_ID           0x534c5a57
+
+// Memory backends, and the environment variable selecting the default
+#define FPGA_BACKEND_DEVMEM    0
+#define FPGA_BACKEND_MODEL     1
+#define FPGA_BACKEND_ENV       "FPGA_BACKEND"
+
 // --------------------------------------------------
 // CLASS DEFINITION
 // --------------------------------------------------
@@ -65,17 +100,48 @@ private:
 
 public:
     // Constructor
-    fpgaSupport(){
+    fpgaSupport(const int backend = getDefaultBackend()){
         memDevFd     = -1;
         fpgaVaddr    = nullptr;
         sdramVaddr   = nullptr;
         rstMgrVaddr  = nullptr;
         sdrCtrlVaddr = nullptr;
+        recoveryUs   = 0;
+        model        = (backend == FPGA_BACKEND_MODEL) ? new fpgaModel() : nullptr;
+    };
+
+    // Destructor
+    ~fpgaSupport(){
+        delete model;
+    };
+
+    // --------------------------------------------------
+    // Method to return the default backend, from the
+    // FPGA_BACKEND environment variable
+    static int getDefaultBackend()
+    {
+        const char* env = getenv(FPGA_BACKEND_ENV);
+
+        return (env != NULL && strcmp(env, "model") == 0) ? FPGA_BACKEND_MODEL : FPGA_BACKEND_DEVMEM;
     };
 
     // --------------------------------------------------
-    // Method to reset the FPGA
-    bool fullResetFpga()
+    // Method to return whether the FPGA is modelled
+    bool isModel()
+    {
+        return model != nullptr;
+    };
+
+    // --------------------------------------------------
+    // Method to reset the FPGA. If readyRegOffset is the
+    // byte offset of a scratch register over the
+    // lightweight bridge, it is polled until a written
+    // value reads back (restoring it to 0), for up to
+    // timeoutUs. Otherwise the first core's ID register
+    // is polled until it reads FPGA_CORE_ID. Returns
+    // false on failure, or if not ready in time.
+    bool fullResetFpga(const uint32_t readyRegOffset = FPGA_NO_READY_REG,
+                       const uint32_t timeoutUs      = FPGA_RESET_TIMEOUT_US)
     {
         // Get a pointer to the Reset Manager
         if(rstMgrVaddr == nullptr)
@@ -95,7 +161,23 @@ public:
             usleep(1);
             *pMiscModRst = d & ~MiscMod_H2FResetMask;
 
-            usleep(1000000); // time to recover
+            if (model != nullptr)
+            {
+                model->reset();
+            }
+
+            uint64_t start = timeUs();
+            bool     ready = (readyRegOffset == FPGA_NO_READY_REG) ? waitValue(CORE_0_BASE + FPGA_CORE_ID_OFFSET, FPGA_CORE_ID, timeoutUs) :
+                                                                     waitReady(readyRegOffset, timeoutUs);
+
+            if (!ready)
+            {
+                recoveryUs = timeUs() - start;
+                fprintf(stderr, "fullResetFpga() : FPGA not ready after %d us\n", recoveryUs);
+                return false;
+            }
+
+            recoveryUs = timeUs() - start;
         }
         else
         {
@@ -105,6 +187,14 @@ public:
         return true;
     };
 
+    // --------------------------------------------------
+    // Method to return the time taken to recover from
+    // the last reset, in microseconds
+    uint32_t getResetRecoveryUs()
+    {
+        return recoveryUs;
+    };
+
     // --------------------------------------------------
     // Method that returns the virtual address of the
     // FPGA lightweight bridge that the CSR bus is
@@ -146,6 +236,84 @@ public:
     };
 
 private:
+    // --------------------------------------------------
+    // Method to return a monotonic time in microseconds
+    static uint64_t timeUs()
+    {
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+    };
+
+    // --------------------------------------------------
+    // Method to poll the scratch register at the given
+    // bridge byte offset until a written value reads
+    // back, or timeoutUs has elapsed. A different value
+    // is written each poll, so a stale read can't match.
+    bool waitReady(const uint32_t readyRegOffset, const uint32_t timeoutUs)
+    {
+        uint8_t* base = (uint8_t*)getFpgaVirtualBaseAddress();
+
+        if (base == nullptr || base == (uint8_t*)MAP_FAILED)
+        {
+            return false;
+        }
+
+        volatile uint32_t* pReady = (volatile uint32_t*)(base + readyRegOffset);
+        uint64_t           start  = timeUs();
+
+        for (uint32_t count = 0; ; count++)
+        {
+            const uint32_t pattern = FPGA_READY_PATTERN ^ count;
+
+            *pReady = pattern;
+
+            if (*pReady == pattern)
+            {
+                *pReady = 0;
+                return true;
+            }
+
+            if ((timeUs() - start) >= timeoutUs)
+            {
+                return false;
+            }
+
+            usleep(1);
+        }
+    };
+
+    // --------------------------------------------------
+    // Method to poll the register at the given bridge
+    // byte offset until it reads value, or timeoutUs
+    // has elapsed
+    bool waitValue(const uint32_t regOffset, const uint32_t value, const uint32_t timeoutUs)
+    {
+        uint8_t* base = (uint8_t*)getFpgaVirtualBaseAddress();
+
+        if (base == nullptr || base == (uint8_t*)MAP_FAILED)
+        {
+            return false;
+        }
+
+        volatile uint32_t* pReg  = (volatile uint32_t*)(base + regOffset);
+        uint64_t           start = timeUs();
+
+        while (*pReg != value)
+        {
+            if ((timeUs() - start) >= timeoutUs)
+            {
+                return false;
+            }
+
+            usleep(1);
+        }
+
+        return true;
+    };
+
     // --------------------------------------------------
     // Method to open the /dev/mem device file and return
     // the file descriptor
@@ -166,22 +334,37 @@ private:
     // specified physical address over the given range.
     void* getVirtualAddress(uint32_t* paddr, uint32_t range)
     {
+        if (model != nullptr)
+        {
+            return model->map((uint32_t)(uintptr_t)paddr, range);
+        }
+
         if (memDevFd < 0)
         {
             memDevFd = openMemDevice();
         }
 
-        return mmap( NULL, range, ( PROT_READ | PROT_WRITE ), MAP_SHARED, memDevFd, (uint32_t)paddr);
+        if (memDevFd < 0)
+        {
+            return nullptr;
+        }
+
+        void* vaddr = mmap( NULL, range, ( PROT_READ | PROT_WRITE ), MAP_SHARED, memDevFd, (uint32_t)(uintptr_t)paddr);
 
+        return (vaddr == MAP_FAILED) ? nullptr : vaddr;
     };
 
     // --------------------------------------------------
     // Private member variables
-    int   memDevFd;
-    void* fpgaVaddr;
-    void* sdramVaddr;
-    void* rstMgrVaddr;
-    void* sdrCtrlVaddr;
+    int      memDevFd;
+    void*    fpgaVaddr;
+    void*    sdramVaddr;
+    void*    rstMgrVaddr;
+    void*    sdrCtrlVaddr;
+    uint32_t recoveryUs;
+
+    // Software model of the FPGA, if selected
+    fpgaModel* model;
 };
 
 #endif
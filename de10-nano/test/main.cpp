@@ -9,6 +9,14 @@
 // -----------------------------------------------------------------------------
 //  Description:
 //  This file has the top level code for platform test
+//
+//  The program maps the device and resets the FPGA once. It then runs either
+//  test.exe (or test.slzw with -z), or each program in a list file (-l). A
+//  program is loaded whilst the core is halted, the halt is released, and
+//  the PASS/FAIL status collected from the GP register when it halts again.
+//  The core halts at the end of each program, ready for the next, so the
+//  FPGA is only reset again if a program fails to halt. A consolidated
+//  report is written for list runs.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2022 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -35,16 +43,52 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
 
 #include "../build/hps_0.h"
 #include "fpga_support.h"
 #include "elf.h"
+#include "slzw_loader.h"
 #include "main.h"
 
 // --------------------------------------------------
 // DEFINES
 // --------------------------------------------------
 
+// Size of the lightweight bridge region and reserved SDRAM window mapped by fpgaSupport
+#define LW_BRIDGE_SPAN_BYTES 0x200000
+#define SDRAM_WINDOW_BYTES   0x10000000
+
+// Byte offset of the core's local scratch register (core.json), polled for
+// readiness after an FPGA reset
+#define CORE_SCRATCH_OFFSET  0x00000000
+
+// Default consolidated report file for list runs
+#define DEFAULT_REPORT_FILE  "report.log"
+
+// Halt wait, in 1us polls
+#define HALT_TIMEOUT_US      10000
+
+// Test status values
+#define TEST_PASS            0
+#define TEST_FAIL            1
+#define TEST_TIMEOUT         2
+#define TEST_LOAD_ERROR      3
+
+// --------------------------------------------------
+// TYPEDEFS
+// --------------------------------------------------
+
+typedef struct {
+    std::string name;
+    int         status;
+    uint32_t    gp;
+    uint32_t    loadUs;
+    uint32_t    runUs;
+} testResult_t;
+
 // --------------------------------------------------
 // STATIC VARIABLES
 // --------------------------------------------------
@@ -60,41 +104,43 @@ void  write_mem(uint32_t addr, uint32_t word, uint32_t type, bool &access_fault)
     pImem[addr/4] = word;
 }
 
-// ==================================================
-// MIAN FUNCTION
-// ==================================================
+// --------------------------------------------------
+// Return a monotonic time in microseconds
+// --------------------------------------------------
 
-int main(int argc, char** argv)
+static uint64_t timeUs()
 {
-    const uint32_t sdrCtrlFpgaPortRstWordOffset   = 0x20;
-    fpgaSupport    fpga;
-    int            error                          = 0;
-    bool           scall                          = false;
+    struct timespec ts;
 
-    printf("\n**********************************\n");
-    printf(  "*     Wyvern Semiconductors      *\n");
-    printf(  "*   de10-nano (ARM Cortex-A9)    *\n");
-    printf(  "*      Copyright (c) 2022        *\n");
-    printf(  "**********************************\n\n");
-    
-    if (argc > 1)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// --------------------------------------------------
+// Reset the FPGA and set up the core for running
+// programs. Returns the core HAL, or NULL if the
+// FPGA did not come out of reset.
+// --------------------------------------------------
+
+static CCoreAuto* initCore(fpgaSupport &fpga, const bool scall)
+{
+    const uint32_t sdrCtrlFpgaPortRstWordOffset = 0x20;
+
+    // Reset the FPGA, and wait for the core to be accessible
+    if (!fpga.fullResetFpga(CORE_0_BASE + CORE_SCRATCH_OFFSET))
     {
-        if (strcmp(argv[1], "-s") == 0)
-        {
-            scall = true;
-        }
+        printf("FPGA reset failed: ***FAIL***\n");
+        return NULL;
     }
 
-    usleep(1);
-
-    // Reset the FPGA
-    fpga.fullResetFpga();
+    printf("FPGA ready %d us after reset\n", fpga.getResetRecoveryUs());
 
     // Get the virtual base address of the lightweight bus that the CSR bus is accessed from
     void*     fpgaBaseAddr = fpga.getFpgaVirtualBaseAddress();
 
     // Point to the CSR registers
-    uint32_t* coreBaseAddr = (uint32_t*)((uint32_t)fpgaBaseAddr + CORE_0_BASE);
+    uint32_t* coreBaseAddr = (uint32_t*)((uintptr_t)fpgaBaseAddr + CORE_0_BASE);
 
     // Get a virtual address of the base of the Cyclone V sdr registers
     volatile uint32_t* sdramCtrlRegBase = (uint32_t*)fpga.getSdrCtrlVirtualBaseAddress();
@@ -102,8 +148,6 @@ int main(int argc, char** argv)
     // Bring out of reset SDRAM controller ports 0 and 1 for read write and control
     sdramCtrlRegBase[sdrCtrlFpgaPortRstWordOffset] = 0x3fff;
 
-    // ---------------------------
-
     CCoreAuto* pCore = new CCoreAuto(coreBaseAddr);
 
     // Set up control register for test
@@ -115,49 +159,289 @@ int main(int argc, char** argv)
     // Get the base address of IMEM (in the CSR register space)
     pImem = (uint32_t*)((uint8_t*)coreBaseAddr + CSR_CORE_IMEM);
 
-    // Load the test code to memory
-    read_elf("test.exe");
+    return pCore;
+}
+
+// --------------------------------------------------
+// Load a program (ELF, or compressed image if the
+// name ends .slzw) into IMEM. Returns non-zero on
+// error.
+// --------------------------------------------------
+
+static int loadProgram(fpgaSupport &fpga, CCoreAuto* pCore, const std::string &name)
+{
+    // Loading is bounded by the mapped bridge region
+    uint32_t imemBytes = LW_BRIDGE_SPAN_BYTES - CORE_0_BASE - CSR_CORE_IMEM;
+    size_t   extPos    = name.rfind(".slzw");
+
+    if (extPos != std::string::npos && extPos == name.size() - 5)
+    {
+        slzwDriver        driver(pCore, 1);
+        slzwLoaderHw_t    hw;
+        slzwLoaderStats_t stats;
+
+        hw.pDriver      = &driver;
+        hw.maxCodeWidth = pCore->pSlzwCodec->pConfig->GetMaxCw();
+        hw.sdramVaddr   = (uint8_t*)fpga.getSdramVirtualBaseAddress();
+        hw.sdramPaddr   = START_FPGA_PHY_MEM;
+        hw.sdramSize    = SDRAM_WINDOW_BYTES;
+
+        if (load_slzw_image(name.c_str(), (uint32_t*)pImem, imemBytes, &hw, &stats))
+        {
+            return 1;
+        }
+
+        printf("Loaded %d segments (%d bytes read, %d bytes loaded, %d zeroed) in %d us\n",
+               stats.segments, stats.bytesRead, stats.bytesLoaded, stats.bytesZeroed, stats.usecs);
+    }
+    else
+    {
+        elfLoadStats_t stats;
+
+        if (load_elf(name.c_str(), (uint32_t*)pImem, imemBytes, &stats))
+        {
+            return 1;
+        }
+
+        printf("Loaded %d segments (%d bytes, %d zeroed) in %d us (%.2f MB/s)\n",
+               stats.segments, stats.bytesCopied, stats.bytesZeroed, stats.usecs,
+               stats.usecs ? (double)(stats.bytesCopied + stats.bytesZeroed) / (double)stats.usecs : 0.0);
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Load and run a program on the halted core, and
+// collect its status
+// --------------------------------------------------
+
+static void runProgram(fpgaSupport &fpga, CCoreAuto* pCore, const std::string &name, testResult_t &result)
+{
+    result.name   = name;
+    result.gp     = 0;
+    result.runUs  = 0;
+
+    printf("Running %s\n", name.c_str());
+
+    uint64_t start = timeUs();
+
+    if (loadProgram(fpga, pCore, name))
+    {
+        printf("Failed to load %s: ***FAIL***\n", name.c_str());
+        result.status = TEST_LOAD_ERROR;
+        result.loadUs = timeUs() - start;
+        return;
+    }
+
+    result.loadUs = timeUs() - start;
+    start         = timeUs();
 
     // Bring the core out of reset
     pCore->pControl->SetClrHalt(1);
 
     // Wait for halt status
-    int32_t  timeout = 10000;
+    int32_t  timeout = HALT_TIMEOUT_US;
     while(!pCore->pStatus->GetHalted() && timeout != 0)
     {
         timeout--;
         usleep(1);
     }
 
+    result.runUs = timeUs() - start;
+    result.gp    = pCore->pGp->GetGp();
+
     // If reached timeout, flag as an error
     if (timeout == 0)
     {
-        uint32_t gp = pCore->pGp->GetGp();
-        
-        printf("Test timed out (gp = 0x%08x): ***FAIL***\n", gp);
-        
-        error = 2;
+        printf("Test timed out (gp = 0x%08x): ***FAIL***\n", result.gp);
+
+        result.status = TEST_TIMEOUT;
+    }
+    // Check for PASS/FAIL. Bottom bit should be set. Test number of failure
+    // in bits 31:1. A test number of 0 is a pass.
+    else if (result.gp == 1)
+    {
+        printf("Test exit code = %d : PASS\n", result.gp >> 1);
+
+        result.status = TEST_PASS;
     }
     else
     {
-        // Get test status (value of GP register)
-        uint32_t gp = pCore->pGp->GetGp();
+        printf("Test exit code = %d : ***FAIL***\n", result.gp);
+
+        result.status = TEST_FAIL;
+    }
+}
 
-        // Check for PASS/FAIL. Bottom bit should be set. Test number of failure 
-        // in bits 31:1. A test number of 0 is a pass.
-        if (gp == 1)
+// --------------------------------------------------
+// Read a list of program file names, one per line,
+// ignoring blank lines and # comments
+// --------------------------------------------------
+
+static int readList(const char* filename, std::vector<std::string> &list)
+{
+    FILE* fp;
+    char  line[1024];
+
+    if ((fp = fopen(filename, "r")) == NULL)
+    {
+        fprintf(stderr, "*** readList(): Unable to open file %s for reading\n", filename);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        char* name = strtok(line, " \t\r\n");
+
+        if (name != NULL && name[0] != '#')
         {
-            printf("Test exit code = %d : PASS\n", gp >> 1);
+            list.push_back(name);
         }
-        else
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Write the consolidated report
+// --------------------------------------------------
+
+static void writeReport(const char* filename, const std::vector<testResult_t> &results, const uint32_t resets, const uint64_t totalUs)
+{
+    static const char* statusStr[] = {"PASS", "FAIL", "TIMEOUT", "LOADERR"};
+
+    FILE* fp;
+    int   passes = 0;
+
+    if ((fp = fopen(filename, "w")) == NULL)
+    {
+        fprintf(stderr, "*** writeReport(): Unable to open file %s for writing\n", filename);
+        return;
+    }
+
+    fprintf(fp, "%-8s %-10s %10s %10s  %s\n", "Status", "GP", "Load (us)", "Run (us)", "Program");
+
+    for (size_t idx = 0; idx < results.size(); idx++)
+    {
+        fprintf(fp, "%-8s 0x%08x %10d %10d  %s\n", statusStr[results[idx].status], results[idx].gp,
+                results[idx].loadUs, results[idx].runUs, results[idx].name.c_str());
+
+        passes += (results[idx].status == TEST_PASS) ? 1 : 0;
+    }
+
+    fprintf(fp, "\n%d of %zu passed, %d recovery resets, %.3f s total\n",
+            passes, results.size(), resets, (double)totalUs / 1e6);
+
+    fclose(fp);
+
+    printf("\n%d of %zu passed (report in %s)\n", passes, results.size(), filename);
+}
+
+// ==================================================
+// MIAN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    fpgaSupport                fpga;
+    int                        error      = 0;
+    bool                       scall      = false;
+    bool                       compressed = false;
+    const char*                listFile   = NULL;
+    const char*                reportFile = DEFAULT_REPORT_FILE;
+    std::vector<std::string>   programs;
+    std::vector<testResult_t>  results;
+    uint32_t                   resets     = 0;
+
+    printf("\n**********************************\n");
+    printf(  "*     Wyvern Semiconductors      *\n");
+    printf(  "*   de10-nano (ARM Cortex-A9)    *\n");
+    printf(  "*      Copyright (c) 2022        *\n");
+    printf(  "**********************************\n\n");
+
+    for (int idx = 1; idx < argc; idx++)
+    {
+        if (strcmp(argv[idx], "-s") == 0)
+        {
+            scall = true;
+        }
+        // Load compressed image test.slzw, decompressing on the FPGA
+        else if (strcmp(argv[idx], "-z") == 0)
+        {
+            compressed = true;
+        }
+        // Run each program in a list file
+        else if (strcmp(argv[idx], "-l") == 0 && (idx + 1) < argc)
+        {
+            listFile = argv[++idx];
+        }
+        // Report file for list runs
+        else if (strcmp(argv[idx], "-r") == 0 && (idx + 1) < argc)
+        {
+            reportFile = argv[++idx];
+        }
+    }
+
+    if (listFile != NULL)
+    {
+        if (readList(listFile, programs))
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        programs.push_back(compressed ? "test.slzw" : "test.exe");
+    }
+
+    usleep(1);
+
+    uint64_t   start = timeUs();
+    CCoreAuto* pCore = initCore(fpga, scall);
+
+    if (pCore == NULL)
+    {
+        return TEST_TIMEOUT;
+    }
+
+    // ---------------------------
+
+    for (size_t idx = 0; idx < programs.size(); idx++)
+    {
+        testResult_t result;
+
+        runProgram(fpga, pCore, programs[idx], result);
+
+        results.push_back(result);
+
+        error = (result.status != TEST_PASS) ? result.status : error;
+
+        // A core that did not halt needs a full reset before the next program
+        if (result.status == TEST_TIMEOUT && (idx + 1) < programs.size())
         {
-            printf("Test exit code = %d : ***FAIL***\n", gp);
-            error = 1;
+            delete pCore;
+            pCore = initCore(fpga, scall);
+            resets++;
+
+            if (pCore == NULL)
+            {
+                break;
+            }
         }
     }
 
     // ---------------------------
 
+    if (listFile != NULL)
+    {
+        writeReport(reportFile, results, resets, timeUs() - start);
+    }
+
+    delete pCore;
+
     // Wait a bit
     usleep(1);
 
@@ -167,4 +451,3 @@ int main(int argc, char** argv)
     return(error);
 
 }
-
@@ -21,17 +21,23 @@
 #
 # Remove key directories and files to ensure a clean build and run
 #
-rm -f test.log
+rm -f test.log test.lst report.log
 
 #########################################
 # Run tests from here
 #########################################
 
+# Build a list of the test programs, and run them all from a single
+# invocation of main.exe, so the FPGA is only reset once
+ls test/*.exe > test.lst
 
+./main.exe -l test.lst -r report.log > test.log
 
 #########################################
 
 #
 # Display the test log
 #
-grep "Test exit" test.log
+grep "Test exit\|timed out\|Failed to load" test.log
+
+cat report.log
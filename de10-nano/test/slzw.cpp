@@ -0,0 +1,792 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW command line file compressor
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-09
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file has the top level code for a command line program to compress
+//  and decompress files with the slzw_codec, in the framed format of
+//  slzw_frame.h.
+//
+//  The input file is mapped, and processed in chunks staged through slots
+//  in the reserved SDRAM window. Jobs for several slots are queued in the
+//  driver at once, so that copying the next chunk in, and writing the last
+//  chunk's frame out, overlap with the codec's execution. Frames are written
+//  in order as their jobs are retired.
+//
+//  Each chunk is compressed as a block, with the codec cleared before it,
+//  and the frames are followed by a block index. With -r, a byte range of
+//  the uncompressed data is extracted by decoding only the blocks covering
+//  it (see slzw_archive.h), on the codec and on software engines in
+//  parallel.
+//
+//  When no FPGA is present (no FPGA manager device, and FPGA_BACKEND not
+//  set to model), when the FPGA fails to reset, with -s, or when
+//  decompressing a file compressed with a different CWMAX to the codec's,
+//  chunks are processed with the SLZW software model instead.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "../build/hps_0.h"
+#include "fpga_support.h"
+#include "slzw_driver.h"
+#include "slzw_model.h"
+#include "slzw_frame.h"
+#include "slzw_archive.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+// Present when the kernel has an FPGA manager, i.e. on the platform
+#define FPGA_MANAGER_DEV          "/sys/class/fpga_manager/fpga0"
+
+#define DEFAULT_CHUNK_BYTES       (1024*1024)
+#define MAX_CHUNK_BYTES           (16*1024*1024)
+
+// Staging slots at the start of the SDRAM window, each with an input and an
+// output area (NUM_SLOTS slots for the maximum chunk size fit in the window)
+#define NUM_SLOTS                 4
+#define SLOT_ALIGN                4096
+
+// Compressed data capacity for a chunk, allowing for expansion of up to
+// SLZW_MAXCWLIMIT bits per input byte
+#define DATA_CAPACITY(_len)       (2*(_len) + 1024)
+
+// --------------------------------------------------
+// TYPEDEFS
+// --------------------------------------------------
+
+// Hardware codec resources. A NULL driver selects the software model.
+typedef struct {
+    slzwDriver* pDriver;
+    uint8_t*    sdramVaddr;
+    uint32_t    sdramPaddr;
+    uint32_t    slotBytes;          // Bytes per staging slot
+    uint32_t    txOffset;           // Output area offset in a slot
+} codecHw_t;
+
+// A chunk queued in the driver, or stored raw, awaiting its frame being written
+typedef struct {
+    uint32_t                     slot;
+    uint32_t                     rawLen;
+    uint32_t                     checksum;  // Expected checksum, when decompressing
+    const uint8_t*               data;      // Input data, for raw frames
+    bool                         queued;    // Job submitted to the driver
+    std::future<slzwJobResult_t> result;
+} pending_t;
+
+// --------------------------------------------------
+// STATIC VARIABLES
+// --------------------------------------------------
+
+static uint64_t rawBytes  = 0;
+static uint64_t fileBytes = 0;
+
+// Block index entries for the frames written
+static std::vector<slzwFrmIdx_t> blockIndex;
+
+// --------------------------------------------------
+// Monotonic time in microseconds
+// --------------------------------------------------
+
+static uint64_t timeUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// --------------------------------------------------
+// Write bytes to the output file
+// --------------------------------------------------
+
+static int writeOut(FILE* ofp, const void* buf, const uint32_t len)
+{
+    if (len != 0 && fwrite(buf, 1, len, ofp) != len)
+    {
+        fprintf(stderr, "*** writeOut(): error writing output file\n");
+        return USER_ERROR;
+    }
+
+    fileBytes += len;
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Write a frame, with its header
+// --------------------------------------------------
+
+static int writeFrame(FILE* ofp, const uint32_t rawLen, const uint32_t flags, const uint32_t checksum,
+                      const uint8_t* data, const uint32_t dataLen)
+{
+    slzwFrm_t    frm = {rawLen, dataLen, flags, checksum};
+    slzwFrmIdx_t idx = {fileBytes + sizeof(frm), rawLen, dataLen, flags, checksum};
+
+    blockIndex.push_back(idx);
+
+    if (writeOut(ofp, &frm, sizeof(frm)) || writeOut(ofp, data, dataLen))
+    {
+        return USER_ERROR;
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Write the end frame, followed by the block index
+// and its trailer
+// --------------------------------------------------
+
+static int writeEnd(FILE* ofp)
+{
+    slzwFrm_t        end     = {0, 0, 0, 0};
+    slzwFrmTrailer_t trailer = {SLZW_FRM_IDX_MAGIC, (uint32_t)blockIndex.size(), fileBytes + sizeof(end)};
+
+    if (writeOut(ofp, &end, sizeof(end)) ||
+        writeOut(ofp, blockIndex.data(), blockIndex.size() * sizeof(slzwFrmIdx_t)) ||
+        writeOut(ofp, &trailer, sizeof(trailer)))
+    {
+        return USER_ERROR;
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Retire the oldest pending compression job, writing
+// its frame. Chunks that don't compress are stored
+// raw.
+// --------------------------------------------------
+
+static int retireCompress(FILE* ofp, const codecHw_t &hw, std::deque<pending_t> &pending)
+{
+    pending_t      p        = std::move(pending.front());
+    const uint8_t* txBuf    = hw.sdramVaddr + p.slot * hw.slotBytes + hw.txOffset;
+    uint32_t       checksum = 0;
+
+    pending.pop_front();
+
+    slzwJobResult_t result = p.result.get();
+
+    if (result.status != SLZW_DRV_OK && result.status != SLZW_DRV_OVERFLOW)
+    {
+        fprintf(stderr, "*** retireCompress(): codec job failed with status %d\n", result.status);
+        return USER_ERROR;
+    }
+
+    // Output that overflowed the buffer didn't compress, so the chunk is stored raw. Raw
+    // frames are rare, so their checksum is calculated here as the codec's may be partial.
+    if (result.status == SLZW_DRV_OVERFLOW || result.outLen >= p.rawLen)
+    {
+        return writeFrame(ofp, p.rawLen, SLZW_FRM_RAW, slzwModel::crc32(p.data, p.rawLen), p.data, p.rawLen);
+    }
+
+    checksum = hw.pDriver->hasChecksum() ? result.checksum : slzwModel::crc32(p.data, p.rawLen);
+
+    return writeFrame(ofp, p.rawLen, 0, checksum, txBuf, result.outLen);
+}
+
+// --------------------------------------------------
+// Compress the input to framed output
+// --------------------------------------------------
+
+static int compressFile(const uint8_t* in, const uint64_t inLen, FILE* ofp, const codecHw_t &hw,
+                        slzwModel &model, const uint32_t chunkBytes)
+{
+    std::deque<pending_t> pending;
+    std::vector<uint8_t>  buf(hw.pDriver ? 0 : DATA_CAPACITY(chunkBytes));
+    uint32_t              slot = 0;
+
+    for (uint64_t offset = 0; offset < inLen; offset += chunkBytes)
+    {
+        const uint32_t rawLen = (inLen - offset) < chunkBytes ? (uint32_t)(inLen - offset) : chunkBytes;
+
+        rawBytes += rawLen;
+
+        // Software model
+        if (hw.pDriver == NULL)
+        {
+            uint32_t olen;
+
+            if (model.compress(in + offset, rawLen, buf.data(), buf.size(), olen) != SLZW_OK || olen >= rawLen)
+            {
+                if (writeFrame(ofp, rawLen, SLZW_FRM_RAW, slzwModel::crc32(in + offset, rawLen), in + offset, rawLen))
+                {
+                    return USER_ERROR;
+                }
+            }
+            else if (writeFrame(ofp, rawLen, 0, model.getChecksum(), buf.data(), olen))
+            {
+                return USER_ERROR;
+            }
+
+            continue;
+        }
+
+        // Free the slot for this chunk by retiring its last job
+        if (pending.size() == NUM_SLOTS && retireCompress(ofp, hw, pending))
+        {
+            return USER_ERROR;
+        }
+
+        const uint32_t slotOffset = slot * hw.slotBytes;
+
+        memcpy(hw.sdramVaddr + slotOffset, in + offset, rawLen);
+
+        slzwJob_t job = {};
+
+        job.mode        = SLZW_DRV_COMPRESS;
+        job.resetPolicy = model.getConfig().policy;
+        job.csumType    = SLZW_DRV_CRC32;
+        job.clrDict     = 1;
+        job.rxAddr      = hw.sdramPaddr + slotOffset;
+        job.rxLen       = rawLen;
+        job.txAddr      = hw.sdramPaddr + slotOffset + hw.txOffset;
+        job.txLen       = DATA_CAPACITY(rawLen);
+
+        pending_t p;
+
+        p.slot     = slot;
+        p.rawLen   = rawLen;
+        p.checksum = 0;
+        p.data     = in + offset;
+        p.queued   = true;
+        p.result   = hw.pDriver->submit(job);
+
+        pending.push_back(std::move(p));
+
+        slot = (slot + 1) % NUM_SLOTS;
+    }
+
+    while (!pending.empty())
+    {
+        if (retireCompress(ofp, hw, pending))
+        {
+            return USER_ERROR;
+        }
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Retire the oldest pending decompression job (or raw
+// frame), writing its data and checking its length
+// and checksum
+// --------------------------------------------------
+
+static int retireDecompress(FILE* ofp, const codecHw_t &hw, std::deque<pending_t> &pending, const uint32_t frameNum)
+{
+    pending_t      p        = std::move(pending.front());
+    const uint8_t* txBuf    = p.data;
+    uint32_t       checksum = 0;
+    bool           haveCsum = false;
+
+    pending.pop_front();
+
+    if (p.queued)
+    {
+        slzwJobResult_t result = p.result.get();
+
+        txBuf = hw.sdramVaddr + p.slot * hw.slotBytes + hw.txOffset;
+
+        if (result.status != SLZW_DRV_OK || result.outLen != p.rawLen)
+        {
+            fprintf(stderr, "*** retireDecompress(): frame %d failed, status %d, %d of %d bytes\n",
+                    frameNum, result.status, result.outLen, p.rawLen);
+            return USER_ERROR;
+        }
+
+        checksum = result.checksum;
+        haveCsum = hw.pDriver->hasChecksum();
+    }
+
+    if (!haveCsum)
+    {
+        checksum = slzwModel::crc32(txBuf, p.rawLen);
+    }
+
+    if (checksum != p.checksum)
+    {
+        fprintf(stderr, "*** retireDecompress(): frame %d checksum mismatch\n", frameNum);
+        return USER_ERROR;
+    }
+
+    rawBytes += p.rawLen;
+
+    return writeOut(ofp, txBuf, p.rawLen);
+}
+
+// --------------------------------------------------
+// Decompress framed input
+// --------------------------------------------------
+
+static int decompressFile(const uint8_t* in, const uint64_t inLen, FILE* ofp, const codecHw_t &hw,
+                          slzwModel &model, const uint32_t chunkBytes)
+{
+    std::deque<pending_t> pending;
+    std::vector<uint8_t>  buf(hw.pDriver ? 0 : chunkBytes);
+    uint64_t              offset   = sizeof(slzwFrmHdr_t);
+    uint32_t              slot     = 0;
+    uint32_t              frameNum = 0;
+
+    for (;; frameNum++)
+    {
+        slzwFrm_t frm;
+
+        if ((inLen - offset) < sizeof(frm))
+        {
+            fprintf(stderr, "*** decompressFile(): unexpected end of input at frame %d\n", frameNum);
+            return USER_ERROR;
+        }
+
+        memcpy(&frm, in + offset, sizeof(frm));
+        offset += sizeof(frm);
+
+        if (frm.rawLen == 0)
+        {
+            break;
+        }
+
+        const bool raw = (frm.flags & SLZW_FRM_RAW) != 0;
+
+        if (frm.rawLen > chunkBytes || frm.dataLen > (inLen - offset) || frm.dataLen > DATA_CAPACITY(chunkBytes) ||
+            (raw && frm.dataLen != frm.rawLen))
+        {
+            fprintf(stderr, "*** decompressFile(): frame %d invalid\n", frameNum);
+            return USER_ERROR;
+        }
+
+        const uint8_t* data = in + offset;
+
+        offset += frm.dataLen;
+
+        // Software model
+        if (hw.pDriver == NULL)
+        {
+            uint32_t olen = frm.rawLen;
+
+            if (!raw && (model.decompress(data, frm.dataLen, buf.data(), buf.size(), olen) != SLZW_OK || olen != frm.rawLen))
+            {
+                fprintf(stderr, "*** decompressFile(): frame %d failed\n", frameNum);
+                return USER_ERROR;
+            }
+
+            const uint8_t* out = raw ? data : buf.data();
+
+            if ((raw ? slzwModel::crc32(out, olen) : model.getChecksum()) != frm.checksum)
+            {
+                fprintf(stderr, "*** decompressFile(): frame %d checksum mismatch\n", frameNum);
+                return USER_ERROR;
+            }
+
+            rawBytes += olen;
+
+            if (writeOut(ofp, out, olen))
+            {
+                return USER_ERROR;
+            }
+
+            continue;
+        }
+
+        if (pending.size() == NUM_SLOTS && retireDecompress(ofp, hw, pending, frameNum - NUM_SLOTS))
+        {
+            return USER_ERROR;
+        }
+
+        pending_t p;
+
+        p.slot     = slot;
+        p.rawLen   = frm.rawLen;
+        p.checksum = frm.checksum;
+        p.data     = data;
+        p.queued   = !raw;
+
+        if (!raw)
+        {
+            const uint32_t slotOffset = slot * hw.slotBytes;
+
+            memcpy(hw.sdramVaddr + slotOffset, data, frm.dataLen);
+
+            slzwJob_t job = {};
+
+            job.mode        = SLZW_DRV_DECOMPRESS;
+            job.resetPolicy = model.getConfig().policy;
+            job.csumType    = SLZW_DRV_CRC32;
+            job.clrDict     = 1;
+            job.rxAddr      = hw.sdramPaddr + slotOffset;
+            job.rxLen       = frm.dataLen;
+            job.txAddr      = hw.sdramPaddr + slotOffset + hw.txOffset;
+            job.txLen       = frm.rawLen;
+
+            p.result = hw.pDriver->submit(job);
+        }
+
+        pending.push_back(std::move(p));
+
+        slot = (slot + 1) % NUM_SLOTS;
+    }
+
+    for (uint32_t idx = frameNum - pending.size(); !pending.empty(); idx++)
+    {
+        if (retireDecompress(ofp, hw, pending, idx))
+        {
+            return USER_ERROR;
+        }
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Extract a range of uncompressed data from an
+// indexed file, decoding only the blocks covering it
+// --------------------------------------------------
+
+static int extractRange(const char* ifname, const uint64_t offset, const uint32_t len, FILE* ofp, const codecHw_t &hw,
+                        slzwModel &model)
+{
+    slzwArchive arc;
+    uint32_t    numSw = std::max(std::thread::hardware_concurrency(), 1U);
+
+    if (arc.open(ifname) != SLZW_ARC_OK)
+    {
+        fprintf(stderr, "*** extractRange(): %s has no valid block index\n", ifname);
+        return USER_ERROR;
+    }
+
+    // The codec decodes blocks through the first staging slot, alongside
+    // software engines on the remaining CPUs
+    if (hw.pDriver != NULL)
+    {
+        arc.addEngine([&hw, &model](const uint8_t* data, const uint32_t dataLen, uint8_t* raw, const uint32_t rawLen)
+        {
+            memcpy(hw.sdramVaddr, data, dataLen);
+
+            slzwJob_t job = {};
+
+            job.mode        = SLZW_DRV_DECOMPRESS;
+            job.resetPolicy = model.getConfig().policy;
+            job.csumType    = SLZW_DRV_CRC32;
+            job.clrDict     = 1;
+            job.rxAddr      = hw.sdramPaddr;
+            job.rxLen       = dataLen;
+            job.txAddr      = hw.sdramPaddr + hw.txOffset;
+            job.txLen       = rawLen;
+
+            slzwJobResult_t result = hw.pDriver->submit(job).get();
+
+            if (result.status != SLZW_DRV_OK || result.outLen != rawLen)
+            {
+                return SLZW_ARC_ERR_DECODE;
+            }
+
+            memcpy(raw, hw.sdramVaddr + hw.txOffset, rawLen);
+
+            return SLZW_ARC_OK;
+        });
+
+        numSw--;
+    }
+
+    if (numSw)
+    {
+        arc.addSoftwareEngines(numSw);
+    }
+
+    // Only allocate for the data in range
+    const uint32_t readLen = offset < arc.size() ? (uint32_t)std::min((uint64_t)len, arc.size() - offset) : 0;
+
+    std::vector<uint8_t> buf(readLen);
+    uint32_t             olen;
+    int                  status;
+
+    if ((status = arc.read(offset, readLen, buf.data(), olen)) != SLZW_ARC_OK)
+    {
+        fprintf(stderr, "*** extractRange(): read of %u bytes at offset %llu failed with status %d\n",
+                len, (unsigned long long)offset, status);
+        return USER_ERROR;
+    }
+
+    rawBytes = olen;
+
+    return writeOut(ofp, buf.data(), olen);
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    const uint32_t sdrCtrlFpgaPortRstWordOffset = 0x20;
+    int            c;
+    bool           decompress                   = false;
+    bool           swOnly                       = false;
+    bool           adaptive                     = false;
+    bool           extract                      = false;
+    uint64_t       rangeOffset                  = 0;
+    uint32_t       rangeLen                     = 0;
+    char*          rangeEnd;
+    uint32_t       chunkBytes                   = DEFAULT_CHUNK_BYTES;
+    fpgaSupport*   pFpga                        = NULL;
+    CCoreAuto*     pCore                        = NULL;
+    codecHw_t      hw                           = {};
+    int            status;
+
+    while ((c = getopt(argc, argv, "hdsac:r:")) != -1)
+    {
+        switch (c)
+        {
+        case 'd':
+            decompress = true;
+            break;
+        case 's':
+            swOnly     = true;
+            break;
+        case 'a':
+            adaptive   = true;
+            break;
+        case 'c':
+            chunkBytes = strtol(optarg, NULL, 0);
+            break;
+        case 'r':
+            rangeOffset = strtoull(optarg, &rangeEnd, 0);
+            rangeLen    = (*rangeEnd == ':') ? strtoul(rangeEnd + 1, NULL, 0) : 0;
+            extract     = true;
+            decompress  = true;
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-d] [-s] [-a] [-c <bytes>] [-r <offset>:<length>] <input file> <output file>\n", argv[0]);
+            printf("         -d Decompress (default compress)\n");
+            printf("         -s Use the software model, even if an FPGA is present\n");
+            printf("         -a Adaptive dictionary reset policy when compressing (default reset when full)\n");
+            printf("         -c Chunk size when compressing (default %d)\n", DEFAULT_CHUNK_BYTES);
+            printf("         -r Extract a range of the uncompressed data from a compressed file\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    if ((argc - optind) != 2 || chunkBytes == 0 || chunkBytes > MAX_CHUNK_BYTES)
+    {
+        fprintf(stderr, "*** main(): expected input and output files, and a chunk size of 1 to %d bytes\n", MAX_CHUNK_BYTES);
+        return USER_ERROR;
+    }
+
+    if (extract && rangeLen == 0)
+    {
+        fprintf(stderr, "*** main(): expected a range of <offset>:<length>, with a non-zero length\n");
+        return USER_ERROR;
+    }
+
+    const char* ifname = argv[optind];
+    const char* ofname = argv[optind + 1];
+
+    // Map the input file
+    int         fd;
+    struct stat st;
+
+    if ((fd = open(ifname, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+    {
+        fprintf(stderr, "*** main(): Unable to open file %s for reading\n", ifname);
+        return USER_ERROR;
+    }
+
+    const uint64_t inLen = st.st_size;
+    const uint8_t* in    = NULL;
+
+    if (inLen != 0 && (in = (const uint8_t*)mmap(NULL, inLen, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+    {
+        fprintf(stderr, "*** main(): Unable to map file %s\n", ifname);
+        close(fd);
+        return USER_ERROR;
+    }
+
+    close(fd);
+
+    madvise((void*)in, inLen, MADV_SEQUENTIAL);
+
+    // Codec parameters, from the input file when decompressing
+    slzwFrmHdr_t hdr = {SLZW_FRM_MAGIC, SLZW_FRM_VERSION, SLZW_DEFAULT_MAXCWLEN, adaptive ? 1U : 0U, chunkBytes};
+
+    if (decompress)
+    {
+        if (inLen < sizeof(hdr))
+        {
+            fprintf(stderr, "*** main(): %s is not an slzw file\n", ifname);
+            return USER_ERROR;
+        }
+
+        memcpy(&hdr, in, sizeof(hdr));
+
+        if (hdr.magic != SLZW_FRM_MAGIC || hdr.version == 0 || hdr.version > SLZW_FRM_VERSION || hdr.chunkSize == 0 || hdr.chunkSize > MAX_CHUNK_BYTES)
+        {
+            fprintf(stderr, "*** main(): %s is not an slzw file\n", ifname);
+            return USER_ERROR;
+        }
+    }
+
+    // Use the codec if there is an FPGA (or its model) and it resets
+    if (!swOnly && (fpgaSupport::getDefaultBackend() == FPGA_BACKEND_MODEL || access(FPGA_MANAGER_DEV, F_OK) == 0))
+    {
+        pFpga = new fpgaSupport();
+
+        if (pFpga->fullResetFpga(CORE_0_BASE))
+        {
+            uint32_t* coreBaseAddr = (uint32_t*)((uintptr_t)pFpga->getFpgaVirtualBaseAddress() + CORE_0_BASE);
+
+            // Bring out of reset SDRAM controller ports 0 and 1 for read write and control
+            volatile uint32_t* sdramCtrlRegBase = (uint32_t*)pFpga->getSdrCtrlVirtualBaseAddress();
+            sdramCtrlRegBase[sdrCtrlFpgaPortRstWordOffset] = 0x3fff;
+
+            pCore = new CCoreAuto(coreBaseAddr);
+
+            const uint32_t maxCw = pCore->pSlzwCodec->pConfig->GetMaxCw();
+
+            if (decompress && hdr.maxCodeWidth != maxCw)
+            {
+                fprintf(stderr, "slzw: file compressed with CWMAX %d, codec is %d, using software\n", hdr.maxCodeWidth, maxCw);
+            }
+            else
+            {
+                hdr.maxCodeWidth = maxCw;
+                hw.pDriver       = new slzwDriver(pCore, NUM_SLOTS);
+                hw.sdramVaddr    = (uint8_t*)pFpga->getSdramVirtualBaseAddress();
+                hw.sdramPaddr    = START_FPGA_PHY_MEM;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "slzw: FPGA not available, using software\n");
+        }
+    }
+
+    // Divide the SDRAM window's start into slots
+    const uint32_t chunkAligned = (hdr.chunkSize + SLOT_ALIGN - 1) & ~(SLOT_ALIGN - 1);
+
+    hw.txOffset  = decompress ? ((DATA_CAPACITY(hdr.chunkSize) + SLOT_ALIGN - 1) & ~(SLOT_ALIGN - 1)) : chunkAligned;
+    hw.slotBytes = (chunkAligned + DATA_CAPACITY(hdr.chunkSize) + SLOT_ALIGN - 1) & ~(SLOT_ALIGN - 1);
+
+    slzwConfig_t cfg;
+    cfg.policy       = hdr.resetPolicy ? SLZW_RESET_ADAPTIVE : SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth = hdr.maxCodeWidth;
+    cfg.memSize      = 0;
+    cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+    slzwModel model(&cfg);
+
+    model.setChecksum(SLZW_CSUM_CRC32);
+
+    FILE* ofp;
+
+    if ((ofp = fopen(ofname, "wb")) == NULL)
+    {
+        fprintf(stderr, "*** main(): Unable to open file %s for writing\n", ofname);
+        return USER_ERROR;
+    }
+
+    uint64_t start = timeUs();
+
+    if (extract)
+    {
+        status = extractRange(ifname, rangeOffset, rangeLen, ofp, hw, model);
+    }
+    else if (decompress)
+    {
+        status = decompressFile(in, inLen, ofp, hw, model, hdr.chunkSize);
+    }
+    else
+    {
+        status = writeOut(ofp, &hdr, sizeof(hdr)) ||
+                 compressFile(in, inLen, ofp, hw, model, chunkBytes) ||
+                 writeEnd(ofp);
+    }
+
+    const bool useCodec = hw.pDriver != NULL;
+
+    // Retire any outstanding jobs before the buffers go
+    delete hw.pDriver;
+
+    if (fclose(ofp) != 0)
+    {
+        status = USER_ERROR;
+    }
+
+    uint64_t us = timeUs() - start;
+
+    if (status == 0 && extract)
+    {
+        printf("slzw: extracted %llu bytes at offset %llu in %.3f s (%s)\n", (unsigned long long)rawBytes,
+               (unsigned long long)rangeOffset, us / 1e6, useCodec ? "codec and software" : "software");
+    }
+    else if (status == 0)
+    {
+        const uint64_t packed = decompress ? inLen : fileBytes;
+
+        printf("slzw: %s %llu bytes to %llu bytes (%.1f%%) in %.3f s, %.1f MB/s (%s)\n",
+               decompress ? "decompressed" : "compressed",
+               (unsigned long long)(decompress ? inLen : rawBytes), (unsigned long long)(decompress ? rawBytes : fileBytes),
+               rawBytes ? 100.0 * packed / rawBytes : 0.0, us / 1e6, us ? (double)rawBytes / us : 0.0,
+               useCodec ? "codec" : "software");
+    }
+    else
+    {
+        unlink(ofname);
+    }
+
+    if (in != NULL)
+    {
+        munmap((void*)in, inLen);
+    }
+
+    delete pCore;
+    delete pFpga;
+
+    return status;
+}
@@ -0,0 +1,394 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec daemon client
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_client.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-02-26
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods for a client of the slzwd codec daemon.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "slzw_client.h"
+
+// --------------------------------------------------
+// Return a monotonic time in microseconds
+// --------------------------------------------------
+
+static uint64_t timeUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+slzwClient::slzwClient()
+{
+    pShm           = NULL;
+    pSlot          = NULL;
+    pool           = NULL;
+    numOutstanding = 0;
+}
+
+// --------------------------------------------------
+// Destructor
+// --------------------------------------------------
+
+slzwClient::~slzwClient()
+{
+    detach();
+}
+
+// --------------------------------------------------
+// Attach to the daemon
+// --------------------------------------------------
+
+bool slzwClient::attach()
+{
+    int fd;
+
+    if (pSlot != NULL)
+    {
+        return true;
+    }
+
+    if ((fd = shm_open(SLZW_SHM_NAME, O_RDWR, 0)) < 0)
+    {
+        fprintf(stderr, "slzwClient::attach() : daemon not running\n");
+        return false;
+    }
+
+    void* vaddr = mmap(NULL, sizeof(slzwShm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (vaddr == MAP_FAILED)
+    {
+        fprintf(stderr, "slzwClient::attach() : could not map daemon shared memory\n");
+        return false;
+    }
+
+    pShm = (slzwShm_t*)vaddr;
+
+    if (pShm->magic != SLZW_SHM_MAGIC || pShm->version != SLZW_SHM_VERSION || !pShm->running.load())
+    {
+        fprintf(stderr, "slzwClient::attach() : daemon shared memory not valid\n");
+        detach();
+        return false;
+    }
+
+    // Claim a free slot. The daemon initialises the slot's rings on seeing it
+    // claimed, and then marks it attached.
+    for (int idx = 0; idx < SLZW_SHM_MAX_CLIENTS && pSlot == NULL; idx++)
+    {
+        uint32_t expected = SLZW_SHM_SLOT_FREE;
+
+        if (pShm->client[idx].state.compare_exchange_strong(expected, SLZW_SHM_SLOT_CLAIMED))
+        {
+            pSlot      = &pShm->client[idx];
+            pSlot->pid = getpid();
+        }
+    }
+
+    if (pSlot == NULL)
+    {
+        fprintf(stderr, "slzwClient::attach() : no free client slots\n");
+        detach();
+        return false;
+    }
+
+    // Wait for the daemon to accept the slot
+    uint64_t start = timeUs();
+    while (pSlot->state.load() != SLZW_SHM_SLOT_ATTACHED)
+    {
+        if ((timeUs() - start) > 1000000)
+        {
+            fprintf(stderr, "slzwClient::attach() : daemon did not respond\n");
+            detach();
+            return false;
+        }
+        usleep(100);
+    }
+
+    // Map this client's partition of the SDRAM window
+    if (pShm->backend == SLZW_SHM_BACKEND_SW)
+    {
+        fd = shm_open(SLZW_SHM_SDRAM_NAME, O_RDWR, 0);
+    }
+    else if (pShm->backend == SLZW_SHM_BACKEND_MODEL)
+    {
+        fd = shm_open(SLZW_SHM_MODEL_SDRAM_NAME, O_RDWR, 0);
+    }
+    else
+    {
+        fd = open("/dev/mem", O_RDWR | O_SYNC);
+    }
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "slzwClient::attach() : could not open SDRAM window\n");
+        detach();
+        return false;
+    }
+
+    off_t base = (pShm->backend == SLZW_SHM_BACKEND_HW) ? pShm->sdramPaddr : 0;
+
+    vaddr = mmap(NULL, pSlot->poolSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, base + pSlot->poolOffset);
+    close(fd);
+
+    if (vaddr == MAP_FAILED)
+    {
+        fprintf(stderr, "slzwClient::attach() : could not map SDRAM partition\n");
+        detach();
+        return false;
+    }
+
+    pool = (uint8_t*)vaddr;
+
+    freeList.clear();
+    allocated.clear();
+    freeList[0]    = pSlot->poolSize;
+    numOutstanding = 0;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Detach from the daemon, releasing the slot
+// --------------------------------------------------
+
+void slzwClient::detach()
+{
+    if (pool != NULL)
+    {
+        munmap(pool, pSlot->poolSize);
+        pool = NULL;
+    }
+
+    if (pSlot != NULL)
+    {
+        pSlot->state.store(SLZW_SHM_SLOT_FREE);
+        pSlot = NULL;
+    }
+
+    if (pShm != NULL)
+    {
+        munmap(pShm, sizeof(slzwShm_t));
+        pShm = NULL;
+    }
+}
+
+// --------------------------------------------------
+// Allocate a buffer (first fit)
+// --------------------------------------------------
+
+void* slzwClient::alloc(const uint32_t bytes)
+{
+    uint32_t size = (bytes + SLZW_CLIENT_ALLOC_ALIGN - 1) & ~(SLZW_CLIENT_ALLOC_ALIGN - 1);
+
+    if (pool == NULL || size == 0)
+    {
+        return NULL;
+    }
+
+    for (std::map<uint32_t, uint32_t>::iterator it = freeList.begin(); it != freeList.end(); it++)
+    {
+        if (it->second >= size)
+        {
+            uint32_t offset = it->first;
+            uint32_t remain = it->second - size;
+
+            freeList.erase(it);
+
+            if (remain)
+            {
+                freeList[offset + size] = remain;
+            }
+
+            allocated[offset] = size;
+
+            return pool + offset;
+        }
+    }
+
+    return NULL;
+}
+
+// --------------------------------------------------
+// Free a buffer, merging with adjacent free blocks
+// --------------------------------------------------
+
+void slzwClient::free(void* buf)
+{
+    if (pool == NULL || buf == NULL)
+    {
+        return;
+    }
+
+    uint32_t                               offset = (uint8_t*)buf - pool;
+    std::map<uint32_t, uint32_t>::iterator it     = allocated.find(offset);
+
+    if (it == allocated.end())
+    {
+        fprintf(stderr, "slzwClient::free() : buffer %p not allocated\n", buf);
+        return;
+    }
+
+    uint32_t size = it->second;
+    allocated.erase(it);
+
+    // Merge with the following free block
+    std::map<uint32_t, uint32_t>::iterator next = freeList.find(offset + size);
+    if (next != freeList.end())
+    {
+        size += next->second;
+        freeList.erase(next);
+    }
+
+    // Merge with the preceding free block
+    std::map<uint32_t, uint32_t>::iterator prev = freeList.lower_bound(offset);
+    if (prev != freeList.begin())
+    {
+        prev--;
+        if (prev->first + prev->second == offset)
+        {
+            prev->second += size;
+            return;
+        }
+    }
+
+    freeList[offset] = size;
+}
+
+// --------------------------------------------------
+// Convert a buffer to an SDRAM window offset
+// --------------------------------------------------
+
+bool slzwClient::toOffset(const void* buf, const uint32_t len, uint32_t &offset)
+{
+    const uint8_t* p = (const uint8_t*)buf;
+
+    if (p < pool || (p + len) > (pool + pSlot->poolSize) || ((uintptr_t)p & 3))
+    {
+        return false;
+    }
+
+    offset = pSlot->poolOffset + (p - pool);
+
+    return true;
+}
+
+// --------------------------------------------------
+// Submit a job
+// --------------------------------------------------
+
+bool slzwClient::submit(const uint32_t tag,
+                        const uint32_t mode,
+                        const uint32_t resetPolicy,
+                        const void*    ibuf,
+                        const uint32_t ilen,
+                        void*          obuf,
+                        const uint32_t obufLen)
+{
+    slzwShmReq_t req;
+
+    // Never have more outstanding than the completion ring can hold, so the
+    // daemon never has to wait to post a completion.
+    if (pSlot == NULL || numOutstanding >= SLZW_SHM_RING_SIZE)
+    {
+        return false;
+    }
+
+    if (!toOffset(ibuf, ilen, req.rxOffset) || !toOffset(obuf, obufLen, req.txOffset))
+    {
+        fprintf(stderr, "slzwClient::submit() : buffers not allocated from SDRAM partition\n");
+        return false;
+    }
+
+    req.tag         = tag;
+    req.mode        = mode;
+    req.resetPolicy = resetPolicy;
+    req.rxLen       = ilen;
+    req.txLen       = obufLen;
+
+    if (!pSlot->subRing.push(req))
+    {
+        return false;
+    }
+
+    numOutstanding++;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Retrieve a completion
+// --------------------------------------------------
+
+bool slzwClient::poll(slzwShmCmp_t &cmp)
+{
+    if (pSlot == NULL || !pSlot->cmpRing.pop(cmp))
+    {
+        return false;
+    }
+
+    numOutstanding--;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Wait for a completion
+// --------------------------------------------------
+
+bool slzwClient::wait(slzwShmCmp_t &cmp, const uint32_t timeoutUs)
+{
+    uint64_t start = timeUs();
+
+    while (!poll(cmp))
+    {
+        if (pSlot == NULL || (timeUs() - start) > timeoutUs)
+        {
+            return false;
+        }
+
+        sched_yield();
+    }
+
+    return true;
+}
@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec daemon client header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_client.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-26
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definition for a client of the slzwd codec
+//  daemon. A client attaches to a free slot in the daemon's shared memory,
+//  allocates buffers from its partition of the SDRAM window, and submits
+//  and retires jobs through its rings, with no copies or system calls on
+//  the data path.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <map>
+
+#include "slzw_shm.h"
+
+#ifndef _SLZW_CLIENT_H_
+#define _SLZW_CLIENT_H_
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+// Buffer allocation granularity. Codec buffers must be word aligned, and
+// cache line alignment avoids sharing lines between buffers.
+#define SLZW_CLIENT_ALLOC_ALIGN     SLZW_CACHE_LINE_BYTES
+
+// --------------------------------------------------
+// CLASS DEFINITION
+// --------------------------------------------------
+
+class slzwClient
+{
+public:
+    slzwClient();
+    ~slzwClient();
+
+    // Attach to the daemon, claiming a client slot. Returns false on failure.
+    bool     attach     ();
+    void     detach     ();
+
+    // Allocate and free buffers in this client's SDRAM partition
+    void*    alloc      (const uint32_t bytes);
+    void     free       (void* buf);
+
+    // Submit a job on buffers from alloc(). Returns false if the
+    // submission ring is full or the buffers are not in the partition.
+    bool     submit     (const uint32_t tag,
+                         const uint32_t mode,
+                         const uint32_t resetPolicy,
+                         const void*    ibuf,
+                         const uint32_t ilen,
+                         void*          obuf,
+                         const uint32_t obufLen);
+
+    // Retrieve a completion, if available. Returns false if none.
+    bool     poll       (slzwShmCmp_t &cmp);
+
+    // Wait for a completion, spinning for up to timeoutUs microseconds
+    bool     wait       (slzwShmCmp_t &cmp, const uint32_t timeoutUs);
+
+    // Number of submitted jobs not yet retired by poll()
+    uint32_t outstanding() { return numOutstanding; };
+
+    uint32_t backend    () { return pShm ? pShm->backend : SLZW_SHM_BACKEND_HW; };
+
+private:
+    // Convert a buffer pointer to a window offset, returning false if the
+    // buffer is not wholly within the partition.
+    bool     toOffset   (const void* buf, const uint32_t len, uint32_t &offset);
+
+    slzwShm_t*                   pShm;
+    slzwShmClient_t*             pSlot;
+    uint8_t*                     pool;
+    uint32_t                     numOutstanding;
+
+    // Free list, and allocated blocks, as pool offset to size
+    std::map<uint32_t, uint32_t> freeList;
+    std::map<uint32_t, uint32_t> allocated;
+};
+
+#endif
@@ -0,0 +1,250 @@
+// -----------------------------------------------------------------------------
+//  Title      : Compressed program image loader
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_loader.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-02-27
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the function to load a compressed program image.
+//
+//  Each segment's stored data is read from the file directly into the start
+//  of the reserved SDRAM window. Compressed segments are then expanded by the
+//  slzw_codec, in decompress mode, into a second staging area in the window,
+//  and the result copied to the target memory with burst_copy(), zero filling
+//  any .bss. Only the compressed bytes are read from the (slow) file storage.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <vector>
+
+#include "slzw_loader.h"
+#include "slzw_model.h"
+#include "elf.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+// Alignment of the decompression staging area in the SDRAM window
+#define STAGING_ALIGN             0x1000
+
+// --------------------------------------------------
+// Copy a staged segment to memory, zero padding a
+// final partial word and zero filling .bss
+// --------------------------------------------------
+
+static void copy_segment(uint32_t* dst, const uint8_t* src, const uint32_t rawSize, const uint32_t memSize)
+{
+    uint32_t words    = rawSize / 4;
+    uint32_t tail     = rawSize & 3;
+    uint32_t memWords = (memSize + 3) / 4;
+
+    burst_copy(dst, (const uint32_t*)src, words);
+
+    if (tail)
+    {
+        uint32_t word = 0;
+        memcpy(&word, src + words * 4, tail);
+        dst[words++] = word;
+    }
+
+    burst_copy(dst + words, NULL, memWords - words);
+}
+
+// --------------------------------------------------
+// Load a compressed program image to memory at mem
+// (of memBytes size), which corresponds to address 0
+// --------------------------------------------------
+
+int load_slzw_image (const char* const       filename,
+                     uint32_t*               mem,
+                     const uint32_t          memBytes,
+                     const slzwLoaderHw_t*   hw,
+                     slzwLoaderStats_t*      stats)
+{
+    struct timespec      start, end;
+    slzwLoaderStats_t    local;
+    slzwImgHdr_t         hdr;
+    slzwImgSeg_t         segs[SLZW_IMG_MAX_SEGS];
+    std::vector<uint8_t> rxLocal, txLocal;
+    int                  fd;
+    int                  status = 0;
+
+    slzwLoaderStats_t* s = stats ? stats : &local;
+    memset(s, 0, sizeof(slzwLoaderStats_t));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    const bool useCodec  = hw != NULL && hw->pDriver != NULL && hw->sdramVaddr != NULL;
+    const bool useWindow = hw != NULL && hw->sdramVaddr != NULL;
+
+    if ((fd = open(filename, O_RDONLY)) < 0)
+    {
+        fprintf(stderr, "*** load_slzw_image(): Unable to open file %s for reading\n", filename);
+        return USER_ERROR;
+    }
+
+    // Read and validate the header and segment table
+    if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+        hdr.magic != SLZW_IMG_MAGIC || hdr.version != SLZW_IMG_VERSION || hdr.numSegs > SLZW_IMG_MAX_SEGS)
+    {
+        fprintf(stderr, "*** load_slzw_image(): %s is not a valid image\n", filename);
+        close(fd);
+        return USER_ERROR;
+    }
+
+    if (pread(fd, segs, hdr.numSegs * sizeof(slzwImgSeg_t), sizeof(hdr)) != (ssize_t)(hdr.numSegs * sizeof(slzwImgSeg_t)))
+    {
+        fprintf(stderr, "*** load_slzw_image(): unexpected EOF\n");
+        close(fd);
+        return USER_ERROR;
+    }
+
+    s->bytesRead = sizeof(hdr) + hdr.numSegs * sizeof(slzwImgSeg_t);
+
+    if (useCodec && hdr.maxCodeWidth != hw->maxCodeWidth)
+    {
+        fprintf(stderr, "*** load_slzw_image(): image packed for CWMAX %d, codec is %d\n", hdr.maxCodeWidth, hw->maxCodeWidth);
+        close(fd);
+        return USER_ERROR;
+    }
+
+    // Software decompression uses the image's codec parameters
+    slzwConfig_t cfg;
+    cfg.policy       = hdr.resetPolicy ? SLZW_RESET_ADAPTIVE : SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth = hdr.maxCodeWidth;
+    cfg.memSize      = 0;
+    cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+    slzwModel model(&cfg);
+
+    for (uint32_t idx = 0; status == 0 && idx < hdr.numSegs; idx++)
+    {
+        const slzwImgSeg_t &seg = segs[idx];
+        const bool          raw = (seg.flags & SLZW_IMG_SEG_RAW) != 0;
+
+        if (seg.rawSize > seg.memSize || ((uint64_t)seg.vaddr + seg.memSize) > memBytes || (seg.vaddr & 3) ||
+            (raw && seg.dataSize != seg.rawSize))
+        {
+            fprintf(stderr, "*** load_slzw_image(): segment %d invalid, or outside of memory range\n", idx);
+            status = USER_ERROR;
+            break;
+        }
+
+        // Staging areas: stored data at the start of the window, and
+        // decompressed data at the next aligned offset
+        uint32_t txOffset = (seg.dataSize + STAGING_ALIGN - 1) & ~(STAGING_ALIGN - 1);
+        uint8_t* rxBuf;
+        uint8_t* txBuf;
+
+        if (useWindow)
+        {
+            if (((uint64_t)txOffset + ((seg.rawSize + 3) & ~3U)) > hw->sdramSize)
+            {
+                fprintf(stderr, "*** load_slzw_image(): segment %d too large for SDRAM window\n", idx);
+                status = USER_ERROR;
+                break;
+            }
+
+            rxBuf = hw->sdramVaddr;
+            txBuf = hw->sdramVaddr + txOffset;
+        }
+        else
+        {
+            rxLocal.resize(seg.dataSize + 4);
+            txLocal.resize(seg.rawSize + 4);
+            rxBuf = rxLocal.data();
+            txBuf = txLocal.data();
+        }
+
+        if (pread(fd, rxBuf, seg.dataSize, seg.offset) != (ssize_t)seg.dataSize)
+        {
+            fprintf(stderr, "*** load_slzw_image(): unexpected EOF\n");
+            status = USER_ERROR;
+            break;
+        }
+
+        s->bytesRead += seg.dataSize;
+
+        if (raw)
+        {
+            txBuf = rxBuf;
+        }
+        else if (useCodec)
+        {
+            slzwJob_t job = {};
+
+            job.mode        = SLZW_DRV_DECOMPRESS;
+            job.resetPolicy = hdr.resetPolicy;
+            job.rxAddr      = hw->sdramPaddr;
+            job.rxLen       = seg.dataSize;
+            job.txAddr      = hw->sdramPaddr + txOffset;
+            // The codec writes whole words, so round the output length up
+            job.txLen       = (seg.rawSize + 3) & ~3U;
+
+            slzwJobResult_t result = hw->pDriver->submit(job).get();
+
+            if (result.status != SLZW_DRV_OK || result.outLen != seg.rawSize)
+            {
+                fprintf(stderr, "*** load_slzw_image(): codec failed decompressing segment %d\n", idx);
+                status = USER_ERROR;
+                break;
+            }
+        }
+        else
+        {
+            uint32_t olen;
+
+            if (model.decompress(rxBuf, seg.dataSize, txBuf, seg.rawSize, olen) != SLZW_OK || olen != seg.rawSize)
+            {
+                fprintf(stderr, "*** load_slzw_image(): failed decompressing segment %d\n", idx);
+                status = USER_ERROR;
+                break;
+            }
+        }
+
+        copy_segment(mem + seg.vaddr/4, txBuf, seg.rawSize, seg.memSize);
+
+        s->segments++;
+        s->bytesLoaded += seg.rawSize;
+        s->bytesZeroed += seg.memSize - seg.rawSize;
+    }
+
+    close(fd);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    s->usecs = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+
+    return status;
+}
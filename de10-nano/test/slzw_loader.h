@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------
+//  Title      : Compressed program image loader header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_loader.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-27
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definitions for loading compressed program images
+//  (see slzw_image.h), decompressing them with the slzw_codec.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+
+#ifndef _SLZW_LOADER_H_
+#define _SLZW_LOADER_H_
+
+#include "slzw_image.h"
+#include "slzw_driver.h"
+
+// --------------------------------------------------
+// TYPEDEFS
+// --------------------------------------------------
+
+// Codec resources for loading. With a NULL driver, segments are
+// decompressed in software with the SLZW model, and staged in the
+// SDRAM window if mapped, else in local memory.
+typedef struct {
+    slzwDriver* pDriver;
+    uint32_t    maxCodeWidth;     // Codec build's CWMAX (config register max_cw)
+    uint8_t*    sdramVaddr;       // Mapped reserved SDRAM window, for staging
+    uint32_t    sdramPaddr;
+    uint32_t    sdramSize;
+} slzwLoaderHw_t;
+
+typedef struct {
+    uint32_t    segments;         // Segments loaded
+    uint32_t    bytesRead;        // Bytes read from the image file
+    uint32_t    bytesLoaded;      // Uncompressed bytes written to memory
+    uint32_t    bytesZeroed;      // Bytes zero filled (.bss)
+    uint32_t    usecs;            // Load time in microseconds
+} slzwLoaderStats_t;
+
+// --------------------------------------------------
+// PROTOTYPES
+// --------------------------------------------------
+
+extern int load_slzw_image (const char* const       filename,
+                            uint32_t*               mem,
+                            const uint32_t          memBytes,
+                            const slzwLoaderHw_t*   hw,
+                            slzwLoaderStats_t*      stats = NULL);
+
+#endif
@@ -0,0 +1,256 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec data path benchmark
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_pathbench.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-08
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file has the top level code for a platform program to measure the
+//  slzw_codec job time on the coherent (ACP) and non-coherent data paths,
+//  over a range of buffer sizes, and find the crossover size above which
+//  the non-coherent path is faster. This is the size to give slzwd (-x) for
+//  the driver's automatic path selection.
+//
+//  Each job's input is written by the CPU just before submission, as in
+//  use, and job times are measured from submission to result, so include
+//  the driver's cache maintenance for the non-coherent path. The reserved
+//  SDRAM window is mapped uncached by fpgaSupport, so no maintenance
+//  operations are installed here. Cache operations for a cached mapping
+//  would be set with slzwDriver::setCacheOps().
+//
+//  The program refuses to run on a build that routes no ACP window (the
+//  core's acp_win_base register reads 0, as in the default build, where the
+//  codec's AXI master connects only to F2SDRAM), or on the software FPGA
+//  model, as both paths are then the same and any crossover is just noise.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <vector>
+#include <algorithm>
+
+#include "../build/hps_0.h"
+#include "fpga_support.h"
+#include "slzw_driver.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+// Reserved SDRAM window mapped by fpgaSupport
+#define SDRAM_WINDOW_BYTES        0x10000000
+
+#define DEFAULT_MIN_BYTES         1024
+#define DEFAULT_MAX_BYTES         (16*1024*1024)
+#define DEFAULT_REPS              8
+
+// Output buffer capacity over input size, allowing for expansion
+#define TX_CAPACITY(_len)         ((_len) + ((_len) >> 1) + 1024)
+
+// --------------------------------------------------
+// Monotonic time in microseconds
+// --------------------------------------------------
+
+static uint64_t timeUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// --------------------------------------------------
+// Median job time, in us, of reps compression jobs
+// of len bytes on the given path. Returns 0 if any
+// job fails.
+// --------------------------------------------------
+
+static uint64_t timeJobs(slzwDriver &driver, uint8_t* rxVaddr, const uint32_t rxPaddr, const uint32_t txPaddr,
+                         const uint32_t len, const uint32_t path, const uint32_t reps)
+{
+    std::vector<uint64_t> times;
+
+    for (uint32_t rep = 0; rep < reps; rep++)
+    {
+        slzwJob_t job = {};
+
+        job.mode   = SLZW_DRV_COMPRESS;
+        job.path   = path;
+        job.rxAddr = rxPaddr;
+        job.rxLen  = len;
+        job.txAddr = txPaddr;
+        job.txLen  = TX_CAPACITY(len);
+
+        // Write the input, with some repetition to compress, as a producer would
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            rxVaddr[idx] = (uint8_t)((idx >> 3) ^ (idx % 251) ^ rep);
+        }
+
+        uint64_t        start  = timeUs();
+        slzwJobResult_t result = driver.submit(job).get();
+
+        if (result.status != SLZW_DRV_OK)
+        {
+            fprintf(stderr, "*** timeJobs(): job of %d bytes failed with status %d\n", len, result.status);
+            return 0;
+        }
+
+        times.push_back(timeUs() - start);
+    }
+
+    std::sort(times.begin(), times.end());
+
+    return times[times.size() / 2];
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    const uint32_t sdrCtrlFpgaPortRstWordOffset = 0x20;
+    int            c;
+    uint32_t       minBytes                     = DEFAULT_MIN_BYTES;
+    uint32_t       maxBytes                     = DEFAULT_MAX_BYTES;
+    uint32_t       reps                         = DEFAULT_REPS;
+    fpgaSupport    fpga;
+
+    while ((c = getopt(argc, argv, "hs:S:n:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            minBytes = strtol(optarg, NULL, 0);
+            break;
+        case 'S':
+            maxBytes = strtol(optarg, NULL, 0);
+            break;
+        case 'n':
+            reps     = strtol(optarg, NULL, 0);
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-s <bytes>] [-S <bytes>] [-n <reps>]\n", argv[0]);
+            printf("         -s Smallest buffer size (default %d)\n", DEFAULT_MIN_BYTES);
+            printf("         -S Largest buffer size, sizes doubling from the smallest (default %d)\n", DEFAULT_MAX_BYTES);
+            printf("         -n Jobs per size and path, taking the median time (default %d)\n", DEFAULT_REPS);
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    if (minBytes == 0 || reps == 0 || minBytes > maxBytes || (maxBytes + TX_CAPACITY(maxBytes)) > SDRAM_WINDOW_BYTES)
+    {
+        fprintf(stderr, "*** main(): invalid sizes or repetitions\n");
+        return USER_ERROR;
+    }
+
+    // Round buffer sizes to whole words, for the output buffer alignment
+    minBytes = (minBytes + 3) & ~3U;
+
+    if (!fpga.fullResetFpga(CORE_0_BASE))
+    {
+        return USER_ERROR;
+    }
+
+    uint32_t* coreBaseAddr = (uint32_t*)((uintptr_t)fpga.getFpgaVirtualBaseAddress() + CORE_0_BASE);
+
+    // Bring out of reset SDRAM controller ports 0 and 1 for read write and control
+    volatile uint32_t* sdramCtrlRegBase = (uint32_t*)fpga.getSdrCtrlVirtualBaseAddress();
+    sdramCtrlRegBase[sdrCtrlFpgaPortRstWordOffset] = 0x3fff;
+
+    CCoreAuto* pCore  = new CCoreAuto(coreBaseAddr);
+    uint8_t*   sdram  = (uint8_t*)fpga.getSdramVirtualBaseAddress();
+    uint32_t   txOffs = (maxBytes + 3) & ~3U;
+
+    slzwDriver driver(pCore, 1);
+
+    // Without an ACP window both paths are the same, so any crossover measured is noise
+    if (!driver.acpWindow())
+    {
+        fprintf(stderr, "*** main(): this build routes no ACP window (acp_win_base is 0), so the coherent and\n"
+                        "    non-coherent paths are the same, and there is no crossover to measure\n");
+        delete pCore;
+        return USER_ERROR;
+    }
+
+    printf("%10s %12s %12s %10s %10s\n", "bytes", "ACP us", "non-coh us", "ACP MB/s", "non-coh MB/s");
+
+    uint32_t crossover = 0;
+    uint32_t lastLen   = 0;
+
+    for (uint64_t len = minBytes; len <= maxBytes; len <<= 1)
+    {
+        uint64_t acpUs = timeJobs(driver, sdram, START_FPGA_PHY_MEM, START_FPGA_PHY_MEM + txOffs, len, SLZW_DRV_PATH_ACP,         reps);
+        uint64_t ncUs  = timeJobs(driver, sdram, START_FPGA_PHY_MEM, START_FPGA_PHY_MEM + txOffs, len, SLZW_DRV_PATH_NONCOHERENT, reps);
+
+        if (acpUs == 0 || ncUs == 0)
+        {
+            delete pCore;
+            return USER_ERROR;
+        }
+
+        printf("%10d %12d %12d %10.1f %10.1f\n", (uint32_t)len, (uint32_t)acpUs, (uint32_t)ncUs,
+               (double)len / acpUs, (double)len / ncUs);
+
+        lastLen = len;
+
+        // The crossover is the size below which the ACP was last faster or as fast
+        if (acpUs <= ncUs)
+        {
+            crossover = len;
+        }
+    }
+
+    if (crossover == 0)
+    {
+        printf("\nNon-coherent path faster at all sizes: slzwd -x 0\n");
+    }
+    else if (crossover == lastLen)
+    {
+        printf("\nNo crossover up to %d bytes: ACP for all sizes tested (slzwd default)\n", maxBytes);
+    }
+    else
+    {
+        // Auto path jobs are sized by input plus output buffer bytes
+        printf("\nCrossover at %d input bytes: slzwd -x %d\n", crossover, crossover + TX_CAPACITY(crossover));
+    }
+
+    delete pCore;
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+// -----------------------------------------------------------------------------
+//  Title      : Lock-free single producer/single consumer ring
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_ring.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-26
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains a class template for a fixed size, lock-free, single
+//  producer/single consumer ring of POD entries. The ring holds no pointers,
+//  so it may be placed in shared memory and used between processes. The
+//  head and tail indexes are free running, and are on separate cache lines
+//  to avoid false sharing between the producer and consumer.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <atomic>
+
+#ifndef _SLZW_RING_H_
+#define _SLZW_RING_H_
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+// Cortex-A9 L1/L2 cache line size
+#define SLZW_CACHE_LINE_BYTES 32
+
+// Rings shared between processes must not fall back to a lock
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "slzw_ring.h: atomic integers not lock free");
+
+// --------------------------------------------------
+// CLASS DEFINITION
+// --------------------------------------------------
+
+template <typename T, uint32_t SIZE>
+class slzwRing
+{
+    static_assert((SIZE & (SIZE - 1)) == 0, "slzwRing: SIZE must be a power of 2");
+
+public:
+    // --------------------------------------------------
+    // Reset the ring to empty. Must only be called when
+    // neither side is active.
+    void init()
+    {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_release);
+    };
+
+    // --------------------------------------------------
+    // Producer: add an entry, returning false if full
+    bool push(const T &entry)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+
+        if ((t - head.load(std::memory_order_acquire)) == SIZE)
+        {
+            return false;
+        }
+
+        buf[t & (SIZE - 1)] = entry;
+
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    };
+
+    // --------------------------------------------------
+    // Consumer: remove an entry, returning false if empty
+    bool pop(T &entry)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+
+        if (h == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        entry = buf[h & (SIZE - 1)];
+
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    };
+
+    // --------------------------------------------------
+    // Number of entries in the ring (a snapshot only
+    // when called from neither side)
+    uint32_t count()
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    };
+
+    static uint32_t size() { return SIZE; };
+
+private:
+    alignas(SLZW_CACHE_LINE_BYTES) std::atomic<uint32_t> head;
+    alignas(SLZW_CACHE_LINE_BYTES) std::atomic<uint32_t> tail;
+    alignas(SLZW_CACHE_LINE_BYTES) T                     buf[SIZE];
+};
+
+#endif
@@ -0,0 +1,296 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW hybrid scheduler benchmark
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_schedbench.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-11
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file has the top level code for a platform program to compare the
+//  throughput and job latency of a mixed workload run on the slzw_codec
+//  only, on software workers only, and with slzwScheduler choosing the
+//  engine for each job.
+//
+//  Job sizes are spread evenly on a log scale between the smallest and
+//  largest, in the same pseudo random order for each run, and jobs are kept
+//  outstanding up to the queue depth. The runs share a scheduler, so the
+//  codec and software only runs calibrate its estimates for the last. Job
+//  inputs are slices of slzwCorpus data, of a selectable family.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <math.h>
+#include <sys/mman.h>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include "../build/hps_0.h"
+#include "fpga_support.h"
+#include "slzw_driver.h"
+#include "slzw_scheduler.h"
+#include "slzw_corpus.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+// Reserved SDRAM window mapped by fpgaSupport
+#define SDRAM_WINDOW_BYTES        0x10000000
+
+#define DEFAULT_MIN_BYTES         64
+#define DEFAULT_MAX_BYTES         (1024*1024)
+#define DEFAULT_JOBS              1000
+#define DEFAULT_QUEUE_DEPTH       8
+#define DEFAULT_WORKERS           1
+#define DEFAULT_CORPUS            SLZW_CORPUS_TEXT
+
+// Output buffer capacity over input size, allowing for expansion
+#define TX_CAPACITY(_len)         ((_len) + ((_len) >> 1) + 1024)
+
+// --------------------------------------------------
+// Monotonic time in microseconds
+// --------------------------------------------------
+
+static uint64_t timeUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// --------------------------------------------------
+// Run the workload with the given engine selection,
+// printing its throughput and latency percentiles.
+// Returns non-zero if any job fails.
+// --------------------------------------------------
+
+static int runWorkload(slzwScheduler &sched, const uint32_t sel, const char* name, uint8_t* sdram,
+                       const std::vector<uint32_t> &sizes, const std::vector<uint8_t> &src,
+                       const uint32_t depth, const uint32_t slotBytes, const uint32_t txOffset)
+{
+    std::vector<uint64_t>                    latency(sizes.size());
+    std::deque<std::future<slzwJobResult_t>> pending;
+    uint64_t                                 bytes   = 0;
+    bool                                     failed  = false;
+
+    sched.setEngines(sel);
+
+    const uint64_t codecJobs = sched.engineJobs(SLZW_DRV_ENGINE_CODEC);
+    const uint64_t start     = timeUs();
+
+    for (uint32_t idx = 0; idx < sizes.size(); idx++)
+    {
+        // Free this job's slot by waiting for the job last using it
+        if (pending.size() == depth)
+        {
+            failed |= pending.front().get().status != SLZW_DRV_OK;
+            pending.pop_front();
+        }
+
+        const uint32_t len        = sizes[idx];
+        const uint32_t slotOffset = (idx % depth) * slotBytes;
+
+        // Write the input, as a producer would
+        memcpy(sdram + slotOffset, src.data() + (idx * 4099) % (src.size() - len + 1), len);
+
+        slzwJob_t job = {};
+
+        job.mode   = SLZW_DRV_COMPRESS;
+        job.rxAddr = START_FPGA_PHY_MEM + slotOffset;
+        job.rxLen  = len;
+        job.txAddr = START_FPGA_PHY_MEM + slotOffset + txOffset;
+        job.txLen  = TX_CAPACITY(len);
+
+        const uint64_t submitted = timeUs();
+        uint64_t*      pLatency  = &latency[idx];
+
+        pending.push_back(sched.submit(job, [pLatency, submitted](const slzwJobResult_t &)
+        {
+            *pLatency = timeUs() - submitted;
+        }));
+
+        bytes += len;
+    }
+
+    while (!pending.empty())
+    {
+        failed |= pending.front().get().status != SLZW_DRV_OK;
+        pending.pop_front();
+    }
+
+    const uint64_t us = timeUs() - start;
+
+    if (failed)
+    {
+        fprintf(stderr, "*** runWorkload(): %s run had failed jobs\n", name);
+        return USER_ERROR;
+    }
+
+    std::sort(latency.begin(), latency.end());
+
+    const uint64_t onCodec = sched.engineJobs(SLZW_DRV_ENGINE_CODEC) - codecJobs;
+
+    printf("%-10s %10.1f %10.1f %10d %10d %10d %9.1f%%\n", name, (double)bytes / us, sizes.size() * 1e6 / us,
+           (uint32_t)latency[latency.size() / 2], (uint32_t)latency[(latency.size() * 99) / 100],
+           (uint32_t)latency.back(), 100.0 * onCodec / sizes.size());
+
+    return 0;
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    const uint32_t sdrCtrlFpgaPortRstWordOffset = 0x20;
+    int            c;
+    uint32_t       minBytes                     = DEFAULT_MIN_BYTES;
+    uint32_t       maxBytes                     = DEFAULT_MAX_BYTES;
+    uint32_t       numJobs                      = DEFAULT_JOBS;
+    uint32_t       depth                        = DEFAULT_QUEUE_DEPTH;
+    uint32_t       workers                      = DEFAULT_WORKERS;
+    int            corpusType                   = DEFAULT_CORPUS;
+    fpgaSupport    fpga;
+
+    while ((c = getopt(argc, argv, "hs:S:n:q:w:c:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            minBytes = strtol(optarg, NULL, 0);
+            break;
+        case 'S':
+            maxBytes = strtol(optarg, NULL, 0);
+            break;
+        case 'n':
+            numJobs  = strtol(optarg, NULL, 0);
+            break;
+        case 'q':
+            depth    = strtol(optarg, NULL, 0);
+            break;
+        case 'w':
+            workers  = strtol(optarg, NULL, 0);
+            break;
+        case 'c':
+            if ((corpusType = slzwCorpus::lookup(optarg)) < 0)
+            {
+                fprintf(stderr, "*** main(): unknown data family %s\n", optarg);
+                return USER_ERROR;
+            }
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-s <bytes>] [-S <bytes>] [-n <jobs>] [-q <depth>] [-w <workers>] [-c <family>]\n", argv[0]);
+            printf("         -s Smallest job size (default %d)\n", DEFAULT_MIN_BYTES);
+            printf("         -S Largest job size (default %d)\n", DEFAULT_MAX_BYTES);
+            printf("         -n Jobs per run (default %d)\n", DEFAULT_JOBS);
+            printf("         -q Jobs kept outstanding (default %d)\n", DEFAULT_QUEUE_DEPTH);
+            printf("         -w Software workers (default %d)\n", DEFAULT_WORKERS);
+            printf("         -c Job data family (default %s):", slzwCorpus::name(DEFAULT_CORPUS));
+            for (int idx = 0; idx < SLZW_CORPUS_NUM_TYPES; idx++)
+            {
+                printf(" %s", slzwCorpus::name((slzwCorpusType_t)idx));
+            }
+            printf("\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    const uint32_t txOffset  = (maxBytes + 3) & ~3U;
+    const uint32_t slotBytes = (txOffset + TX_CAPACITY(maxBytes) + 3) & ~3U;
+
+    if (minBytes == 0 || numJobs == 0 || depth == 0 || workers == 0 || minBytes > maxBytes ||
+        (uint64_t)depth * slotBytes > SDRAM_WINDOW_BYTES)
+    {
+        fprintf(stderr, "*** main(): invalid sizes, job count, depth or workers\n");
+        return USER_ERROR;
+    }
+
+    if (!fpga.fullResetFpga(CORE_0_BASE))
+    {
+        return USER_ERROR;
+    }
+
+    uint32_t* coreBaseAddr = (uint32_t*)((uintptr_t)fpga.getFpgaVirtualBaseAddress() + CORE_0_BASE);
+
+    // Bring out of reset SDRAM controller ports 0 and 1 for read write and control
+    volatile uint32_t* sdramCtrlRegBase = (uint32_t*)fpga.getSdrCtrlVirtualBaseAddress();
+    sdramCtrlRegBase[sdrCtrlFpgaPortRstWordOffset] = 0x3fff;
+
+    CCoreAuto* pCore = new CCoreAuto(coreBaseAddr);
+    uint8_t*   sdram = (uint8_t*)fpga.getSdramVirtualBaseAddress();
+
+    // Job sizes, log uniform, and source data of the selected family, with
+    // any collision data for the codec's dictionary
+    std::vector<uint32_t> sizes(numJobs);
+    std::vector<uint8_t>  src;
+    slzwCorpus            corpus(SLZW_CORPUS_DEFAULT_SEED, pCore->pSlzwCodec->pConfig->GetMaxCw(),
+                                 pCore->pSlzwCodec->pConfig->GetMemSize());
+
+    srand(1);
+
+    for (uint32_t idx = 0; idx < numJobs; idx++)
+    {
+        const double frac = (double)rand() / RAND_MAX;
+        sizes[idx]        = (uint32_t)(minBytes * pow((double)maxBytes / minBytes, frac));
+    }
+
+    corpus.generate((slzwCorpusType_t)corpusType, src, maxBytes * 2);
+
+    {
+        slzwDriver    driver(pCore, depth);
+        slzwScheduler sched(&driver, sdram, START_FPGA_PHY_MEM, SDRAM_WINDOW_BYTES,
+                            pCore->pSlzwCodec->pConfig->GetMaxCw(), workers);
+
+        printf("%d jobs of %d to %d bytes of %s data, %d outstanding, %d software workers\n\n", numJobs, minBytes, maxBytes,
+               slzwCorpus::name((slzwCorpusType_t)corpusType), depth, workers);
+        printf("%-10s %10s %10s %10s %10s %10s %10s\n", "engines", "MB/s", "jobs/s", "p50 us", "p99 us", "max us", "on codec");
+
+        if (runWorkload(sched, SLZW_SCHED_CODEC_ONLY,    "codec",    sdram, sizes, src, depth, slotBytes, txOffset) ||
+            runWorkload(sched, SLZW_SCHED_SOFTWARE_ONLY, "software", sdram, sizes, src, depth, slotBytes, txOffset) ||
+            runWorkload(sched, SLZW_SCHED_AUTO,          "hybrid",   sdram, sizes, src, depth, slotBytes, txOffset))
+        {
+            delete pCore;
+            return USER_ERROR;
+        }
+    }
+
+    delete pCore;
+
+    return 0;
+}
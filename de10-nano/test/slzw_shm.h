@@ -0,0 +1,134 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec daemon shared memory definitions
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_shm.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-26
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definitions for the shared memory interface between
+//  the slzwd codec daemon and its clients.
+//
+//  The daemon creates a POSIX shared memory object (SLZW_SHM_NAME) holding a
+//  header and a slot per client. Each slot has a submission ring (client to
+//  daemon) and a completion ring (daemon to client), and a partition of the
+//  reserved SDRAM window for the client's buffers. Buffers are referenced in
+//  requests by byte offset from the start of the window.
+//
+//  With the hardware backend, clients map their SDRAM partition from
+//  /dev/mem. With the software backend, the daemon creates a second shared
+//  memory object (SLZW_SHM_SDRAM_NAME) standing in for the window. With the
+//  hardware backend on the FPGA software model (FPGA_BACKEND=model), clients
+//  map the model's SDRAM window object (SLZW_SHM_MODEL_SDRAM_NAME).
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <atomic>
+
+#include "slzw_ring.h"
+
+#ifndef _SLZW_SHM_H_
+#define _SLZW_SHM_H_
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define SLZW_SHM_NAME               "/slzw_daemon"
+#define SLZW_SHM_SDRAM_NAME         "/slzw_sdram"
+
+// SDRAM window shared memory of the FPGA software model (must match fpga_model.h)
+#define SLZW_SHM_MODEL_SDRAM_NAME   "/slzw_fpga_sdram"
+
+#define SLZW_SHM_MAGIC              0x575a4c53  // "SLZW"
+#define SLZW_SHM_VERSION            1
+
+#define SLZW_SHM_MAX_CLIENTS        8
+#define SLZW_SHM_RING_SIZE          64
+
+// Reserved SDRAM window (must match fpgaSupport)
+#define SLZW_SHM_SDRAM_PADDR        0x20000000
+#define SLZW_SHM_SDRAM_SIZE         0x10000000
+
+// Per-client partition of the SDRAM window
+#define SLZW_SHM_POOL_SIZE          (SLZW_SHM_SDRAM_SIZE / SLZW_SHM_MAX_CLIENTS)
+
+// Backends
+#define SLZW_SHM_BACKEND_HW         0
+#define SLZW_SHM_BACKEND_SW         1
+#define SLZW_SHM_BACKEND_MODEL      2   // Hardware path on the FPGA software model
+
+// Client slot states
+#define SLZW_SHM_SLOT_FREE          0
+#define SLZW_SHM_SLOT_CLAIMED       1
+#define SLZW_SHM_SLOT_ATTACHED      2
+
+// Completion status values
+#define SLZW_SHM_OK                 0
+#define SLZW_SHM_ERR_TIMEOUT        1
+#define SLZW_SHM_ERR_BUFFER         2
+#define SLZW_SHM_ERR_CODEC          3
+#define SLZW_SHM_ERR_OVERFLOW       4   // Output truncated at txLen, outLen bytes written
+
+// --------------------------------------------------
+// TYPEDEFS
+// --------------------------------------------------
+
+// Submission ring entry. Offsets are from the start of the SDRAM window.
+typedef struct {
+    uint32_t tag;                   // Client's tag, returned in the completion
+    uint32_t mode;                  // 1 => compress, 0 => decompress
+    uint32_t resetPolicy;           // Dictionary reset policy
+    uint32_t rxOffset;
+    uint32_t rxLen;
+    uint32_t txOffset;
+    uint32_t txLen;
+} slzwShmReq_t;
+
+// Completion ring entry
+typedef struct {
+    uint32_t tag;
+    int32_t  status;                // SLZW_SHM_OK or an SLZW_SHM_ERR_ value
+    uint32_t outLen;                // Output bytes
+} slzwShmCmp_t;
+
+typedef struct {
+    std::atomic<uint32_t>                               state;
+    int32_t                                             pid;
+    uint32_t                                            poolOffset;
+    uint32_t                                            poolSize;
+    slzwRing<slzwShmReq_t, SLZW_SHM_RING_SIZE>          subRing;
+    slzwRing<slzwShmCmp_t, SLZW_SHM_RING_SIZE>          cmpRing;
+} slzwShmClient_t;
+
+typedef struct {
+    uint32_t                                            magic;
+    uint32_t                                            version;
+    uint32_t                                            backend;
+    uint32_t                                            sdramPaddr;
+    uint32_t                                            sdramSize;
+    int32_t                                             daemonPid;
+    std::atomic<uint32_t>                               running;
+    slzwShmClient_t                                     client[SLZW_SHM_MAX_CLIENTS];
+} slzwShm_t;
+
+#endif
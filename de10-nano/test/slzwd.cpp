@@ -0,0 +1,478 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec daemon
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzwd.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-02-26
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file has the top level code for a user space daemon that owns the
+//  slzw_codec and serves compression jobs to multiple client processes.
+//
+//  The daemon is the only process to reset the FPGA and map the CSRs. It
+//  creates the shared memory described in slzw_shm.h and polls each
+//  attached client's submission ring. Jobs are passed to an slzwScheduler,
+//  which runs each on the codec, through an slzwDriver, or on a software
+//  worker, whichever is expected to finish it first. Results are posted to
+//  the client's completion ring from the scheduler's callbacks, and those
+//  of rejected requests from the polling loop. Posts to a ring are made
+//  under a lock for its client, so each ring has a single producer at a
+//  time and a single consumer.
+//
+//  With the software backend (-s), no hardware is accessed. Jobs are run
+//  on the SLZW C++ model, in shared memory standing in for the SDRAM window,
+//  for testing clients away from the board.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include <mutex>
+
+#include "../build/hps_0.h"
+#include "fpga_support.h"
+#include "slzw_shm.h"
+#include "slzw_driver.h"
+#include "slzw_scheduler.h"
+#include "slzw_model.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+// Idle poll sleep, and the number of idle polls between dead client checks
+#define IDLE_SLEEP_US             10
+#define CLIENT_CHECK_POLLS        10000
+
+// Software workers sharing jobs with the codec, leaving a CPU for the
+// daemon's polling and the driver's completion thread
+#define DEFAULT_SW_WORKERS        1
+
+// --------------------------------------------------
+// STATIC VARIABLES
+// --------------------------------------------------
+
+static volatile sig_atomic_t quit  = 0;
+static volatile sig_atomic_t dump  = 0;
+
+// Jobs passed to the driver but not yet posted, per client slot. A slot is
+// not reused until these have drained, as the completion thread may still
+// post to its ring.
+static std::atomic<uint32_t> pending[SLZW_SHM_MAX_CLIENTS];
+
+// Completion ring producer locks, per client slot. A client's completions
+// are posted by the polling loop, the driver's completion thread and the
+// scheduler's workers, and the rings take one producer at a time.
+static std::mutex            cmpLock[SLZW_SHM_MAX_CLIENTS];
+
+// --------------------------------------------------
+// Signal handler for orderly shutdown
+// --------------------------------------------------
+
+static void sigHandler(int)
+{
+    quit = 1;
+}
+
+// --------------------------------------------------
+// Signal handler requesting a metrics file write
+// --------------------------------------------------
+
+static void dumpHandler(int)
+{
+    dump = 1;
+}
+
+// --------------------------------------------------
+// Create and map a shared memory object
+// --------------------------------------------------
+
+static void* createShm(const char* name, const uint32_t size)
+{
+    int fd;
+
+    shm_unlink(name);
+
+    if ((fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666)) < 0)
+    {
+        fprintf(stderr, "*** createShm(): could not create %s\n", name);
+        return NULL;
+    }
+
+    if (ftruncate(fd, size) < 0)
+    {
+        fprintf(stderr, "*** createShm(): could not size %s\n", name);
+        close(fd);
+        return NULL;
+    }
+
+    void* vaddr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    return (vaddr == MAP_FAILED) ? NULL : vaddr;
+}
+
+// --------------------------------------------------
+// Check a request's buffers lie within the client's
+// partition of the SDRAM window
+// --------------------------------------------------
+
+static bool validReq(const slzwShmClient_t* pClient, const slzwShmReq_t &req)
+{
+    uint64_t start = pClient->poolOffset;
+    uint64_t end   = start + pClient->poolSize;
+
+    return req.rxOffset >= start && ((uint64_t)req.rxOffset + req.rxLen) <= end &&
+           req.txOffset >= start && ((uint64_t)req.txOffset + req.txLen) <= end &&
+           !(req.rxOffset & 3) && !(req.txOffset & 3);
+}
+
+// --------------------------------------------------
+// Post a completion to a client's ring
+// --------------------------------------------------
+
+static void postCmp(slzwShmClient_t* pClient, const int idx, const slzwShmCmp_t &cmp)
+{
+    std::lock_guard<std::mutex> lock(cmpLock[idx]);
+
+    pClient->cmpRing.push(cmp);
+}
+
+// --------------------------------------------------
+// Run a request on the software model
+// --------------------------------------------------
+
+static void runModel(slzwModel* models[2], uint8_t* sdram, const slzwShmReq_t &req, slzwShmCmp_t &cmp)
+{
+    slzwModel* model = models[req.resetPolicy ? 1 : 0];
+    int        status;
+
+    if (req.mode)
+    {
+        status = model->compress(sdram + req.rxOffset, req.rxLen, sdram + req.txOffset, req.txLen, cmp.outLen);
+    }
+    else
+    {
+        status = model->decompress(sdram + req.rxOffset, req.rxLen, sdram + req.txOffset, req.txLen, cmp.outLen);
+    }
+
+    cmp.status = (status == SLZW_OK)           ? SLZW_SHM_OK :
+                 (status == SLZW_ERR_OVERFLOW) ? SLZW_SHM_ERR_OVERFLOW : SLZW_SHM_ERR_CODEC;
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    const uint32_t sdrCtrlFpgaPortRstWordOffset = 0x20;
+    int            c;
+    bool           swBackend                    = false;
+    uint32_t       depth                        = SLZW_DRV_DEFAULT_DEPTH;
+    uint32_t       crossover                    = SLZW_DRV_DEFAULT_ACP_CROSSOVER;
+    uint32_t       swWorkers                    = DEFAULT_SW_WORKERS;
+    fpgaSupport    fpga;
+    CCoreAuto*     pCore                        = NULL;
+    slzwDriver*    pDriver                      = NULL;
+    slzwScheduler* pSched                       = NULL;
+    uint8_t*       sdram                        = NULL;
+    slzwModel*     models[2]                    = {NULL, NULL};
+    const char*    traceFile                    = NULL;
+    const char*    metricsFile                  = NULL;
+    bool           traceOverflow                = false;
+    std::vector<slzwTraceEntry_t> trace;
+
+    while ((c = getopt(argc, argv, "hsd:x:w:T:m:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            swBackend = true;
+            break;
+        case 'd':
+            depth     = strtol(optarg, NULL, 0);
+            break;
+        case 'x':
+            crossover = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            swWorkers = strtoul(optarg, NULL, 0);
+            break;
+        case 'T':
+            traceFile = optarg;
+            break;
+        case 'm':
+            metricsFile = optarg;
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-s] [-d <depth>] [-x <bytes>] [-w <workers>] [-T <trace file>] [-m <metrics file>]\n", argv[0]);
+            printf("         -s Use software model backend (no hardware access)\n");
+            printf("         -d Maximum jobs outstanding in the driver (default %d)\n", SLZW_DRV_DEFAULT_DEPTH);
+            printf("         -x Largest job buffer bytes (input plus output) using the ACP, as measured by pathbench.exe (default all)\n");
+            printf("         -w Software workers sharing jobs with the codec, 0 for codec only (default %d)\n", DEFAULT_SW_WORKERS);
+            printf("         -T Capture the codec event trace to file, written on exit (hardware backend)\n");
+            printf("         -m Write codec job telemetry to file in Prometheus text format, on SIGUSR1 and exit (hardware backend)\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    signal(SIGINT,  sigHandler);
+    signal(SIGTERM, sigHandler);
+    signal(SIGUSR1, dumpHandler);
+
+    // Create the client interface shared memory
+    slzwShm_t* pShm = (slzwShm_t*)createShm(SLZW_SHM_NAME, sizeof(slzwShm_t));
+
+    if (pShm == NULL)
+    {
+        return USER_ERROR;
+    }
+
+    if (swBackend)
+    {
+        // Shared memory stands in for the SDRAM window
+        if ((sdram = (uint8_t*)createShm(SLZW_SHM_SDRAM_NAME, SLZW_SHM_SDRAM_SIZE)) == NULL)
+        {
+            shm_unlink(SLZW_SHM_NAME);
+            return USER_ERROR;
+        }
+
+        models[0] = new slzwModel();
+
+        slzwConfig_t cfg = models[0]->getConfig();
+        cfg.policy       = SLZW_RESET_ADAPTIVE;
+        models[1]        = new slzwModel(&cfg);
+    }
+    else
+    {
+        // Reset the FPGA, once, for all clients, polling the core's
+        // local scratch register (offset 0) for readiness
+        if (!fpga.fullResetFpga(CORE_0_BASE))
+        {
+            shm_unlink(SLZW_SHM_NAME);
+            return USER_ERROR;
+        }
+
+        printf("slzwd: FPGA ready %d us after reset\n", fpga.getResetRecoveryUs());
+
+        uint32_t* coreBaseAddr = (uint32_t*)((uintptr_t)fpga.getFpgaVirtualBaseAddress() + CORE_0_BASE);
+
+        // Bring out of reset SDRAM controller ports 0 and 1 for read write and control
+        volatile uint32_t* sdramCtrlRegBase = (uint32_t*)fpga.getSdrCtrlVirtualBaseAddress();
+        sdramCtrlRegBase[sdrCtrlFpgaPortRstWordOffset] = 0x3fff;
+
+        pCore   = new CCoreAuto(coreBaseAddr);
+        pDriver = new slzwDriver(pCore, depth);
+
+        // A crossover only matters if the build has a separate coherent path
+        if (crossover != SLZW_DRV_DEFAULT_ACP_CROSSOVER && !pDriver->acpWindow())
+        {
+            fprintf(stderr, "*** main(): warning: -x ignored, as this build routes no ACP window\n");
+        }
+
+        pDriver->setAcpCrossover(crossover);
+
+        pSched  = new slzwScheduler(pDriver, (uint8_t*)fpga.getSdramVirtualBaseAddress(), SLZW_SHM_SDRAM_PADDR,
+                                    SLZW_SHM_SDRAM_SIZE, pCore->pSlzwCodec->pConfig->GetMaxCw(), swWorkers);
+
+        if (traceFile != NULL)
+        {
+            pDriver->enableTrace(true);
+        }
+    }
+
+    pShm->magic      = SLZW_SHM_MAGIC;
+    pShm->version    = SLZW_SHM_VERSION;
+    pShm->backend    = swBackend ? SLZW_SHM_BACKEND_SW : fpga.isModel() ? SLZW_SHM_BACKEND_MODEL : SLZW_SHM_BACKEND_HW;
+    pShm->sdramPaddr = SLZW_SHM_SDRAM_PADDR;
+    pShm->sdramSize  = SLZW_SHM_SDRAM_SIZE;
+    pShm->daemonPid  = getpid();
+
+    for (int idx = 0; idx < SLZW_SHM_MAX_CLIENTS; idx++)
+    {
+        pShm->client[idx].poolOffset = idx * SLZW_SHM_POOL_SIZE;
+        pShm->client[idx].poolSize   = SLZW_SHM_POOL_SIZE;
+        pShm->client[idx].state.store(SLZW_SHM_SLOT_FREE);
+        pending[idx].store(0);
+    }
+
+    pShm->running.store(1);
+
+    printf("slzwd: running with %s backend\n", swBackend ? "software" : fpga.isModel() ? "modelled hardware" : "hardware");
+
+    uint32_t idlePolls = 0;
+
+    while (!quit)
+    {
+        bool idle = true;
+
+        for (int idx = 0; idx < SLZW_SHM_MAX_CLIENTS; idx++)
+        {
+            slzwShmClient_t* pClient = &pShm->client[idx];
+            uint32_t         state   = pClient->state.load(std::memory_order_acquire);
+
+            // Accept a newly claimed slot once any jobs from its last owner are posted
+            if (state == SLZW_SHM_SLOT_CLAIMED && pending[idx].load() == 0)
+            {
+                pClient->subRing.init();
+                pClient->cmpRing.init();
+                pClient->state.store(SLZW_SHM_SLOT_ATTACHED, std::memory_order_release);
+                continue;
+            }
+
+            if (state != SLZW_SHM_SLOT_ATTACHED)
+            {
+                continue;
+            }
+
+            // Release the slots of clients that exited without detaching
+            if (idlePolls >= CLIENT_CHECK_POLLS && kill(pClient->pid, 0) < 0 && errno == ESRCH)
+            {
+                pClient->state.store(SLZW_SHM_SLOT_FREE);
+                continue;
+            }
+
+            slzwShmReq_t req;
+
+            while (pClient->subRing.pop(req))
+            {
+                slzwShmCmp_t cmp = {req.tag, SLZW_SHM_OK, 0};
+
+                idle = false;
+
+                if (!validReq(pClient, req))
+                {
+                    cmp.status = SLZW_SHM_ERR_BUFFER;
+                    postCmp(pClient, idx, cmp);
+                }
+                else if (swBackend)
+                {
+                    runModel(models, sdram, req, cmp);
+                    postCmp(pClient, idx, cmp);
+                }
+                else
+                {
+                    slzwJob_t job = {};
+
+                    job.mode        = req.mode;
+                    job.resetPolicy = req.resetPolicy;
+                    job.rxAddr      = SLZW_SHM_SDRAM_PADDR + req.rxOffset;
+                    job.rxLen       = req.rxLen;
+                    job.txAddr      = SLZW_SHM_SDRAM_PADDR + req.txOffset;
+                    job.txLen       = req.txLen;
+
+                    pending[idx]++;
+
+                    // Posted from the driver's or the scheduler's callbacks
+                    uint32_t tag = req.tag;
+                    pSched->submit(job, [pClient, idx, tag](const slzwJobResult_t &result)
+                    {
+                        slzwShmCmp_t done = {tag, (result.status == SLZW_DRV_OK)       ? SLZW_SHM_OK :
+                                                  (result.status == SLZW_DRV_OVERFLOW) ? SLZW_SHM_ERR_OVERFLOW :
+                                                  (result.status == SLZW_DRV_SWERR)    ? SLZW_SHM_ERR_CODEC : SLZW_SHM_ERR_TIMEOUT,
+                                             result.outLen};
+                        postCmp(pClient, idx, done);
+                        pending[idx]--;
+                    });
+                }
+            }
+        }
+
+        idlePolls = (idlePolls >= CLIENT_CHECK_POLLS) ? 0 : idlePolls + 1;
+
+        if (dump)
+        {
+            dump = 0;
+
+            if (metricsFile != NULL && pDriver != NULL)
+            {
+                pDriver->telemetry().writePrometheus(metricsFile);
+            }
+        }
+
+        if (idle)
+        {
+            // Drain the codec's trace FIFO whilst idle, to keep it from filling
+            if (traceFile != NULL && pDriver != NULL)
+            {
+                traceOverflow |= pDriver->readTrace(trace);
+            }
+
+            usleep(IDLE_SLEEP_US);
+        }
+    }
+
+    printf("slzwd: shutting down\n");
+
+    pShm->running.store(0);
+
+    // Retire outstanding jobs before removing the shared memory
+    if (pDriver != NULL)
+    {
+        pSched->drain();
+
+        if (traceFile != NULL)
+        {
+            traceOverflow |= pDriver->readTrace(trace);
+            pDriver->enableTrace(false);
+
+            slzwDriver::writeTrace(traceFile, trace);
+
+            printf("slzwd: %zu trace entries written to %s%s\n", trace.size(), traceFile,
+                   traceOverflow ? " (entries were dropped)" : "");
+        }
+
+        if (metricsFile != NULL && pDriver->telemetry().writePrometheus(metricsFile) == 0)
+        {
+            printf("slzwd: job telemetry written to %s\n", metricsFile);
+        }
+    }
+
+    delete pSched;
+    delete pDriver;
+    delete pCore;
+    delete models[0];
+    delete models[1];
+
+    shm_unlink(SLZW_SHM_NAME);
+
+    if (swBackend)
+    {
+        shm_unlink(SLZW_SHM_SDRAM_NAME);
+    }
+
+    return 0;
+}
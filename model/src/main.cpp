@@ -0,0 +1,320 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW C++ reference model command line program
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : main.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-02-21
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the top level code for a command line program to
+//  compress and decompress files with the SLZW reference model, for
+//  generating golden data and evaluating configurations.
+//
+//  A sweep option (-s) compresses the input for each maximum code width, and
+//  reports the compression ratio against an estimate of the Cyclone V M10K
+//  block RAM needed by slzw_dict for that width.
+//
+//  A hardware option (-H) uses the codec specialisation for the hardware
+//  build's CWMAX and MEMSIZE core parameters, ignoring -w and -m.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <unistd.h>
+
+#include "slzw_model.h"
+#include "slzw_file.h"
+#include "slzw_hw_codec.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+// Cyclone V M10K block RAM geometry
+#define M10K_NUM_CONFIGS          6
+
+// --------------------------------------------------
+// LOCAL STATICS
+// --------------------------------------------------
+
+// Supported M10K depth x width configurations
+static const uint32_t m10kCfg[M10K_NUM_CONFIGS][2] = {
+    {8192, 1}, {4096, 2}, {2048, 5}, {1024, 10}, {512, 20}, {256, 40}
+};
+
+// --------------------------------------------------
+// Write a buffer to a file
+// --------------------------------------------------
+
+static int writeFile(const char* filename, const uint8_t* buf, const uint32_t len)
+{
+    FILE* fp;
+
+    if ((fp = fopen(filename, "wb")) == NULL)
+    {
+        fprintf(stderr, "*** writeFile(): Unable to open file %s for writing\n", filename);
+        return USER_ERROR;
+    }
+
+    if (len && fwrite(buf, 1, len, fp) != len)
+    {
+        fprintf(stderr, "*** writeFile(): Error writing file %s\n", filename);
+        fclose(fp);
+        return USER_ERROR;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Return the minimum number of M10K blocks needed for
+// a memory of the given depth and width
+// --------------------------------------------------
+
+static uint32_t m10kBlocks(const uint32_t depth, const uint32_t width)
+{
+    uint32_t minBlocks = 0xffffffff;
+
+    for (int idx = 0; idx < M10K_NUM_CONFIGS; idx++)
+    {
+        uint32_t blocks = ((depth + m10kCfg[idx][0] - 1) / m10kCfg[idx][0]) *
+                          ((width + m10kCfg[idx][1] - 1) / m10kCfg[idx][1]);
+
+        minBlocks = (blocks < minBlocks) ? blocks : minBlocks;
+    }
+
+    return minBlocks;
+}
+
+// --------------------------------------------------
+// Return the M10K blocks for the slzw_dict memories:
+// a byte memory and a CWMAX+1 bit code memory of
+// MEMSIZE+1 entries, and two 32 bit wide occupied flag
+// memories of MEMSIZE/32 entries.
+// --------------------------------------------------
+
+static uint32_t dictM10kBlocks(const uint32_t cwMax, const uint32_t memSize)
+{
+    return m10kBlocks(memSize + 1, 8)         +
+           m10kBlocks(memSize + 1, cwMax + 1) +
+           2 * m10kBlocks(memSize / 32, 32);
+}
+
+// --------------------------------------------------
+// Compress input for each maximum code width, and
+// report ratio against block RAM usage
+// --------------------------------------------------
+
+static int sweepWidths(const std::vector<uint8_t> &ibuf, const slzwConfig_t &cfgIn)
+{
+    std::vector<uint8_t> obuf(ibuf.size() * 2 + 16);
+
+    printf("CWMAX  MEMSIZE  Out bytes    Ratio  Resets  M10K\n");
+
+    for (uint32_t width = SLZW_MINCWLEN; width <= SLZW_MAXCWLIMIT; width++)
+    {
+        slzwConfig_t cfg = cfgIn;
+        uint32_t     olen;
+
+        cfg.maxCodeWidth = width;
+        cfg.memSize      = 0;
+
+        slzwModel model(&cfg);
+
+        if (model.compress(ibuf.data(), ibuf.size(), obuf.data(), obuf.size(), olen) != SLZW_OK)
+        {
+            fprintf(stderr, "*** sweepWidths(): compression failed for width %d\n", width);
+            return USER_ERROR;
+        }
+
+        uint32_t memSize = model.getConfig().memSize;
+
+        printf("%5d  %7d  %9d  %7.3f  %6d  %4d\n", width, memSize, olen,
+               olen ? (double)ibuf.size()/(double)olen : 0.0,
+               model.getResetCount(), dictM10kBlocks(width, memSize));
+    }
+
+    return 0;
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    int          c;
+    bool         decomp   = false;
+    bool         sweep    = false;
+    bool         hwcodec  = false;
+    const char*  ifname   = NULL;
+    const char*  ofname   = NULL;
+    slzwConfig_t cfg;
+
+    cfg.policy            = SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth      = SLZW_DEFAULT_MAXCWLEN;
+    cfg.memSize           = 0;
+    cfg.checkGap          = SLZW_DEFAULT_CHECKGAP;
+
+    while ((c = getopt(argc, argv, "hdasHi:o:g:m:w:")) != -1)
+    {
+        switch (c)
+        {
+        case 'd':
+            decomp       = true;
+            break;
+        case 'a':
+            cfg.policy   = SLZW_RESET_ADAPTIVE;
+            break;
+        case 's':
+            sweep        = true;
+            break;
+        case 'H':
+            hwcodec      = true;
+            break;
+        case 'i':
+            ifname       = optarg;
+            break;
+        case 'o':
+            ofname       = optarg;
+            break;
+        case 'g':
+            cfg.checkGap = strtol(optarg, NULL, 0);
+            break;
+        case 'm':
+            cfg.memSize  = strtol(optarg, NULL, 0);
+            break;
+        case 'w':
+            cfg.maxCodeWidth = strtol(optarg, NULL, 0);
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-d] [-a] [-s] [-H] [-g <gap>] [-w <width>] [-m <size>] -i <infile> [-o <outfile>]\n", argv[0]);
+            printf("         -d Decompress (default compress)\n");
+            printf("         -a Use adaptive dictionary reset policy (default reset on full)\n");
+            printf("         -s Sweep maximum code widths, reporting ratio and block RAM usage\n");
+            printf("         -H Use hardware build codec (CWMAX=%d, MEMSIZE=%d)\n", CORE_PARAM_CWMAX, CORE_PARAM_MEMSIZE);
+            printf("         -g Ratio check gap in input bytes for adaptive policy (default %d)\n", SLZW_DEFAULT_CHECKGAP);
+            printf("         -w Maximum code width (default %d)\n", SLZW_DEFAULT_MAXCWLEN);
+            printf("         -m Dictionary memory size (default 2.5 x 2^width)\n");
+            printf("         -i Input file\n");
+            printf("         -o Output file (default no output)\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    if (ifname == NULL)
+    {
+        fprintf(stderr, "*** main(): no input file specified\n");
+        return USER_ERROR;
+    }
+
+    std::vector<uint8_t> ibuf;
+
+    if (readFile(ifname, ibuf))
+    {
+        return USER_ERROR;
+    }
+
+    if (sweep)
+    {
+        return sweepWidths(ibuf, cfg);
+    }
+
+    // Allow for worst case expansion on compression. Decompression output
+    // has no useful bound, so starts at a generous expansion ratio, and
+    // the buffer is doubled until the output fits.
+    uint32_t             olen;
+    std::vector<uint8_t> obuf(decomp ? ibuf.size() * 16 + 4096 : ibuf.size() * 2 + 16);
+    slzwModel            model(&cfg);
+    slzwCodecBase*       codec = NULL;
+    int                  status;
+
+    if (hwcodec)
+    {
+        if (cfg.policy == SLZW_RESET_ADAPTIVE)
+        {
+            codec = new slzwHwCodecAdaptive(CORE_PARAM_MEMSIZE, cfg.checkGap);
+        }
+        else
+        {
+            codec = new slzwHwCodec(CORE_PARAM_MEMSIZE, cfg.checkGap);
+        }
+    }
+
+    if (decomp)
+    {
+        do
+        {
+            status = codec ? codec->decompress(ibuf.data(), ibuf.size(), obuf.data(), obuf.size(), olen) :
+                             model.decompress(ibuf.data(), ibuf.size(), obuf.data(), obuf.size(), olen);
+
+            if (status == SLZW_ERR_OVERFLOW && obuf.size() <= UINT32_MAX / 2)
+            {
+                obuf.resize(obuf.size() * 2);
+            }
+            else
+            {
+                break;
+            }
+        }
+        while (true);
+    }
+    else
+    {
+        status = codec ? codec->compress(ibuf.data(), ibuf.size(), obuf.data(), obuf.size(), olen) :
+                         model.compress(ibuf.data(), ibuf.size(), obuf.data(), obuf.size(), olen);
+    }
+
+    if (status != SLZW_OK)
+    {
+        fprintf(stderr, "*** main(): %s failed with status %d\n", decomp ? "decompression" : "compression", status);
+        delete codec;
+        return USER_ERROR;
+    }
+
+    printf("%s: %zu bytes in, %u bytes out (ratio %.3f), %u resets (%u clear codes)\n",
+           ifname, ibuf.size(), olen,
+           olen ? (double)ibuf.size()/(double)olen : 0.0,
+           codec ? codec->getResetCount() : model.getResetCount(),
+           codec ? codec->getClearCount() : model.getClearCount());
+
+    delete codec;
+
+    if (ofname != NULL && writeFile(ofname, obuf.data(), olen))
+    {
+        return USER_ERROR;
+    }
+
+    return 0;
+}
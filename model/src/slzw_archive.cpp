@@ -0,0 +1,333 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW block indexed archive reader
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_archive.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-10
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods for random access reading of block indexed
+//  SLZW framed files.
+//
+//  Block data is read with pread(), rather than mapping the file, so that
+//  workers can read concurrently, and files larger than the 32-bit address
+//  space can be read on the platform.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#define _FILE_OFFSET_BITS 64
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <thread>
+
+#include "slzw_archive.h"
+
+// -------------------------------------------------------------------------
+// Read exactly len bytes at a file offset
+// -------------------------------------------------------------------------
+
+static bool readAt(const int fd, void* buf, const uint32_t len, const uint64_t offset)
+{
+    uint32_t done = 0;
+
+    while (done < len)
+    {
+        ssize_t n = pread(fd, (uint8_t*)buf + done, len - done, (off_t)(offset + done));
+
+        if (n <= 0)
+        {
+            return false;
+        }
+
+        done += n;
+    }
+
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// Constructor
+// -------------------------------------------------------------------------
+
+slzwArchive::slzwArchive() : fd(-1), verify(true), nextBlock(0), readStatus(SLZW_ARC_OK)
+{
+    memset(&hdr, 0, sizeof(hdr));
+}
+
+// -------------------------------------------------------------------------
+// Destructor
+// -------------------------------------------------------------------------
+
+slzwArchive::~slzwArchive()
+{
+    close();
+}
+
+// -------------------------------------------------------------------------
+// Open a framed file, checking and loading its block index
+// -------------------------------------------------------------------------
+
+int slzwArchive::open(const char* filename)
+{
+    struct stat      st;
+    slzwFrmTrailer_t trailer;
+
+    close();
+
+    if ((fd = ::open(filename, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+    {
+        close();
+        return SLZW_ARC_ERR_FILE;
+    }
+
+    const uint64_t fileLen = st.st_size;
+
+    if (fileLen < sizeof(hdr) + sizeof(slzwFrm_t) + sizeof(trailer) ||
+        !readAt(fd, &hdr, sizeof(hdr), 0) ||
+        !readAt(fd, &trailer, sizeof(trailer), fileLen - sizeof(trailer)))
+    {
+        close();
+        return SLZW_ARC_ERR_FORMAT;
+    }
+
+    // Version 1 files have no index, and are only readable sequentially
+    if (hdr.magic != SLZW_FRM_MAGIC || hdr.version < SLZW_FRM_VERSION || hdr.chunkSize == 0 ||
+        trailer.magic != SLZW_FRM_IDX_MAGIC ||
+        trailer.indexOffset + (uint64_t)trailer.numBlocks * sizeof(slzwFrmIdx_t) + sizeof(trailer) != fileLen)
+    {
+        close();
+        return SLZW_ARC_ERR_FORMAT;
+    }
+
+    index.resize(trailer.numBlocks);
+    rawOffsets.resize(trailer.numBlocks + 1);
+
+    if (trailer.numBlocks && !readAt(fd, index.data(), trailer.numBlocks * sizeof(slzwFrmIdx_t), trailer.indexOffset))
+    {
+        close();
+        return SLZW_ARC_ERR_FORMAT;
+    }
+
+    rawOffsets[0] = 0;
+
+    for (uint32_t blk = 0; blk < trailer.numBlocks; blk++)
+    {
+        const slzwFrmIdx_t &idx = index[blk];
+
+        if (idx.rawLen == 0 || idx.rawLen > hdr.chunkSize || idx.offset + idx.dataLen > trailer.indexOffset ||
+            ((idx.flags & SLZW_FRM_RAW) && idx.dataLen != idx.rawLen))
+        {
+            close();
+            return SLZW_ARC_ERR_FORMAT;
+        }
+
+        rawOffsets[blk + 1] = rawOffsets[blk] + idx.rawLen;
+    }
+
+    return SLZW_ARC_OK;
+}
+
+// -------------------------------------------------------------------------
+// Close any open file
+// -------------------------------------------------------------------------
+
+void slzwArchive::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+
+    index.clear();
+    rawOffsets.clear();
+}
+
+// -------------------------------------------------------------------------
+// Add software engines, each with its own model
+// -------------------------------------------------------------------------
+
+void slzwArchive::addSoftwareEngines(const uint32_t num)
+{
+    slzwConfig_t cfg;
+    cfg.policy       = hdr.resetPolicy ? SLZW_RESET_ADAPTIVE : SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth = hdr.maxCodeWidth;
+    cfg.memSize      = 0;
+    cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+    for (uint32_t eng = 0; eng < num; eng++)
+    {
+        slzwModel* pModel = new slzwModel(&cfg);
+
+        models.push_back(std::unique_ptr<slzwModel>(pModel));
+
+        addEngine([pModel](const uint8_t* data, const uint32_t dataLen, uint8_t* raw, const uint32_t rawLen)
+        {
+            uint32_t decLen;
+
+            return (pModel->decompress(data, dataLen, raw, rawLen, decLen) != SLZW_OK || decLen != rawLen) ? SLZW_ARC_ERR_DECODE : SLZW_ARC_OK;
+        });
+    }
+}
+
+// -------------------------------------------------------------------------
+// Read a range of uncompressed data, decoding the blocks covering it
+// -------------------------------------------------------------------------
+
+int slzwArchive::read(const uint64_t offset, const uint32_t len, uint8_t* buf, uint32_t &olen)
+{
+    olen = 0;
+
+    if (fd < 0)
+    {
+        return SLZW_ARC_ERR_FILE;
+    }
+
+    if (offset >= size() || len == 0)
+    {
+        return SLZW_ARC_OK;
+    }
+
+    olen = (uint32_t)std::min((uint64_t)len, size() - offset);
+
+    // Default to a software engine per hardware thread
+    if (engines.empty())
+    {
+        addSoftwareEngines(std::max(std::thread::hardware_concurrency(), 1U));
+    }
+
+    // Blocks covering the range (the last whose start is at or before each end)
+    const uint32_t first = std::upper_bound(rawOffsets.begin(), rawOffsets.end(), offset) - rawOffsets.begin() - 1;
+    const uint32_t last  = std::upper_bound(rawOffsets.begin(), rawOffsets.end(), offset + olen - 1) - rawOffsets.begin() - 1;
+
+    const uint32_t numThreads = std::min((uint32_t)engines.size(), last - first + 1);
+
+    nextBlock  = first;
+    readStatus = SLZW_ARC_OK;
+
+    // The calling thread runs the first engine, alongside threads for the rest
+    std::vector<std::thread> threads;
+
+    for (uint32_t eng = 1; eng < numThreads; eng++)
+    {
+        threads.push_back(std::thread(&slzwArchive::worker, this, eng, last, offset, olen, buf));
+    }
+
+    worker(0, last, offset, olen, buf);
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    if (readStatus != SLZW_ARC_OK)
+    {
+        olen = 0;
+    }
+
+    return readStatus;
+}
+
+// -------------------------------------------------------------------------
+// Decode blocks, taking the next from the shared counter, until all
+// blocks to the last are taken or a block fails
+// -------------------------------------------------------------------------
+
+void slzwArchive::worker(const uint32_t engine, const uint32_t last, const uint64_t offset, const uint32_t len, uint8_t* buf)
+{
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> raw;
+    uint32_t             blk;
+
+    while (readStatus == SLZW_ARC_OK && (blk = nextBlock++) <= last)
+    {
+        int status = decodeBlock(engine, blk, data, raw, offset, len, buf);
+
+        if (status != SLZW_ARC_OK)
+        {
+            int ok = SLZW_ARC_OK;
+            readStatus.compare_exchange_strong(ok, status);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// Decode a block. Blocks wholly in the range are decoded straight to
+// the output buffer, and others to the raw scratch buffer, from which
+// the part in the range is copied.
+// -------------------------------------------------------------------------
+
+int slzwArchive::decodeBlock(const uint32_t engine, const uint32_t blk, std::vector<uint8_t> &data, std::vector<uint8_t> &raw,
+                             const uint64_t offset, const uint32_t len, uint8_t* buf)
+{
+    const slzwFrmIdx_t &idx      = index[blk];
+    const uint64_t      blkStart = rawOffsets[blk];
+    const uint64_t      cpStart  = std::max(blkStart, offset);
+    const uint64_t      cpEnd    = std::min(rawOffsets[blk + 1], offset + len);
+    const bool          whole    = cpStart == blkStart && cpEnd == rawOffsets[blk + 1];
+
+    uint8_t* out = buf + (cpStart - offset);
+
+    if (!whole)
+    {
+        raw.resize(idx.rawLen);
+        out = raw.data();
+    }
+
+    if (idx.flags & SLZW_FRM_RAW)
+    {
+        if (!readAt(fd, out, idx.rawLen, idx.offset))
+        {
+            return SLZW_ARC_ERR_FILE;
+        }
+    }
+    else
+    {
+        data.resize(idx.dataLen);
+
+        if (!readAt(fd, data.data(), idx.dataLen, idx.offset))
+        {
+            return SLZW_ARC_ERR_FILE;
+        }
+
+        if (engines[engine](data.data(), idx.dataLen, out, idx.rawLen) != SLZW_ARC_OK)
+        {
+            return SLZW_ARC_ERR_DECODE;
+        }
+    }
+
+    if (verify && slzwModel::crc32(out, idx.rawLen) != idx.checksum)
+    {
+        return SLZW_ARC_ERR_CHECKSUM;
+    }
+
+    if (!whole)
+    {
+        memcpy(buf + (cpStart - offset), raw.data() + (cpStart - blkStart), cpEnd - cpStart);
+    }
+
+    return SLZW_ARC_OK;
+}
@@ -0,0 +1,131 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW block indexed archive reader header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_archive.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-10
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definition for random access reading of
+//  framed SLZW files with a block index (slzw_frame.h, version 2).
+//
+//  A read of a byte range decodes only the blocks that cover it. Blocks are
+//  shared between decode engines, each run on its own thread, with the
+//  calling thread running the first. An engine is a function decoding one
+//  block, such as a job on a hardware codec, and is only called from its
+//  own thread. If no engines are added, software engines, using the SLZW
+//  model, are created for each hardware thread.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_ARCHIVE_H_
+#define _SLZW_ARCHIVE_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+
+#include "slzw_frame.h"
+#include "slzw_model.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Return status values
+#define SLZW_ARC_OK               0
+#define SLZW_ARC_ERR_FILE         1
+#define SLZW_ARC_ERR_FORMAT       2
+#define SLZW_ARC_ERR_DECODE       3
+#define SLZW_ARC_ERR_CHECKSUM     4
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Block decode engine. Decodes dataLen bytes of compressed block data into
+// exactly rawLen bytes, returning 0 on success.
+typedef std::function<int(const uint8_t* data, const uint32_t dataLen, uint8_t* raw, const uint32_t rawLen)> slzwBlockDecoder_t;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITION
+// -------------------------------------------------------------------------
+
+class slzwArchive
+{
+public:
+    slzwArchive();
+    ~slzwArchive();
+
+    // Open a framed file and load its block index
+    int      open        (const char* filename);
+    void     close       ();
+
+    // Add a decode engine. Not thread safe with reads in progress.
+    void     addEngine   (const slzwBlockDecoder_t &decoder) { engines.push_back(decoder); };
+
+    // Add software decode engines, using the SLZW model configured from the
+    // open file's header
+    void     addSoftwareEngines (const uint32_t num);
+
+    // Enable or disable checking each decoded block's checksum (default enabled)
+    void     setVerify   (const bool enable) { verify = enable; };
+
+    // Uncompressed size, block count and file header of the open file
+    uint64_t size        () { return rawOffsets.empty() ? 0 : rawOffsets.back(); };
+    uint32_t numBlocks   () { return index.size(); };
+    const slzwFrmHdr_t &header () { return hdr; };
+
+    // Read len uncompressed bytes from offset into buf, with the number of
+    // bytes read (less than len at the end of the data) returned in olen.
+    // One read may be in progress at a time.
+    int      read        (const uint64_t offset, const uint32_t len, uint8_t* buf, uint32_t &olen);
+
+private:
+
+    // Decode blocks up to last, from the next block counter, with an engine
+    void     worker      (const uint32_t engine, const uint32_t last, const uint64_t offset, const uint32_t len, uint8_t* buf);
+
+    // Decode a block, copying the part in the read range to buf
+    int      decodeBlock (const uint32_t engine, const uint32_t blk, std::vector<uint8_t> &data, std::vector<uint8_t> &raw,
+                          const uint64_t offset, const uint32_t len, uint8_t* buf);
+
+    int                                     fd;
+    bool                                    verify;
+    slzwFrmHdr_t                            hdr;
+    std::vector<slzwFrmIdx_t>               index;
+    std::vector<uint64_t>                   rawOffsets;     // Uncompressed offset of each block, and the total size
+
+    std::vector<slzwBlockDecoder_t>         engines;
+    std::vector<std::unique_ptr<slzwModel>> models;         // Software engines' models
+
+    // Per read state, shared by the workers
+    std::atomic<uint32_t>                   nextBlock;
+    std::atomic<int>                        readStatus;
+};
+
+#endif
@@ -0,0 +1,222 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW AXI-4 master design space sweep
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_axi_sweep.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-04
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the top level code for a host command line program to
+//  sweep the slzw_axi4_master burst size, FIFO depth and outstanding
+//  transaction limit over a set of memory profiles, using the transaction
+//  level model, and output the sustained throughput of each configuration as
+//  CSV, for choosing the RTL parameters before a synthesis run.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+
+#include "slzw_axi_tlm.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+#define DEFAULT_XFER_LEN          (256 * 1024)
+#define DEFAULT_RX_ADDR           0x00000000
+#define DEFAULT_TX_ADDR           0x01000000
+
+// Codec consumes a byte per cycle (USRPORTWIDTH of 8)
+#define DEFAULT_USER_RATE         1.0
+#define DEFAULT_RATIO             0.5
+#define DEFAULT_CLK_MHZ           100
+
+#define NUM_ELEMS(_a)             (sizeof(_a)/sizeof(_a[0]))
+
+// --------------------------------------------------
+// STATIC VARIABLES
+// --------------------------------------------------
+
+// Memory profiles: the DE10-nano profile approximates the HPS F2SDRAM port
+// as seen from the FPGA fabric, and the congested profile the same with the
+// HPS contending for the SDRAM
+static const slzwMemProfile_t profiles[] = {
+    //  name         rdLat wrLat jitter maxOut beats/cycle
+    { "ideal",       1,    1,    0,     16,    1.0  },
+    { "de10-nano",   30,   20,   8,     8,     0.8  },
+    { "congested",   80,   60,   64,    4,     0.3  }
+};
+
+static const uint32_t bursts[]      = {16, 32, 64, 128, 256};
+static const uint32_t fifoDepths[]  = {64, 128, 256, 512, 1024};
+static const uint32_t outstanding[] = {1, 2, 4, 8, 0};
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    int          c;
+    uint32_t     len      = DEFAULT_XFER_LEN;
+    uint32_t     rxAddr   = DEFAULT_RX_ADDR;
+    uint32_t     txAddr   = DEFAULT_TX_ADDR;
+    double       rate     = DEFAULT_USER_RATE;
+    double       ratio    = DEFAULT_RATIO;
+    double       clkMhz   = DEFAULT_CLK_MHZ;
+    const char*  profName = NULL;
+    const char*  ofname   = NULL;
+    FILE*        ofp      = stdout;
+
+    while ((c = getopt(argc, argv, "hl:a:t:u:r:c:p:o:")) != -1)
+    {
+        switch (c)
+        {
+        case 'l':
+            len      = strtol(optarg, NULL, 0);
+            break;
+        case 'a':
+            rxAddr   = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            txAddr   = strtoul(optarg, NULL, 0);
+            break;
+        case 'u':
+            rate     = strtod(optarg, NULL);
+            break;
+        case 'r':
+            ratio    = strtod(optarg, NULL);
+            break;
+        case 'c':
+            clkMhz   = strtod(optarg, NULL);
+            break;
+        case 'p':
+            profName = optarg;
+            break;
+        case 'o':
+            ofname   = optarg;
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-l <bytes>] [-a <addr>] [-t <addr>] [-u <rate>] [-r <ratio>] [-c <MHz>] [-p <profile>] [-o <csv file>]\n", argv[0]);
+            printf("         -l Input transfer length in bytes (default %d)\n", DEFAULT_XFER_LEN);
+            printf("         -a Input start address (default 0x%08x)\n", DEFAULT_RX_ADDR);
+            printf("         -t Output start address (default 0x%08x)\n", DEFAULT_TX_ADDR);
+            printf("         -u Codec input bytes per cycle (default %.1f)\n", DEFAULT_USER_RATE);
+            printf("         -r Output to input length ratio, 0 for read only (default %.2f)\n", DEFAULT_RATIO);
+            printf("         -c Clock frequency in MHz, for MB/s (default %d)\n", DEFAULT_CLK_MHZ);
+            printf("         -p Memory profile only (");
+            for (uint32_t pidx = 0; pidx < NUM_ELEMS(profiles); pidx++)
+            {
+                printf("%s%s", pidx ? ", " : "", profiles[pidx].name);
+            }
+            printf(", default all)\n");
+            printf("         -o Output CSV file (default stdout)\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    if (len == 0 || rate <= 0.0 || ratio < 0.0 || clkMhz <= 0.0)
+    {
+        fprintf(stderr, "*** main(): invalid length, rate, ratio or clock frequency\n");
+        return USER_ERROR;
+    }
+
+    if (profName != NULL)
+    {
+        bool found = false;
+
+        for (uint32_t pidx = 0; pidx < NUM_ELEMS(profiles); pidx++)
+        {
+            found |= strcmp(profName, profiles[pidx].name) == 0;
+        }
+
+        if (!found)
+        {
+            fprintf(stderr, "*** main(): Unknown memory profile %s\n", profName);
+            return USER_ERROR;
+        }
+    }
+
+    if (ofname != NULL && (ofp = fopen(ofname, "w")) == NULL)
+    {
+        fprintf(stderr, "*** main(): Unable to open file %s for writing\n", ofname);
+        return USER_ERROR;
+    }
+
+    uint32_t txLen = (uint32_t)(len * ratio);
+
+    fprintf(ofp, "profile,burst,fifo,outstanding,cycles,rd_bursts,wr_bursts,rd_fifo_max,tx_fifo_max,in_bytes_per_cycle,in_MBps,fifo_count_overflow,boundary_cross\n");
+
+    for (uint32_t pidx = 0; pidx < NUM_ELEMS(profiles); pidx++)
+    {
+        if (profName != NULL && strcmp(profName, profiles[pidx].name) != 0)
+        {
+            continue;
+        }
+
+        for (uint32_t bidx = 0; bidx < NUM_ELEMS(bursts); bidx++)
+        {
+            for (uint32_t fidx = 0; fidx < NUM_ELEMS(fifoDepths); fidx++)
+            {
+                for (uint32_t oidx = 0; oidx < NUM_ELEMS(outstanding); oidx++)
+                {
+                    slzwAxiCfg_t cfg = {bursts[bidx], fifoDepths[fidx], fifoDepths[fidx], outstanding[oidx], outstanding[oidx]};
+
+                    if (!slzwAxiTlm::validConfig(cfg))
+                    {
+                        continue;
+                    }
+
+                    // Same seed for each configuration, so all see the same jitter sequence
+                    slzwAxiTlm      tlm(cfg, profiles[pidx], rate);
+                    slzwAxiResult_t res = tlm.run(rxAddr, len, txAddr, txLen);
+
+                    double bytesPerCycle = res.cycles ? (double)len / res.cycles : 0.0;
+
+                    fprintf(ofp, "%s,%u,%u,%u,%llu,%llu,%llu,%u,%u,%.4f,%.2f,%d,%d\n",
+                            profiles[pidx].name, cfg.burstSize, cfg.rxFifoDepth, cfg.maxRdOutstanding,
+                            (unsigned long long)res.cycles, (unsigned long long)res.rdBursts, (unsigned long long)res.wrBursts,
+                            res.rdFifoMax, res.txFifoMax, bytesPerCycle, bytesPerCycle * clkMhz,
+                            res.fifoCountOverflow, res.boundaryCross);
+                }
+            }
+        }
+    }
+
+    if (ofp != stdout)
+    {
+        fclose(ofp);
+    }
+
+    return 0;
+}
@@ -0,0 +1,285 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW AXI-4 master transaction level model
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_axi_tlm.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-04
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods of the slzw_axi4_master transaction level
+//  model
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "slzw_axi_tlm.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define AXI_BOUNDARY_BYTES        4096
+
+// Limit on run length, against a configuration that can't progress
+#define MAX_RUN_CYCLES            (1ULL << 32)
+
+// -------------------------------------------------------------------------
+// Constructor
+// -------------------------------------------------------------------------
+
+slzwAxiTlm::slzwAxiTlm(const slzwAxiCfg_t &cfgIn, const slzwMemProfile_t &memIn, const double userBytesPerCycle, const uint32_t seed) :
+    cfg(cfgIn), mem(memIn), userRate(userBytesPerCycle), rng(seed)
+{
+}
+
+// -------------------------------------------------------------------------
+// Check the configuration meets the RTL's parameter constraints
+// -------------------------------------------------------------------------
+
+bool slzwAxiTlm::validConfig(const slzwAxiCfg_t &cfg)
+{
+    return cfg.burstSize >= 1 && cfg.burstSize <= SLZW_AXI_MAXBURST && (cfg.burstSize & (cfg.burstSize - 1)) == 0 &&
+           cfg.rxFifoDepth >= cfg.burstSize && cfg.txFifoDepth >= cfg.burstSize;
+}
+
+// -------------------------------------------------------------------------
+// Length of the first burst from addr, ending on a burst size boundary
+// (the RTL's rx_words_to_boundary), limited to the transfer length
+// -------------------------------------------------------------------------
+
+uint32_t slzwAxiTlm::firstBurst(const uint32_t addr, const uint32_t words)
+{
+    uint32_t toBoundary = cfg.burstSize - ((addr >> 2) & (cfg.burstSize - 1));
+
+    return std::min(toBoundary, words);
+}
+
+// -------------------------------------------------------------------------
+// Return a latency with random jitter added
+// -------------------------------------------------------------------------
+
+uint32_t slzwAxiTlm::latency(const uint32_t base)
+{
+    return base + (mem.jitter ? rng() % (mem.jitter + 1) : 0);
+}
+
+// -------------------------------------------------------------------------
+// Flag a burst that crosses a 4KB boundary
+// -------------------------------------------------------------------------
+
+void slzwAxiTlm::checkBoundary(const uint32_t addr, const uint32_t beats)
+{
+    if ((addr % AXI_BOUNDARY_BYTES) + beats * 4 > AXI_BOUNDARY_BYTES)
+    {
+        res.boundaryCross = true;
+    }
+}
+
+// -------------------------------------------------------------------------
+// Run a transfer
+// -------------------------------------------------------------------------
+
+slzwAxiResult_t slzwAxiTlm::run(const uint32_t rxAddr, const uint32_t rxLen, const uint32_t txAddr, const uint32_t txLen)
+{
+    const uint32_t rxWords       = (rxLen + 3) / 4;
+    const uint32_t txWords       = (txLen + 3) / 4;
+    // The RTL's RX FIFO count register is $clog2(RXFIFODEPTH) + 1 bits
+    const uint32_t fifoCountMax  = (cfg.rxFifoDepth << 1) - 1;
+
+    res = slzwAxiResult_t();
+
+    // Read engine state
+    uint32_t            rdAddr       = rxAddr & ~3U;
+    uint32_t            rdUnrequested= rxWords;
+    uint32_t            rdFifoCount  = 0;          // Words held plus requested
+    uint32_t            rdHeld       = 0;          // Words held in the RX FIFO
+    uint32_t            rdInflight   = 0;          // Read bursts issued but not complete
+    uint32_t            rdConsumed   = 0;          // Words popped by the codec
+    bool                rdFirst      = true;
+    std::deque<burst_t> rdq;                       // Slave's accepted read bursts
+
+    // Write engine state
+    uint32_t            wrAddr       = txAddr & ~3U;
+    uint32_t            txProduced   = 0;          // Words produced by the codec
+    uint32_t            txHeld       = 0;          // Words held in the TX FIFO
+    uint32_t            txUnissued   = 0;          // Held words not yet covered by a write burst
+    uint32_t            wrUnissued   = txWords;    // Words not yet covered by a write burst
+    uint32_t            wrInflight   = 0;          // Write bursts issued but without response
+    uint32_t            wrDone       = 0;          // Write bursts responded
+    bool                wrFirst      = true;
+    std::deque<burst_t> awq;                       // Slave's accepted write bursts, awaiting data
+    std::deque<burst_t> bq;                        // Write bursts awaiting response
+
+    uint32_t            slaveOutstanding = 0;
+    double              userCredit       = 0.0;
+    double              bwTokens         = 0.0;
+
+    for (uint64_t cycle = 0; cycle < MAX_RUN_CYCLES; cycle++)
+    {
+        // Finished when all input consumed, and all output written and responded
+        if (rdConsumed == rxWords && wrUnissued == 0 && wrInflight == 0)
+        {
+            res.cycles = cycle;
+            break;
+        }
+
+        bwTokens = std::min(bwTokens + mem.beatsPerCycle, 2.0);
+
+        // --- Read address: issue when there is room in the RX FIFO for a whole burst ---
+        if (rdUnrequested != 0 && (rdFirst || rdFifoCount <= cfg.rxFifoDepth - cfg.burstSize) &&
+            (cfg.maxRdOutstanding == 0 || rdInflight < cfg.maxRdOutstanding) &&
+            slaveOutstanding < mem.maxOutstanding)
+        {
+            uint32_t beats = rdFirst ? firstBurst(rdAddr, rdUnrequested) : std::min(cfg.burstSize, rdUnrequested);
+
+            checkBoundary(rdAddr, beats);
+
+            burst_t b    = {rdAddr, beats, cycle + latency(mem.rdLatency)};
+            rdq.push_back(b);
+
+            rdAddr        += beats * 4;
+            rdUnrequested -= beats;
+            rdFifoCount   += beats;
+            rdInflight++;
+            slaveOutstanding++;
+            res.rdBursts++;
+            rdFirst        = false;
+        }
+
+        // --- Data beats, reads and writes alternating priority for the bandwidth ---
+        for (int pass = 0; pass < 2; pass++)
+        {
+            bool readTurn = ((cycle + pass) & 1) == 0;
+
+            if (bwTokens < 1.0)
+            {
+                break;
+            }
+
+            if (readTurn && !rdq.empty() && cycle >= rdq.front().readyCycle)
+            {
+                bwTokens -= 1.0;
+                rdHeld++;
+
+                if (--rdq.front().beats == 0)
+                {
+                    rdq.pop_front();
+                    rdInflight--;
+                    slaveOutstanding--;
+                }
+            }
+            else if (!readTurn && !awq.empty() && txHeld != 0 && cycle >= awq.front().readyCycle)
+            {
+                bwTokens -= 1.0;
+                txHeld--;
+
+                if (--awq.front().beats == 0)
+                {
+                    burst_t b = awq.front();
+                    b.readyCycle = cycle + latency(mem.wrLatency);
+                    bq.push_back(b);
+                    awq.pop_front();
+                }
+            }
+        }
+
+        // --- Write responses ---
+        if (!bq.empty() && cycle >= bq.front().readyCycle)
+        {
+            bq.pop_front();
+            wrInflight--;
+            wrDone++;
+            slaveOutstanding--;
+        }
+
+        // --- Write address: issue once the burst's data is held in the TX FIFO ---
+        if (wrUnissued != 0 && (cfg.maxWrOutstanding == 0 || wrInflight < cfg.maxWrOutstanding) &&
+            slaveOutstanding < mem.maxOutstanding)
+        {
+            uint32_t beats = wrFirst ? firstBurst(wrAddr, wrUnissued) : std::min(cfg.burstSize, wrUnissued);
+
+            if (txUnissued >= beats)
+            {
+                checkBoundary(wrAddr, beats);
+
+                // Data can follow the address in the next cycle
+                burst_t b    = {wrAddr, beats, cycle + 1};
+                awq.push_back(b);
+
+                wrAddr      += beats * 4;
+                wrUnissued  -= beats;
+                txUnissued  -= beats;
+                wrInflight++;
+                slaveOutstanding++;
+                res.wrBursts++;
+                wrFirst      = false;
+            }
+        }
+
+        // --- Codec: consume input bytes, stalling when the TX FIFO is full ---
+        if (txWords == 0 || txHeld < cfg.txFifoDepth)
+        {
+            userCredit += userRate;
+
+            while (userCredit >= 4.0 && rdHeld != 0)
+            {
+                userCredit -= 4.0;
+                rdHeld--;
+                rdFifoCount--;
+                rdConsumed++;
+            }
+        }
+
+        // Unused credit doesn't accumulate whilst starved of input
+        if (rdHeld == 0)
+        {
+            userCredit = std::min(userCredit, 4.0);
+        }
+
+        // The RTL updates the count for a new burst and a FIFO read in the same cycle
+        res.rdFifoMax = std::max(res.rdFifoMax, rdFifoCount);
+        if (rdFifoCount > fifoCountMax)
+        {
+            res.fifoCountOverflow = true;
+        }
+
+        // Output produced in proportion to the input consumed
+        if (txWords != 0)
+        {
+            uint32_t target = (rdConsumed == rxWords) ? txWords : (uint32_t)(((uint64_t)rdConsumed * txWords) / rxWords);
+            uint32_t space  = cfg.txFifoDepth - txHeld;
+            uint32_t words  = std::min(target - txProduced, space);
+
+            txProduced += words;
+            txHeld     += words;
+            txUnissued += words;
+
+            res.txFifoMax = std::max(res.txFifoMax, txHeld);
+        }
+    }
+
+    return res;
+}
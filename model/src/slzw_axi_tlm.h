@@ -0,0 +1,136 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW AXI-4 master transaction level model header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_axi_tlm.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-04
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definitions for a transaction level model of the
+//  slzw_axi4_master read and write engines, connected to a memory with a
+//  configurable latency and bandwidth profile, for exploring the burst size,
+//  FIFO depth and outstanding transaction parameters.
+//
+//  The model steps in clock cycles, with data moved as AXI bursts and beats
+//  rather than signals. The read engine follows the RTL's rules: the first
+//  burst ends on a burst size boundary (rx_words_to_boundary), so that no
+//  later burst crosses a 4KB boundary, and a new burst is only issued when
+//  the RX FIFO count (words held plus words requested) leaves room for a
+//  whole burst. The write engine applies the same alignment rules to a TX
+//  FIFO filled by the codec output, issuing a burst once its data is held,
+//  and back pressuring the codec when the FIFO is full.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_AXI_TLM_H_
+#define _SLZW_AXI_TLM_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+#include <deque>
+#include <random>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define SLZW_AXI_MAXBURST         256
+
+// Defaults matching the RTL parameters
+#define SLZW_AXI_DEFAULT_BURST    128
+#define SLZW_AXI_DEFAULT_FIFO     256
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Master configuration
+typedef struct {
+    uint32_t burstSize;             // DEFAULTBURSTSIZE (power of 2, <= 256)
+    uint32_t rxFifoDepth;           // RXFIFODEPTH, in words
+    uint32_t txFifoDepth;           // TX FIFO depth, in words
+    uint32_t maxRdOutstanding;      // Read bursts in flight limit (0 for none, as the RTL)
+    uint32_t maxWrOutstanding;      // Write bursts awaiting response limit (0 for none)
+} slzwAxiCfg_t;
+
+// Memory profile
+typedef struct {
+    const char* name;
+    uint32_t    rdLatency;          // Cycles from read address accepted to first data
+    uint32_t    wrLatency;          // Cycles from last write data to response
+    uint32_t    jitter;             // Random extra latency, 0 to jitter cycles
+    uint32_t    maxOutstanding;     // Bursts the slave accepts before deasserting ready
+    double      beatsPerCycle;      // Sustainable data beats per cycle, shared by reads and writes
+} slzwMemProfile_t;
+
+// Results of a run
+typedef struct {
+    uint64_t    cycles;
+    uint64_t    rdBursts;
+    uint64_t    wrBursts;
+    uint32_t    rdFifoMax;          // Peak RX FIFO count (held plus requested)
+    uint32_t    txFifoMax;          // Peak TX FIFO words
+    bool        fifoCountOverflow;  // RX FIFO count exceeded the RTL's register width
+    bool        boundaryCross;      // A burst crossed a 4KB boundary
+} slzwAxiResult_t;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITION
+// -------------------------------------------------------------------------
+
+class slzwAxiTlm
+{
+public:
+    // userBytesPerCycle is the codec's input consumption rate (at most USRPORTWIDTH/8)
+    slzwAxiTlm(const slzwAxiCfg_t &cfgIn, const slzwMemProfile_t &memIn, const double userBytesPerCycle, const uint32_t seed = 1);
+
+    // Check the configuration is one the RTL supports
+    static bool validConfig (const slzwAxiCfg_t &cfg);
+
+    // Run a transfer of rxLen input bytes from rxAddr, writing txLen
+    // output bytes to txAddr (txLen of 0 for a read only transfer).
+    // Output is produced in proportion to the input consumed.
+    slzwAxiResult_t run      (const uint32_t rxAddr, const uint32_t rxLen,
+                              const uint32_t txAddr, const uint32_t txLen);
+
+private:
+    typedef struct {
+        uint32_t addr;
+        uint32_t beats;
+        uint64_t readyCycle;        // Cycle at which data (read) or response (write) can start
+    } burst_t;
+
+    uint32_t firstBurst      (const uint32_t addr, const uint32_t words);
+    uint32_t latency         (const uint32_t base);
+    void     checkBoundary   (const uint32_t addr, const uint32_t beats);
+
+    slzwAxiCfg_t              cfg;
+    slzwMemProfile_t          mem;
+    double                    userRate;
+    std::mt19937              rng;
+
+    slzwAxiResult_t           res;
+};
+
+#endif
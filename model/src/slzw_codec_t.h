@@ -0,0 +1,609 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW compile-time specialised codec templates
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_codec_t.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-24
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class templates for the SLZW software codec
+//  compress and decompress loops. The templates are parameterised on the
+//  maximum codeword width, the dictionary memory size, the hash function and
+//  the dictionary reset policy, so that no configuration is tested per byte.
+//
+//  A MEMSIZE template parameter of 0 selects a memory size given at
+//  construction, for use by the runtime configured slzwModel.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_CODEC_T_H_
+#define _SLZW_CODEC_T_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#include "slzw_model.h"
+
+// -------------------------------------------------------------------------
+// Reset policy selectors
+// -------------------------------------------------------------------------
+
+struct slzwResetOnFull
+{
+    static const slzwResetPolicy_t policy = SLZW_RESET_ON_FULL;
+};
+
+struct slzwResetAdaptive
+{
+    static const slzwResetPolicy_t policy = SLZW_RESET_ADAPTIVE;
+};
+
+// -------------------------------------------------------------------------
+// Hash function, matching slzw_hash in slzw_lib.v. The input byte is
+// repeated to fill CWMAX+1 bits, and added to the bit reversed CWMAX+1
+// bit code. For 12 bit codes, this is {byte[4:0], byte} plus the reversed
+// 13 bit code.
+// -------------------------------------------------------------------------
+
+template <unsigned CWMAX>
+struct slzwHash
+{
+    static inline uint32_t calc(const uint32_t code, const uint8_t byte)
+    {
+        const uint32_t bits = CWMAX + 1;
+
+        uint32_t num1 = (((uint32_t)byte << 16) | ((uint32_t)byte << 8) | byte) & ((1U << bits) - 1);
+        uint32_t num2 = 0;
+
+        for (uint32_t bit = 0; bit < bits; bit++)
+        {
+            num2 |= ((code >> bit) & 1) << (bits - 1 - bit);
+        }
+
+        return num1 + num2;
+    }
+};
+
+// -------------------------------------------------------------------------
+// Codec base class, giving a common interface to all specialisations
+// -------------------------------------------------------------------------
+
+class slzwCodecBase
+{
+public:
+    slzwCodecBase() : resetCount(0), clearCount(0) {};
+    virtual ~slzwCodecBase() {};
+
+    virtual int compress   (const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen) = 0;
+    virtual int decompress (const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen) = 0;
+
+    uint32_t getResetCount () { return resetCount; };
+    uint32_t getClearCount () { return clearCount; };
+
+protected:
+    uint32_t resetCount;
+    uint32_t clearCount;
+};
+
+// -------------------------------------------------------------------------
+// Specialised codec class template
+// -------------------------------------------------------------------------
+
+template <unsigned CWMAX, unsigned MEMSIZE = 0, class HASH = slzwHash<CWMAX>, class POLICY = slzwResetOnFull>
+class slzwCodecT : public slzwCodecBase
+{
+    static_assert(CWMAX >= SLZW_MINCWLEN && CWMAX <= SLZW_MAXCWLIMIT, "slzwCodecT: CWMAX out of range");
+    static_assert(MEMSIZE == 0 || MEMSIZE >= 32,                      "slzwCodecT: MEMSIZE too small");
+
+public:
+    // Bounding values for this specialisation
+    static const uint32_t dictFull = 1U << CWMAX;
+    static const uint32_t maxSeed  = 2U << CWMAX;
+    static const bool     adaptive = (POLICY::policy == SLZW_RESET_ADAPTIVE);
+    static const uint32_t firstCw  = adaptive ? SLZW_CLRCW + 1 : SLZW_FIRSTCW;
+
+    // Constructor. The memory size argument is only used when MEMSIZE is 0.
+    slzwCodecT(const uint32_t memSizeIn = MEMSIZE, const uint32_t checkGapIn = SLZW_DEFAULT_CHECKGAP) :
+        memSizeRt(MEMSIZE ? MEMSIZE : memSizeIn),
+        checkGap(checkGapIn)
+    {
+        hashKey.resize(memSizeRt);
+        hashCode.resize(memSizeRt);
+        prefix.resize(dictFull);
+        suffix.resize(dictFull);
+        stack.resize(dictFull);
+    };
+
+    // ---------------------------------------------------------------------
+    // Compress ilen bytes from ibuf into obuf (of obufLen bytes capacity).
+    // Number of bytes output returned in olen, which on overflow is the
+    // bytes written before obuf filled.
+    // ---------------------------------------------------------------------
+
+    int compress(const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen)
+    {
+        uint32_t width = SLZW_MINCWLEN;
+        uint32_t code;
+        uint32_t match;
+        int32_t  slot;
+
+        olen       = 0;
+        resetCount = 0;
+        clearCount = 0;
+
+        bufPtr     = obuf;
+        bufLen     = obufLen;
+        bufIdx     = 0;
+        bitBuf     = 0;
+        bitCount   = 0;
+
+        winBytes   = 0;
+        winBits    = 0;
+        lastBits   = 0;
+
+        dictReset();
+
+        if (ilen == 0)
+        {
+            return SLZW_OK;
+        }
+
+        code = ibuf[0];
+
+        for (uint32_t idx = 1; idx < ilen; idx++)
+        {
+            uint8_t byte = ibuf[idx];
+
+            // Count input bytes consumed whilst frozen for the ratio monitor
+            if (adaptive && nextAvailCode == dictFull)
+            {
+                winBytes++;
+            }
+
+            // If the string plus the new byte is in the dictionary, carry on matching
+            if (dictFind(code, byte, match, slot))
+            {
+                code = match;
+                continue;
+            }
+
+            // No match, so output the code for the string matched so far
+            if (!putCode(code, width))
+            {
+                olen = bufIdx;
+                return SLZW_ERR_OVERFLOW;
+            }
+
+            // Build a new entry, or handle a full dictionary depending on policy
+            if (nextAvailCode != dictFull)
+            {
+                if (slot >= 0)
+                {
+                    dictAdd(code, byte, slot);
+                }
+                nextAvailCode++;
+            }
+            else if (!adaptive)
+            {
+                dictReset();
+                resetCount++;
+            }
+            else if (ratioCheck(width))
+            {
+                if (!putCode(SLZW_CLRCW, width))
+                {
+                    olen = bufIdx;
+                    return SLZW_ERR_OVERFLOW;
+                }
+
+                dictReset();
+                resetCount++;
+                clearCount++;
+            }
+
+            width = codeWidth(nextAvailCode);
+            code  = byte;
+        }
+
+        // Output the final code, and flush any remaining bits
+        if (!putCode(code, width) || !putCode(0, (8 - (bitCount & 7)) & 7))
+        {
+            olen = bufIdx;
+            return SLZW_ERR_OVERFLOW;
+        }
+
+        olen = bufIdx;
+
+        return SLZW_OK;
+    };
+
+    // ---------------------------------------------------------------------
+    // Decompress ilen bytes from ibuf into obuf (of obufLen bytes capacity).
+    // Number of bytes output returned in olen.
+    // ---------------------------------------------------------------------
+
+    int decompress(const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen)
+    {
+        uint32_t width = SLZW_MINCWLEN;
+        uint32_t nac   = firstCw;
+        int32_t  prev  = -1;
+        uint32_t code;
+
+        olen       = 0;
+        resetCount = 0;
+        clearCount = 0;
+
+        bufIn      = ibuf;
+        bufLen     = ilen;
+        bufIdx     = 0;
+        bitBuf     = 0;
+        bitCount   = 0;
+
+        while (getCode(code, width))
+        {
+            // A clear code resets the dictionary, and the next code starts afresh
+            if (adaptive && code == SLZW_CLRCW)
+            {
+                nac   = firstCw;
+                prev  = -1;
+                width = codeWidth(nac);
+                resetCount++;
+                clearCount++;
+                continue;
+            }
+
+            // First code after a reset is always a raw byte
+            if (prev < 0)
+            {
+                if (code > MAXBYTEVAL)
+                {
+                    return SLZW_ERR_BADCODE;
+                }
+
+                if (olen >= obufLen)
+                {
+                    return SLZW_ERR_OVERFLOW;
+                }
+
+                obuf[olen++] = code;
+                prev         = code;
+                width        = codeWidth(nextAvail(nac));
+                continue;
+            }
+
+            // A code equal to the next available is the special case of the
+            // string being the previous string plus its own first byte.
+            uint32_t cur = code;
+            bool     kwk = false;
+
+            if (code >= nac || (code > MAXBYTEVAL && code < firstCw))
+            {
+                if (code != nac || nac == dictFull)
+                {
+                    return SLZW_ERR_BADCODE;
+                }
+
+                kwk = true;
+                cur = prev;
+            }
+
+            // Unwind the string onto the stack, in reverse order
+            uint32_t sp = 0;
+            while (cur > MAXBYTEVAL)
+            {
+                stack[sp++] = suffix[cur];
+                cur         = prefix[cur];
+            }
+            stack[sp++] = cur;
+
+            uint8_t first = cur;
+
+            if ((olen + sp + (kwk ? 1 : 0)) > obufLen)
+            {
+                return SLZW_ERR_OVERFLOW;
+            }
+
+            while (sp)
+            {
+                obuf[olen++] = stack[--sp];
+            }
+
+            if (kwk)
+            {
+                obuf[olen++] = first;
+            }
+
+            // Build the entry one behind the compressor
+            if (nac != dictFull)
+            {
+                prefix[nac] = prev;
+                suffix[nac] = first;
+                nac++;
+            }
+            else if (!adaptive)
+            {
+                nac = firstCw;
+                resetCount++;
+            }
+
+            prev  = code;
+            width = codeWidth(nextAvail(nac));
+        }
+
+        return SLZW_OK;
+    };
+
+private:
+
+    static const uint32_t emptyKey   = 0xffffffff;
+    static const uint32_t MAXBYTEVAL = 0xff;
+
+    // ---------------------------------------------------------------------
+    // Dictionary memory size, folded to a constant when MEMSIZE is non-zero
+    // ---------------------------------------------------------------------
+
+    inline uint32_t memSize() const
+    {
+        return MEMSIZE ? MEMSIZE : memSizeRt;
+    };
+
+    // ---------------------------------------------------------------------
+    // Reset the dictionary state
+    // ---------------------------------------------------------------------
+
+    void dictReset()
+    {
+        for (uint32_t idx = 0; idx < memSize(); idx++)
+        {
+            hashKey[idx] = emptyKey;
+        }
+
+        for (uint32_t idx = 0; idx <= MAXBYTEVAL; idx++)
+        {
+            seedSkip[idx] = 0;
+        }
+
+        rehashed.clear();
+
+        nextAvailCode = firstCw;
+    };
+
+    // ---------------------------------------------------------------------
+    // Store a new dictionary entry at the slot found for it by dictFind()
+    // ---------------------------------------------------------------------
+
+    inline void dictAdd(const uint32_t code, const uint8_t byte, const int32_t slot)
+    {
+        const uint32_t key = (code << 8) | byte;
+
+        hashKey[slot]  = key;
+        hashCode[slot] = nextAvailCode;
+
+        if ((uint32_t)slot != HASH::calc(code, byte))
+        {
+            rehashed[key] = slot;
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // Look up a code/byte pair in the dictionary. If found, returns true with
+    // the dictionary code in match. If not found, returns false, with slot set
+    // to the first free location on the re-hash sequence, or -1 if none.
+    // Addresses beyond the memory size are treated as occupied, as for
+    // slzw_mem_occupied.
+    //
+    // Locations are only filled until the next reset, so an entry is always
+    // found where dictAdd() stored it, and a byte's re-hash seeds found
+    // occupied stay so. Rather than walking the re-hash sequence, entries
+    // stored off their first hash address are looked up in rehashed, and a
+    // free location is searched for from the first seed not yet found
+    // occupied. The result is the same as the full walk, which for data
+    // with many collisions would otherwise cover most of the seed space on
+    // every byte.
+    // ---------------------------------------------------------------------
+
+    inline bool dictFind(const uint32_t code, const uint8_t byte, uint32_t &match, int32_t &slot)
+    {
+        uint32_t key  = (code << 8) | byte;
+        uint32_t addr = HASH::calc(code, byte);
+
+        slot = -1;
+
+        if (addr < memSize())
+        {
+            if (hashKey[addr] == key)
+            {
+                match = hashCode[addr];
+                return true;
+            }
+
+            if (hashKey[addr] == emptyKey)
+            {
+                slot = addr;
+                return false;
+            }
+        }
+
+        if (!rehashed.empty())
+        {
+            auto entry = rehashed.find(key);
+
+            if (entry != rehashed.end())
+            {
+                match = hashCode[entry->second];
+                return true;
+            }
+        }
+
+        // Search on from the first seed not found occupied. If the seed space
+        // is exhausted, the dictionary is frozen for this entry.
+        for (uint32_t &seed = seedSkip[byte]; seed < maxSeed; seed++)
+        {
+            addr = HASH::calc(seed, byte);
+
+            if (addr < memSize() && hashKey[addr] == emptyKey)
+            {
+                slot = addr;
+                return false;
+            }
+        }
+
+        return false;
+    };
+
+    // ---------------------------------------------------------------------
+    // Return the codeword width for a given next available code value
+    // ---------------------------------------------------------------------
+
+    static inline uint32_t codeWidth(const uint32_t nac)
+    {
+        uint32_t width = 32 - __builtin_clz(nac - 1);
+
+        return (width < SLZW_MINCWLEN) ? SLZW_MINCWLEN : width;
+    };
+
+    // ---------------------------------------------------------------------
+    // Return the next available code after a dictionary build, for the
+    // given current next available code, accounting for the reset policy.
+    // ---------------------------------------------------------------------
+
+    static inline uint32_t nextAvail(const uint32_t nac)
+    {
+        if (nac != dictFull)
+        {
+            return nac + 1;
+        }
+
+        return adaptive ? nac : firstCw;
+    };
+
+    // ---------------------------------------------------------------------
+    // Ratio monitor, called for each codeword output whilst the dictionary
+    // is frozen. At the end of each window of checkGap input bytes, the
+    // output bits of the window are compared with those of the previous
+    // window. If greater, the ratio has degraded and true is returned.
+    // Matches slzw_ratio_mon in slzw_lib.v.
+    // ---------------------------------------------------------------------
+
+    inline bool ratioCheck(const uint32_t bitsOut)
+    {
+        bool degraded = false;
+
+        winBits += bitsOut;
+
+        if (winBytes >= checkGap)
+        {
+            degraded = (lastBits != 0) && (winBits > lastBits);
+            lastBits = degraded ? 0 : winBits;
+            winBytes = 0;
+            winBits  = 0;
+        }
+
+        return degraded;
+    };
+
+    // ---------------------------------------------------------------------
+    // Write a codeword to the output buffer
+    // ---------------------------------------------------------------------
+
+    inline bool putCode(const uint32_t code, const uint32_t width)
+    {
+        bitBuf   |= code << bitCount;
+        bitCount += width;
+
+        while (bitCount >= 8)
+        {
+            if (bufIdx >= bufLen)
+            {
+                return false;
+            }
+
+            bufPtr[bufIdx++] = bitBuf & 0xff;
+            bitBuf         >>= 8;
+            bitCount        -= 8;
+        }
+
+        return true;
+    };
+
+    // ---------------------------------------------------------------------
+    // Read a codeword from the input buffer. Returns false when there are
+    // insufficient bits remaining for a codeword of the given width.
+    // ---------------------------------------------------------------------
+
+    inline bool getCode(uint32_t &code, const uint32_t width)
+    {
+        while (bitCount < width)
+        {
+            if (bufIdx >= bufLen)
+            {
+                return false;
+            }
+
+            bitBuf   |= (uint32_t)bufIn[bufIdx++] << bitCount;
+            bitCount += 8;
+        }
+
+        code       = bitBuf & ((1U << width) - 1);
+        bitBuf   >>= width;
+        bitCount  -= width;
+
+        return true;
+    };
+
+    // Configuration
+    const uint32_t           memSizeRt;
+    const uint32_t           checkGap;
+
+    // Dictionary state
+    uint32_t                 nextAvailCode;
+    std::vector<uint32_t>    hashKey;
+    std::vector<uint16_t>    hashCode;
+    std::vector<uint16_t>    prefix;
+    std::vector<uint8_t>     suffix;
+    std::vector<uint8_t>     stack;
+
+    // Compression dictionary search state: entries stored off their first
+    // hash address, and the leading re-hash seeds of each byte value found
+    // occupied
+    std::unordered_map<uint32_t, uint32_t> rehashed;
+    uint32_t                 seedSkip[MAXBYTEVAL + 1];
+
+    // Ratio monitor state
+    uint32_t                 winBytes;
+    uint32_t                 winBits;
+    uint32_t                 lastBits;
+
+    // Bit stream state
+    uint8_t*                 bufPtr;
+    const uint8_t*           bufIn;
+    uint32_t                 bufLen;
+    uint32_t                 bufIdx;
+    uint32_t                 bitBuf;
+    uint32_t                 bitCount;
+};
+
+#endif
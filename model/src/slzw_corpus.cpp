@@ -0,0 +1,522 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW test corpus generator
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_corpus.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-12
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods for the codec test corpus generator.
+//
+//  Each generate() call restarts the pseudo random generator from the seed
+//  and the family, so that families are independent of each other and of
+//  the order they are generated in.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "slzw_corpus.h"
+#include "slzw_codec_t.h"
+
+// -------------------------------------------------------------------------
+// Local definitions
+// -------------------------------------------------------------------------
+
+static const char* typeNames[SLZW_CORPUS_NUM_TYPES] = {"counter", "text", "log", "struct", "random", "runs", "collide"};
+
+// English letter frequencies, per thousand, for vocabulary words
+static const char     letters[]     = "etaoinshrdlcumwfgypbvkjxqz";
+static const uint32_t letterFreq[]  = {127, 91, 82, 75, 70, 67, 63, 61, 60, 43, 40, 28, 28,
+                                        24, 24, 22, 20, 20, 19, 15, 10,  8,  2,  2,  1,  1};
+
+// Log line fields
+static const char*    logProcs[]    = {"slzwd", "kernel", "sshd", "cron", "systemd"};
+static const char*    logLevels[]   = {"INFO", "DEBUG", "WARN", "ERROR"};
+static const uint32_t logLevelPc[]  = {80, 10, 7, 3};
+static const uint32_t monthDays[]   = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+// Binary record tags
+static const char*    structTags[]  = {"sensor", "motor", "valve", "pump", "fan", "heater", "relay", "door"};
+
+// Collision data hash sampling, as 2^CWMAX codes is up to 64K per byte value
+#define HOT_BYTE_SAMPLES              4096
+
+// -------------------------------------------------------------------------
+// Number of sampled codes whose slzwHash address for a byte is beyond the
+// dictionary memory, and so is re-hashed
+// -------------------------------------------------------------------------
+
+template <unsigned CWMAX>
+static uint32_t rehashCount(const uint8_t byte, const uint32_t memSize)
+{
+    const uint32_t codes  = 1U << CWMAX;
+    const uint32_t stride = (codes > HOT_BYTE_SAMPLES) ? codes / HOT_BYTE_SAMPLES : 1;
+    uint32_t       count  = 0;
+
+    for (uint32_t code = 0; code < codes; code += stride)
+    {
+        count += (slzwHash<CWMAX>::calc(code, byte) >= memSize) ? 1 : 0;
+    }
+
+    return count;
+}
+
+// -------------------------------------------------------------------------
+// Constructor
+// -------------------------------------------------------------------------
+
+slzwCorpus::slzwCorpus(const uint64_t seedIn, const uint32_t maxCodeWidthIn, const uint32_t memSizeIn) :
+    seed(seedIn),
+    maxCodeWidth((maxCodeWidthIn < SLZW_MINCWLEN || maxCodeWidthIn > SLZW_MAXCWLIMIT) ? SLZW_DEFAULT_MAXCWLEN : maxCodeWidthIn),
+    memSize(memSizeIn ? memSizeIn : (5 << maxCodeWidth) / 2),
+    state(seedIn),
+    haveHotBytes(false)
+{
+    // Zipfian weights 1/rank, exponent 1 to avoid pow(), accumulated with
+    // the correctly rounded divide so that all hosts agree
+    double total = 0.0;
+    double sum   = 0.0;
+
+    zipfCdf.resize(SLZW_CORPUS_VOCAB_SIZE);
+
+    for (uint32_t rank = 0; rank < SLZW_CORPUS_VOCAB_SIZE; rank++)
+    {
+        total += 1.0 / (rank + 1);
+    }
+
+
+    for (uint32_t rank = 0; rank < SLZW_CORPUS_VOCAB_SIZE; rank++)
+    {
+        sum           += 1.0 / (rank + 1);
+        zipfCdf[rank]  = (uint64_t)(sum / total * (double)(1ULL << 53));
+    }
+
+    zipfCdf[SLZW_CORPUS_VOCAB_SIZE - 1] = 1ULL << 53;
+}
+
+// -------------------------------------------------------------------------
+// Family names
+// -------------------------------------------------------------------------
+
+const char* slzwCorpus::name(const slzwCorpusType_t type)
+{
+    return (type < SLZW_CORPUS_NUM_TYPES) ? typeNames[type] : "unknown";
+}
+
+int slzwCorpus::lookup(const char* str)
+{
+    for (int type = 0; type < SLZW_CORPUS_NUM_TYPES; type++)
+    {
+        if (strcmp(str, typeNames[type]) == 0)
+        {
+            return type;
+        }
+    }
+
+    return -1;
+}
+
+// -------------------------------------------------------------------------
+// Generate len bytes of a family's data
+// -------------------------------------------------------------------------
+
+void slzwCorpus::generate(const slzwCorpusType_t type, uint8_t* buf, const uint32_t len)
+{
+    out_t o = {buf, len, 0};
+
+    state = seed ^ ((uint64_t)(type + 1) << 56);
+
+    switch (type)
+    {
+    case SLZW_CORPUS_COUNTER: counter(o);  break;
+    case SLZW_CORPUS_TEXT:    text(o);     break;
+    case SLZW_CORPUS_LOG:     logLines(o); break;
+    case SLZW_CORPUS_STRUCT:  structs(o);  break;
+    case SLZW_CORPUS_RANDOM:  random(o);   break;
+    case SLZW_CORPUS_RUNS:    runs(o);     break;
+    case SLZW_CORPUS_COLLIDE: collide(o);  break;
+    default:                  memset(buf, 0, len); break;
+    }
+}
+
+// -------------------------------------------------------------------------
+// Append bytes to the output, truncated at its end
+// -------------------------------------------------------------------------
+
+bool slzwCorpus::put(out_t &o, const void* data, const uint32_t len)
+{
+    const uint32_t bytes = (len < (o.len - o.idx)) ? len : (o.len - o.idx);
+
+    memcpy(o.buf + o.idx, data, bytes);
+    o.idx += bytes;
+
+    return o.idx < o.len;
+}
+
+// -------------------------------------------------------------------------
+// splitmix64 pseudo random generator
+// -------------------------------------------------------------------------
+
+uint64_t slzwCorpus::next()
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+}
+
+uint32_t slzwCorpus::below(const uint32_t n)
+{
+    return (uint32_t)(((next() >> 32) * n) >> 32);
+}
+
+// -------------------------------------------------------------------------
+// Zipfian rank, by binary search of the cumulative weights
+// -------------------------------------------------------------------------
+
+uint32_t slzwCorpus::zipf()
+{
+    const uint64_t u  = next() >> 11;
+    uint32_t       lo = 0;
+    uint32_t       hi = SLZW_CORPUS_VOCAB_SIZE - 1;
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+
+        if (zipfCdf[mid] > u)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return lo;
+}
+
+// -------------------------------------------------------------------------
+// Incrementing little endian words, starting from the seed's offset from
+// the default seed, so that the default gives the original test data
+// -------------------------------------------------------------------------
+
+void slzwCorpus::counter(out_t &o)
+{
+    const uint32_t start = (uint32_t)(seed - SLZW_CORPUS_DEFAULT_SEED);
+
+    for (uint32_t idx = 0; idx < o.len; idx++)
+    {
+        o.buf[idx] = ((start + idx/4) >> ((idx & 3) * 8)) & 0xff;
+    }
+}
+
+// -------------------------------------------------------------------------
+// Sentences of Zipfian distributed words, in paragraphs. Shorter words are
+// given to the more frequent ranks.
+// -------------------------------------------------------------------------
+
+void slzwCorpus::text(out_t &o)
+{
+    std::vector<std::string> vocab(SLZW_CORPUS_VOCAB_SIZE);
+    uint32_t                 freqTotal = 0;
+
+    for (uint32_t idx = 0; idx < sizeof(letterFreq)/sizeof(letterFreq[0]); idx++)
+    {
+        freqTotal += letterFreq[idx];
+    }
+
+    for (uint32_t rank = 0; rank < SLZW_CORPUS_VOCAB_SIZE; rank++)
+    {
+        const uint32_t wordLen = 1 + below(2 + (32 - __builtin_clz(rank + 1)) / 2);
+
+        for (uint32_t chr = 0; chr < wordLen; chr++)
+        {
+            uint32_t pick = below(freqTotal);
+            uint32_t idx  = 0;
+
+            while (pick >= letterFreq[idx])
+            {
+                pick -= letterFreq[idx++];
+            }
+
+            vocab[rank] += letters[idx];
+        }
+    }
+
+    while (true)
+    {
+        const uint32_t sentences = 3 + below(8);
+
+        for (uint32_t sentence = 0; sentence < sentences; sentence++)
+        {
+            const uint32_t words = 4 + below(16);
+
+            for (uint32_t word = 0; word < words; word++)
+            {
+                std::string w = vocab[zipf()];
+
+                if (word == 0)
+                {
+                    w[0] = w[0] - 'a' + 'A';
+                }
+
+                w += (word == words - 1) ? ". " : (below(10) == 0) ? ", " : " ";
+
+                if (!put(o, w.data(), w.size()))
+                {
+                    return;
+                }
+            }
+        }
+
+        if (!put(o, "\n\n", 2))
+        {
+            return;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// Log lines, from 2022-03-01, with a timestamp, host, process, level and
+// message from a template with numeric fields
+// -------------------------------------------------------------------------
+
+void slzwCorpus::logLines(out_t &o)
+{
+    const uint32_t numProcs = sizeof(logProcs)/sizeof(logProcs[0]);
+    uint32_t       pids[numProcs];
+    uint64_t       ms       = 0;
+    uint32_t       jobId    = 0;
+    char           line[256];
+
+    for (uint32_t idx = 0; idx < numProcs; idx++)
+    {
+        pids[idx] = 100 + below(30000);
+    }
+
+    while (true)
+    {
+        ms += below(below(2) ? 50 : 5000);
+
+        // Date from the day count, for a non-leap year starting in March
+        uint32_t day   = (uint32_t)(ms / 86400000ULL);
+        uint32_t month = 2;
+
+        while (day >= monthDays[month % 12])
+        {
+            day -= monthDays[month % 12];
+            month++;
+        }
+
+        const uint32_t msOfDay = (uint32_t)(ms % 86400000ULL);
+        const uint32_t proc    = below(4) ? 0 : below(numProcs);
+        uint32_t       pick    = below(100);
+        uint32_t       level   = 0;
+
+        while (pick >= logLevelPc[level])
+        {
+            pick -= logLevelPc[level++];
+        }
+
+        int n = snprintf(line, sizeof(line), "2022-%02u-%02u %02u:%02u:%02u.%03u node%02u %s[%u]: %s ",
+                         month % 12 + 1, day + 1, msOfDay / 3600000, (msOfDay / 60000) % 60, (msOfDay / 1000) % 60,
+                         msOfDay % 1000, below(8), logProcs[proc], pids[proc], logLevels[level]);
+
+        switch (below(5))
+        {
+        case 0:
+            n += snprintf(line + n, sizeof(line) - n, "job %u done len=%u out=%u us=%u\n",
+                          jobId++, below(1 << 20), below(1 << 20), below(100000));
+            break;
+        case 1:
+            n += snprintf(line + n, sizeof(line) - n, "client %u attached to slot %u\n", below(1000), below(8));
+            break;
+        case 2:
+            n += snprintf(line + n, sizeof(line) - n, "connection from 192.168.%u.%u port %u\n",
+                          below(4), below(256), 1024 + below(64000));
+            break;
+        case 3:
+            n += snprintf(line + n, sizeof(line) - n, "retrying request %u after %u ms\n", below(100000), 1 << below(12));
+            break;
+        default:
+            n += snprintf(line + n, sizeof(line) - n, "checksum mismatch in frame %u of %u\n", below(64), 64);
+            break;
+        }
+
+        if (!put(o, line, n))
+        {
+            return;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// 32 byte little endian records: sequence number, timestamp, type, flags,
+// value (a random walk), device ID, tag, and padding
+// -------------------------------------------------------------------------
+
+void slzwCorpus::structs(out_t &o)
+{
+    const uint32_t numTags = sizeof(structTags)/sizeof(structTags[0]);
+    uint32_t       time    = 0;
+    int32_t        value   = 0;
+
+    for (uint32_t seq = 0; ; seq++)
+    {
+        uint8_t  rec[32] = {0};
+        uint32_t type    = below(4) ? below(2) : below(8);
+        uint32_t flags   = below(16) ? 0x0001 : (below(0x10000) | 0x0001);
+        uint32_t devId   = 0x1000 + below(16);
+
+        time  += below(100);
+        value += (int32_t)below(33) - 16;
+
+        for (uint32_t byte = 0; byte < 4; byte++)
+        {
+            rec[0  + byte] = (seq   >> (8 * byte)) & 0xff;
+            rec[4  + byte] = (time  >> (8 * byte)) & 0xff;
+            rec[12 + byte] = ((uint32_t)value >> (8 * byte)) & 0xff;
+            rec[16 + byte] = (devId >> (8 * byte)) & 0xff;
+        }
+
+        rec[8]  = type & 0xff;
+        rec[9]  = type >> 8;
+        rec[10] = flags & 0xff;
+        rec[11] = flags >> 8;
+
+        strncpy((char*)&rec[20], structTags[devId % numTags], 8);
+
+        if (!put(o, rec, sizeof(rec)))
+        {
+            return;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// Uniform random bytes
+// -------------------------------------------------------------------------
+
+void slzwCorpus::random(out_t &o)
+{
+    while (o.idx < o.len)
+    {
+        uint64_t word = next();
+
+        if (!put(o, &word, sizeof(word)))
+        {
+            return;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// Runs of a byte, half of them zero, of log uniform length 1 to 4096
+// -------------------------------------------------------------------------
+
+void slzwCorpus::runs(out_t &o)
+{
+    uint8_t run[4096];
+
+    while (true)
+    {
+        const uint32_t scale = 1U << below(12);
+        const uint32_t len   = scale + below(scale);
+        const uint8_t  byte  = below(2) ? 0 : (uint8_t)below(256);
+
+        memset(run, byte, len);
+
+        if (!put(o, run, len))
+        {
+            return;
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// Random strings of the byte values whose dictionary entries are most often
+// re-hashed. Entries for the same byte share a re-hash sequence, so a small
+// alphabet of them gives long re-hash searches as the dictionary fills.
+// -------------------------------------------------------------------------
+
+void slzwCorpus::collide(out_t &o)
+{
+    if (!haveHotBytes)
+    {
+        findHotBytes();
+    }
+
+    while (o.idx < o.len)
+    {
+        o.buf[o.idx++] = hotBytes[below(SLZW_CORPUS_HOT_BYTES)];
+    }
+}
+
+// -------------------------------------------------------------------------
+// Find the byte values with the most sampled codes hashing beyond the
+// dictionary memory, for the configured code width
+// -------------------------------------------------------------------------
+
+void slzwCorpus::findHotBytes()
+{
+    uint32_t counts[256];
+
+    for (uint32_t byte = 0; byte < 256; byte++)
+    {
+        switch (maxCodeWidth)
+        {
+        case  9: counts[byte] = rehashCount< 9>(byte, memSize); break;
+        case 10: counts[byte] = rehashCount<10>(byte, memSize); break;
+        case 11: counts[byte] = rehashCount<11>(byte, memSize); break;
+        case 12: counts[byte] = rehashCount<12>(byte, memSize); break;
+        case 13: counts[byte] = rehashCount<13>(byte, memSize); break;
+        case 14: counts[byte] = rehashCount<14>(byte, memSize); break;
+        case 15: counts[byte] = rehashCount<15>(byte, memSize); break;
+        default: counts[byte] = rehashCount<16>(byte, memSize); break;
+        }
+    }
+
+    // Pick the highest counts, the lowest byte value first on a tie
+    for (uint32_t hot = 0; hot < SLZW_CORPUS_HOT_BYTES; hot++)
+    {
+        uint32_t best = 0;
+
+        for (uint32_t byte = 1; byte < 256; byte++)
+        {
+            if (counts[byte] > counts[best])
+            {
+                best = byte;
+            }
+        }
+
+        hotBytes[hot] = best;
+        counts[best]  = 0;
+    }
+
+    haveHotBytes = true;
+}
@@ -0,0 +1,141 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW test corpus generator header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_corpus.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-12
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definition for generating codec test data
+//  in families of different shapes, shared by the simulation test code, the
+//  platform programs and the model tools.
+//
+//  Data is generated from a seed with its own pseudo random generator, and
+//  with no floating point library calls, so that a family, seed and length
+//  give the same bytes on any host. A family's data for a given seed is a
+//  single stream, so that shorter lengths are prefixes of longer ones.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_CORPUS_H_
+#define _SLZW_CORPUS_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+#include <vector>
+
+#include "slzw_model.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define SLZW_CORPUS_DEFAULT_SEED  1
+
+// Text vocabulary size, and the number of byte values used for hash
+// collision data
+#define SLZW_CORPUS_VOCAB_SIZE    2048
+#define SLZW_CORPUS_HOT_BYTES     4
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef enum {
+    SLZW_CORPUS_COUNTER       = 0,  // Little endian incrementing words, from seed - 1 (from 0, the
+                                    // original test data, for the default seed)
+    SLZW_CORPUS_TEXT          = 1,  // Words from a vocabulary, with Zipfian (exponent 1) frequencies
+    SLZW_CORPUS_LOG           = 2,  // Timestamped log lines from message templates
+    SLZW_CORPUS_STRUCT        = 3,  // Little endian binary records
+    SLZW_CORPUS_RANDOM        = 4,  // Uniform random bytes
+    SLZW_CORPUS_RUNS          = 5,  // Runs of repeated bytes, of log uniform lengths
+    SLZW_CORPUS_COLLIDE       = 6,  // Random strings of the bytes whose slzwHash addresses most
+                                    // often fall outside the dictionary memory, so forcing re-hashes
+    SLZW_CORPUS_NUM_TYPES     = 7
+} slzwCorpusType_t;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITION
+// -------------------------------------------------------------------------
+
+class slzwCorpus
+{
+public:
+    // Constructor. The collision data is for a dictionary of the given
+    // maximum code width and memory size (0 for the nominal size).
+    slzwCorpus(const uint64_t seed         = SLZW_CORPUS_DEFAULT_SEED,
+               const uint32_t maxCodeWidth = SLZW_DEFAULT_MAXCWLEN,
+               const uint32_t memSize      = 0);
+
+    // Fill len bytes of buf with data of a family
+    void     generate (const slzwCorpusType_t type, uint8_t* buf, const uint32_t len);
+    void     generate (const slzwCorpusType_t type, std::vector<uint8_t> &buf, const uint32_t len)
+                      { buf.resize(len); generate(type, buf.data(), len); };
+
+    // Family names, as used on command lines, and lookup by name (-1 if unknown)
+    static const char* name   (const slzwCorpusType_t type);
+    static int         lookup (const char* name);
+
+private:
+
+    // Output state for the family generators, which append to the buffer
+    // until it is full
+    typedef struct {
+        uint8_t*     buf;
+        uint32_t     len;
+        uint32_t     idx;
+    } out_t;
+
+    void     counter  (out_t &o);
+    void     text     (out_t &o);
+    void     logLines (out_t &o);
+    void     structs  (out_t &o);
+    void     random   (out_t &o);
+    void     runs     (out_t &o);
+    void     collide  (out_t &o);
+
+    // Append bytes, returning false once the buffer is full
+    static bool put   (out_t &o, const void* data, const uint32_t len);
+
+    // Pseudo random numbers (splitmix64), and uniform values below n
+    uint64_t next     ();
+    uint32_t below    (const uint32_t n);
+
+    // Zipfian rank below the vocabulary size
+    uint32_t zipf     ();
+
+    // Find the byte values for the collision data
+    void     findHotBytes ();
+
+    const uint64_t        seed;
+    const uint32_t        maxCodeWidth;
+    const uint32_t        memSize;
+    uint64_t              state;
+
+    std::vector<uint64_t> zipfCdf;      // Cumulative rank weights, scaled to 2^53
+    uint8_t               hotBytes[SLZW_CORPUS_HOT_BYTES];
+    bool                  haveHotBytes;
+};
+
+#endif
@@ -0,0 +1,232 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW test corpus generator command line program
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_corpus_gen.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-12
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the top level code for a command line program to
+//  write a family of slzwCorpus test data to a file, for use as golden
+//  input data on the platform or with the model program.
+//
+//  A report option (-r) instead compresses each family (or just the one
+//  selected with -g) with the SLZW reference model, and reports the
+//  compression ratio, model throughput and dictionary resets, with a check
+//  that the data decompresses back.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <unistd.h>
+
+#include "slzw_model.h"
+#include "slzw_corpus.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+#define DEFAULT_LENGTH            (1024*1024)
+
+// --------------------------------------------------
+// Monotonic time in seconds
+// --------------------------------------------------
+
+static double timeSecs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// --------------------------------------------------
+// Compress and decompress a family's data with the
+// model, and report ratio, throughput and resets
+// --------------------------------------------------
+
+static int reportFamily(slzwCorpus &corpus, const slzwCorpusType_t type, const uint32_t len, const slzwConfig_t &cfg)
+{
+    std::vector<uint8_t> ibuf;
+    std::vector<uint8_t> obuf(len * 2 + 16);
+    std::vector<uint8_t> dbuf(len);
+    uint32_t             olen;
+    uint32_t             dlen;
+    slzwModel            model(&cfg);
+
+    corpus.generate(type, ibuf, len);
+
+    double start = timeSecs();
+
+    if (model.compress(ibuf.data(), len, obuf.data(), obuf.size(), olen) != SLZW_OK)
+    {
+        fprintf(stderr, "*** reportFamily(): compression of %s data failed\n", slzwCorpus::name(type));
+        return USER_ERROR;
+    }
+
+    double   secs   = timeSecs() - start;
+    uint32_t resets = model.getResetCount();
+
+    if (model.decompress(obuf.data(), olen, dbuf.data(), dbuf.size(), dlen) != SLZW_OK ||
+        dlen != len || memcmp(ibuf.data(), dbuf.data(), len) != 0)
+    {
+        fprintf(stderr, "*** reportFamily(): %s data did not decompress back\n", slzwCorpus::name(type));
+        return USER_ERROR;
+    }
+
+    printf("%-8s  %9d  %9d  %7.3f  %7.1f  %6d\n", slzwCorpus::name(type), len, olen,
+           olen ? (double)len/(double)olen : 0.0, secs > 0.0 ? len / secs / 1e6 : 0.0, resets);
+
+    return 0;
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    int          c;
+    int          type     = -1;
+    bool         report   = false;
+    uint32_t     len      = DEFAULT_LENGTH;
+    uint64_t     seed     = SLZW_CORPUS_DEFAULT_SEED;
+    const char*  ofname   = NULL;
+    slzwConfig_t cfg;
+
+    cfg.policy            = SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth      = SLZW_DEFAULT_MAXCWLEN;
+    cfg.memSize           = 0;
+    cfg.checkGap          = SLZW_DEFAULT_CHECKGAP;
+
+    while ((c = getopt(argc, argv, "hrg:l:s:w:m:o:")) != -1)
+    {
+        switch (c)
+        {
+        case 'r':
+            report           = true;
+            break;
+        case 'g':
+            if ((type = slzwCorpus::lookup(optarg)) < 0)
+            {
+                fprintf(stderr, "*** main(): unknown data family %s\n", optarg);
+                return USER_ERROR;
+            }
+            break;
+        case 'l':
+            len              = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed             = strtoull(optarg, NULL, 0);
+            break;
+        case 'w':
+            cfg.maxCodeWidth = strtol(optarg, NULL, 0);
+            break;
+        case 'm':
+            cfg.memSize      = strtol(optarg, NULL, 0);
+            break;
+        case 'o':
+            ofname           = optarg;
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-r] [-g <family>] [-l <bytes>] [-s <seed>] [-w <width>] [-m <size>] [-o <outfile>]\n", argv[0]);
+            printf("         -r Report model compression of each family (or of -g family)\n");
+            printf("         -g Data family:");
+            for (int idx = 0; idx < SLZW_CORPUS_NUM_TYPES; idx++)
+            {
+                printf(" %s", slzwCorpus::name((slzwCorpusType_t)idx));
+            }
+            printf("\n");
+            printf("         -l Data length in bytes (default %d)\n", DEFAULT_LENGTH);
+            printf("         -s Seed (default %d)\n", SLZW_CORPUS_DEFAULT_SEED);
+            printf("         -w Maximum code width, for collide data and -r (default %d)\n", SLZW_DEFAULT_MAXCWLEN);
+            printf("         -m Dictionary memory size, for collide data and -r (default 2.5 x 2^width)\n");
+            printf("         -o Output file, when not reporting\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    if (cfg.maxCodeWidth < SLZW_MINCWLEN || cfg.maxCodeWidth > SLZW_MAXCWLIMIT)
+    {
+        fprintf(stderr, "*** main(): maximum code width must be %d to %d\n", SLZW_MINCWLEN, SLZW_MAXCWLIMIT);
+        return USER_ERROR;
+    }
+
+    slzwCorpus corpus(seed, cfg.maxCodeWidth, cfg.memSize);
+
+    if (report)
+    {
+        printf("Family        Bytes  Out bytes    Ratio     MB/s  Resets\n");
+
+        for (int idx = 0; idx < SLZW_CORPUS_NUM_TYPES; idx++)
+        {
+            if ((type < 0 || type == idx) && reportFamily(corpus, (slzwCorpusType_t)idx, len, cfg))
+            {
+                return USER_ERROR;
+            }
+        }
+
+        return 0;
+    }
+
+    if (type < 0 || ofname == NULL)
+    {
+        fprintf(stderr, "*** main(): a data family and output file are needed when not reporting\n");
+        return USER_ERROR;
+    }
+
+    std::vector<uint8_t> buf;
+    FILE*                fp;
+
+    corpus.generate((slzwCorpusType_t)type, buf, len);
+
+    if ((fp = fopen(ofname, "wb")) == NULL)
+    {
+        fprintf(stderr, "*** main(): Unable to open file %s for writing\n", ofname);
+        return USER_ERROR;
+    }
+
+    if (len && fwrite(buf.data(), 1, len, fp) != len)
+    {
+        fprintf(stderr, "*** main(): Error writing file %s\n", ofname);
+        fclose(fp);
+        return USER_ERROR;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
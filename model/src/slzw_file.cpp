@@ -0,0 +1,67 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW file utilities
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_file.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the file utility functions shared by the model tools
+//  and the simulation test code.
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+
+#include "slzw_file.h"
+
+// --------------------------------------------------
+// Read a whole file into a buffer
+// --------------------------------------------------
+
+int readFile(const char* filename, std::vector<uint8_t> &buf)
+{
+    FILE* fp;
+
+    if ((fp = fopen(filename, "rb")) == NULL)
+    {
+        fprintf(stderr, "*** readFile(): Unable to open file %s for reading\n", filename);
+        return 1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    buf.resize(len);
+
+    if (len && fread(buf.data(), 1, len, fp) != (size_t)len)
+    {
+        fprintf(stderr, "*** readFile(): Error reading file %s\n", filename);
+        fclose(fp);
+        return 1;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW file utilities header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_file.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the declarations of the file utility functions shared
+//  by the model tools and the simulation test code.
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_FILE_H_
+#define _SLZW_FILE_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+// -------------------------------------------------------------------------
+
+// Read a whole file into buf, returning non-zero, with an error message,
+// if the file can't be opened or read
+extern int readFile (const char* filename, std::vector<uint8_t> &buf);
+
+#endif
@@ -0,0 +1,100 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW framed file format
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_frame.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-09
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definitions for the framed file format written
+//  and read by the slzw command line compressor.
+//
+//  A file is a header, followed by a frame for each chunk of the input, and
+//  an end frame with zero lengths. Each frame is a frame header followed by
+//  its data, SLZW compressed with the file's codec parameters, unless
+//  compression does not reduce the chunk's size, when it is stored raw.
+//  Chunks are compressed independently (the dictionary starts afresh), so
+//  frames can be processed in parallel. The checksum is the CRC-32 of the
+//  chunk's uncompressed data.
+//
+//  From version 2, the end frame is followed by a block index, with an
+//  entry for each frame, and a trailer at the very end of the file giving
+//  the index's location. As every frame but the last holds chunkSize bytes
+//  of uncompressed data, a reader can go straight to the frames covering
+//  a byte range, without decoding from the start (see slzw_archive.h).
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_FRAME_H_
+#define _SLZW_FRAME_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define SLZW_FRM_MAGIC            0x465a4c53  // "SLZF"
+#define SLZW_FRM_VERSION          2           // Version 1 files have no block index
+#define SLZW_FRM_IDX_MAGIC        0x58494c53  // "SLIX"
+
+// Frame flags
+#define SLZW_FRM_RAW              0x00000001  // Data stored uncompressed
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t maxCodeWidth;          // Codec CWMAX the file was compressed with
+    uint32_t resetPolicy;           // Codec dictionary reset policy
+    uint32_t chunkSize;             // Maximum uncompressed bytes per frame
+} slzwFrmHdr_t;
+
+typedef struct {
+    uint32_t rawLen;                // Uncompressed size (0 for the end frame)
+    uint32_t dataLen;               // Stored data size
+    uint32_t flags;
+    uint32_t checksum;              // CRC-32 of the uncompressed data
+} slzwFrm_t;
+
+// Block index entry, with the frame's header fields
+typedef struct {
+    uint64_t offset;                // File offset of the frame's data
+    uint32_t rawLen;
+    uint32_t dataLen;
+    uint32_t flags;
+    uint32_t checksum;
+} slzwFrmIdx_t;
+
+typedef struct {
+    uint32_t magic;                 // SLZW_FRM_IDX_MAGIC
+    uint32_t numBlocks;             // Index entries (frames, excluding the end frame)
+    uint64_t indexOffset;           // File offset of the first index entry
+} slzwFrmTrailer_t;
+
+#endif
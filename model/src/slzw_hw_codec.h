@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW hardware build codec specialisations
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_hw_codec.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-24
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the codec specialisations for the supported hardware
+//  builds of slzw_codec. Each build has an slzwHwBuild specialisation giving
+//  its maximum codeword width and dictionary memory size. The active build is
+//  selected from the core parameters in core_params_auto.h, generated from
+//  the core's QSYS Tcl file (core_hw.tcl), so that a parameter change in the
+//  hardware without a matching software specialisation fails to compile.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_HW_CODEC_H_
+#define _SLZW_HW_CODEC_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include "slzw_codec_t.h"
+#include "core_params_auto.h"
+
+// -------------------------------------------------------------------------
+// Supported hardware builds. The primary template is deliberately left
+// without codec definitions, so an unsupported build is a compile error.
+// -------------------------------------------------------------------------
+
+template <unsigned CWMAX, unsigned MEMSIZE>
+struct slzwHwBuild
+{
+    static const bool supported = false;
+};
+
+#define SLZW_HW_BUILD(_cw, _memsize)                                                           \
+template <>                                                                                    \
+struct slzwHwBuild<_cw, _memsize>                                                              \
+{                                                                                              \
+    static const bool supported = true;                                                        \
+    typedef slzwCodecT<_cw, _memsize, slzwHash<_cw>, slzwResetOnFull>   codecResetOnFull;      \
+    typedef slzwCodecT<_cw, _memsize, slzwHash<_cw>, slzwResetAdaptive> codecAdaptive;         \
+}
+
+// Nominal dictionary sizes of 2.5 x 2^CWMAX
+SLZW_HW_BUILD(10,   2560);
+SLZW_HW_BUILD(12,  10240);
+SLZW_HW_BUILD(14,  40960);
+SLZW_HW_BUILD(16, 163840);
+
+// -------------------------------------------------------------------------
+// Active hardware build, checked against the generated core parameters
+// -------------------------------------------------------------------------
+
+typedef slzwHwBuild<CORE_PARAM_CWMAX, CORE_PARAM_MEMSIZE> slzwHwBuild_t;
+
+static_assert(slzwHwBuild_t::supported,
+              "slzw_hw_codec.h: no codec specialisation for core_hw.tcl CWMAX/MEMSIZE parameters");
+
+typedef slzwHwBuild_t::codecResetOnFull slzwHwCodec;
+typedef slzwHwBuild_t::codecAdaptive    slzwHwCodecAdaptive;
+
+#endif
@@ -0,0 +1,82 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW compressed program image format
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_image.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-27
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definitions for the compressed program image
+//  format, produced by the slzwpack tool from an ELF executable, and loaded
+//  on the platform by load_slzw_image().
+//
+//  An image is a header, followed by a table of segment descriptors, and
+//  then each segment's data. Segment data is SLZW compressed with the
+//  image's codec parameters, unless compression does not reduce its size,
+//  when it is stored raw. Segment data starts on a word boundary, as
+//  required by the codec's AXI master.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_IMAGE_H_
+#define _SLZW_IMAGE_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define SLZW_IMG_MAGIC            0x495a4c53  // "SLZI"
+#define SLZW_IMG_VERSION          1
+
+#define SLZW_IMG_MAX_SEGS         16
+
+// Segment flags
+#define SLZW_IMG_SEG_RAW          0x00000001  // Data stored uncompressed
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numSegs;
+    uint32_t entry;                 // ELF entry point
+    uint32_t maxCodeWidth;          // Codec CWMAX the image was packed for
+    uint32_t resetPolicy;           // Codec dictionary reset policy
+} slzwImgHdr_t;
+
+typedef struct {
+    uint32_t vaddr;                 // Load address
+    uint32_t memSize;               // Memory footprint (rawSize plus .bss)
+    uint32_t rawSize;               // Uncompressed data size
+    uint32_t offset;                // Data offset in image file (word aligned)
+    uint32_t dataSize;              // Stored data size
+    uint32_t flags;
+} slzwImgSeg_t;
+
+#endif
@@ -0,0 +1,251 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW C++ reference model
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_model.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-02-21
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods for the C++ reference model of the SLZW
+//  codec.
+//
+//  Codewords are packed into the output stream least significant bit first,
+//  starting at 9 bits and growing to maxCodeWidth bits (12 by default, as
+//  for the slzw_dict CWMAX parameter) as the dictionary fills. The
+//  dictionary is a hash table of memSize entries, using the same hash and
+//  re-hash seed sequence as slzw_dict.v. When no free location is found
+//  the entry is not stored, but the code is still consumed, so that the
+//  decompressor's dictionary remains in step.
+//
+//  Two reset policies are supported. For SLZW_RESET_ON_FULL (the default) the
+//  dictionary resets itself when full, with no codeword issued. For
+//  SLZW_RESET_ADAPTIVE the dictionary freezes when full, and the number of
+//  output bits for each window of checkGap input bytes is monitored. When a
+//  window produces more bits than the previous one, the clear codeword
+//  (SLZW_CLRCW) is issued and the dictionary reset.
+//
+//  The compress and decompress loops are in the slzwCodecT template
+//  (slzw_codec_t.h). The model instantiates the specialisation for the
+//  configured width and policy once, on construction.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdint>
+
+#include "slzw_model.h"
+#include "slzw_codec_t.h"
+
+// -------------------------------------------------------------------------
+// Create a codec specialisation for a given width, selecting on policy.
+// The memory size is left as a runtime value.
+// -------------------------------------------------------------------------
+
+template <unsigned CWMAX>
+static slzwCodecBase* createCodec(const slzwConfig_t &cfg)
+{
+    if (cfg.policy == SLZW_RESET_ADAPTIVE)
+    {
+        return new slzwCodecT<CWMAX, 0, slzwHash<CWMAX>, slzwResetAdaptive>(cfg.memSize, cfg.checkGap);
+    }
+
+    return new slzwCodecT<CWMAX, 0, slzwHash<CWMAX>, slzwResetOnFull>(cfg.memSize, cfg.checkGap);
+}
+
+// -------------------------------------------------------------------------
+// Constructor
+// -------------------------------------------------------------------------
+
+slzwModel::slzwModel(const slzwConfig_t* cfgIn) : codec(NULL), csumType(SLZW_CSUM_NONE), csum(0)
+{
+    if (cfgIn == NULL)
+    {
+        cfg.policy       = SLZW_RESET_ON_FULL;
+        cfg.maxCodeWidth = SLZW_DEFAULT_MAXCWLEN;
+        cfg.memSize      = SLZW_DEFAULT_MEMSIZE;
+        cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+    }
+    else
+    {
+        cfg = *cfgIn;
+    }
+
+    if (cfg.maxCodeWidth < SLZW_MINCWLEN || cfg.maxCodeWidth > SLZW_MAXCWLIMIT)
+    {
+        fprintf(stderr, "*** slzwModel(): invalid maximum code width %d\n", cfg.maxCodeWidth);
+        cfg.maxCodeWidth = SLZW_DEFAULT_MAXCWLEN;
+        return;
+    }
+
+    if (cfg.memSize == 0)
+    {
+        cfg.memSize = (5 << cfg.maxCodeWidth) / 2;
+    }
+
+    switch (cfg.maxCodeWidth)
+    {
+    case  9: codec = createCodec< 9>(cfg); break;
+    case 10: codec = createCodec<10>(cfg); break;
+    case 11: codec = createCodec<11>(cfg); break;
+    case 12: codec = createCodec<12>(cfg); break;
+    case 13: codec = createCodec<13>(cfg); break;
+    case 14: codec = createCodec<14>(cfg); break;
+    case 15: codec = createCodec<15>(cfg); break;
+    case 16: codec = createCodec<16>(cfg); break;
+    }
+}
+
+// -------------------------------------------------------------------------
+// Destructor
+// -------------------------------------------------------------------------
+
+slzwModel::~slzwModel()
+{
+    delete codec;
+}
+
+// -------------------------------------------------------------------------
+// Compress
+// -------------------------------------------------------------------------
+
+int slzwModel::compress(const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen)
+{
+    olen = 0;
+
+    if (codec == NULL)
+    {
+        return SLZW_ERR_CONFIG;
+    }
+
+    int status = codec->compress(ibuf, ilen, obuf, obufLen, olen);
+
+    calcChecksum(ibuf, ilen);
+
+    return status;
+}
+
+// -------------------------------------------------------------------------
+// Decompress
+// -------------------------------------------------------------------------
+
+int slzwModel::decompress(const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen)
+{
+    olen = 0;
+
+    if (codec == NULL)
+    {
+        return SLZW_ERR_CONFIG;
+    }
+
+    int status = codec->decompress(ibuf, ilen, obuf, obufLen, olen);
+
+    calcChecksum(obuf, olen);
+
+    return status;
+}
+
+// -------------------------------------------------------------------------
+// Statistics for the last operation
+// -------------------------------------------------------------------------
+
+uint32_t slzwModel::getResetCount()
+{
+    return codec ? codec->getResetCount() : 0;
+}
+
+uint32_t slzwModel::getClearCount()
+{
+    return codec ? codec->getClearCount() : 0;
+}
+
+// -------------------------------------------------------------------------
+// Checksums
+// -------------------------------------------------------------------------
+
+void slzwModel::calcChecksum(const uint8_t* buf, const uint32_t len)
+{
+    switch (csumType)
+    {
+    case SLZW_CSUM_CRC32:   csum = crc32(buf, len);   break;
+    case SLZW_CSUM_ADLER32: csum = adler32(buf, len); break;
+    default:                csum = 0;                 break;
+    }
+}
+
+// Build the CRC-32 byte table, reflected, with polynomial 0xedb88320 as slzw_checksum
+static bool buildCrcTable(uint32_t* table)
+{
+    for (uint32_t idx = 0; idx < 256; idx++)
+    {
+        uint32_t val = idx;
+
+        for (int bit = 0; bit < 8; bit++)
+        {
+            val = (val & 1) ? ((val >> 1) ^ 0xedb88320) : (val >> 1);
+        }
+
+        table[idx] = val;
+    }
+
+    return true;
+}
+
+uint32_t slzwModel::crc32(const uint8_t* buf, const uint32_t len, const uint32_t crcIn)
+{
+    static uint32_t table[256];
+    static bool     tableValid = buildCrcTable(table);   // Built once, thread safe
+
+    (void)tableValid;
+
+    uint32_t crc = ~crcIn;
+
+    for (uint32_t idx = 0; idx < len; idx++)
+    {
+        crc = table[(crc ^ buf[idx]) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+// The sums are reduced modulo 65521 every 5552 bytes, the most that can be
+// added without overflowing 32 bits
+uint32_t slzwModel::adler32(const uint8_t* buf, const uint32_t len, const uint32_t adler)
+{
+    const uint32_t mod = 65521;
+    uint32_t       a   = adler & 0xffff;
+    uint32_t       b   = adler >> 16;
+
+    for (uint32_t idx = 0; idx < len; )
+    {
+        uint32_t end = (len - idx > 5552) ? idx + 5552 : len;
+
+        for (; idx < end; idx++)
+        {
+            a += buf[idx];
+            b += a;
+        }
+
+        a %= mod;
+        b %= mod;
+    }
+
+    return (b << 16) | a;
+}
@@ -0,0 +1,166 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW C++ reference model header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_model.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-21
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definition for the C++ reference model of the
+//  SLZW codec. The model generates and consumes the same codeword stream as
+//  the Verilog codec, and is used for golden data and host software fallback.
+//
+//  The model selects a compile-time specialisation of the codec templates in
+//  slzw_codec_t.h for its configuration on construction, so there are no
+//  configuration tests in the per-byte loops.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_MODEL_H_
+#define _SLZW_MODEL_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstddef>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Bounding definitions (must match slzw_dict.v). The dictionary is full when
+// the next available code reaches 2^maxCodeWidth, and the rehash seed space
+// is twice this.
+#define SLZW_MINCWLEN             9
+#define SLZW_MAXCWLIMIT           16
+#define SLZW_FIRSTCW              0x100
+
+// Codeword reserved for a dictionary clear when the adaptive policy is used.
+// The first available dictionary code is then one higher.
+#define SLZW_CLRCW                0x100
+
+// Defaults for configuration. A memSize of 0 selects the nominal size
+// for the code width of 2.5 x 2^maxCodeWidth (10240 for 12 bits).
+#define SLZW_DEFAULT_MAXCWLEN     12
+#define SLZW_DEFAULT_MEMSIZE      10240
+#define SLZW_DEFAULT_CHECKGAP     10000
+
+// Return status values
+#define SLZW_OK                   0
+#define SLZW_ERR_OVERFLOW         1
+#define SLZW_ERR_BADCODE          2
+#define SLZW_ERR_CONFIG           3
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Dictionary reset policy, matching the slzw_codec control register
+// reset_policy field.
+typedef enum {
+    SLZW_RESET_ON_FULL        = 0,  // Dictionary resets itself when full (no clear code)
+    SLZW_RESET_ADAPTIVE       = 1   // Dictionary freezes when full, and a clear code is
+                                    // issued when the compression ratio degrades
+} slzwResetPolicy_t;
+
+// Uncompressed data checksum type. CRC-32 and Adler-32 match the slzw_codec
+// control register csum_adler field values.
+typedef enum {
+    SLZW_CSUM_CRC32           = 0,  // CRC-32 (IEEE 802.3), as zlib crc32()
+    SLZW_CSUM_ADLER32         = 1,  // Adler-32, as zlib adler32()
+    SLZW_CSUM_NONE            = 2   // No checksum calculated
+} slzwChecksum_t;
+
+typedef struct {
+    slzwResetPolicy_t policy;
+    uint32_t          maxCodeWidth; // Maximum codeword width (SLZW_MINCWLEN to SLZW_MAXCWLIMIT)
+    uint32_t          memSize;      // Hash table size (dictionary memory entries)
+    uint32_t          checkGap;     // Input bytes per ratio check window (adaptive policy)
+} slzwConfig_t;
+
+// Codec specialisation, defined in slzw_codec_t.h
+class slzwCodecBase;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITION
+// -------------------------------------------------------------------------
+
+class slzwModel
+{
+public:
+    // Constructor. A NULL configuration selects the hardware defaults
+    slzwModel(const slzwConfig_t* cfg = NULL);
+    ~slzwModel();
+
+    // Compress ilen bytes from ibuf into obuf (of obufLen bytes capacity).
+    // Number of bytes output returned in olen, on SLZW_ERR_OVERFLOW those
+    // written before obuf filled.
+    int      compress        (const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen);
+
+    // Decompress ilen bytes from ibuf into obuf (of obufLen bytes capacity).
+    // Number of bytes output returned in olen.
+    int      decompress      (const uint8_t* ibuf, const uint32_t ilen, uint8_t* obuf, const uint32_t obufLen, uint32_t &olen);
+
+    // Number of dictionary resets (wrap or clear code) during last operation
+    uint32_t getResetCount   ();
+
+    // Number of clear codes issued or seen during the last operation
+    uint32_t getClearCount   ();
+
+    // Return the active configuration (with any defaults resolved)
+    const slzwConfig_t &getConfig () { return cfg; };
+
+    // Select the checksum calculated over the uncompressed data (the input
+    // when compressing, the output when decompressing), as the codec's
+    // checksum register. None is calculated by default.
+    void     setChecksum     (const slzwChecksum_t type) { csumType = type; };
+
+    // Checksum of the last operation's uncompressed data
+    uint32_t getChecksum     () { return csum; };
+
+    // Checksum calculation, continuing from a previous value for a buffer in
+    // parts (initial values 0 for CRC-32 and 1 for Adler-32)
+    static uint32_t crc32    (const uint8_t* buf, const uint32_t len, const uint32_t crc = 0);
+    static uint32_t adler32  (const uint8_t* buf, const uint32_t len, const uint32_t adler = 1);
+
+private:
+
+    // Not copyable, as the codec specialisation is owned
+    slzwModel(const slzwModel &);
+    slzwModel &operator=(const slzwModel &);
+
+    // Configuration
+    slzwConfig_t             cfg;
+
+    // Codec specialisation selected for the configuration, or NULL if invalid
+    slzwCodecBase*           codec;
+
+    // Checksum selection and last result
+    slzwChecksum_t           csumType;
+    uint32_t                 csum;
+
+    // Calculate the selected checksum
+    void     calcChecksum    (const uint8_t* buf, const uint32_t len);
+};
+
+#endif
@@ -0,0 +1,256 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW compressed program image packer
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_pack.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-02-27
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the top level code for a host command line program to
+//  pack the PT_LOAD segments of an ELF executable into a compressed program
+//  image (see slzw_image.h), using the SLZW model. By default the image is
+//  packed for the hardware build's maximum codeword width, so that it can be
+//  decompressed by the slzw_codec on the platform.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+#include "slzw_model.h"
+#include "slzw_file.h"
+#include "slzw_image.h"
+#include "core_params_auto.h"
+#include "elf.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+// --------------------------------------------------
+// Validate the ELF headers, returning the program
+// headers of the PT_LOAD segments
+// --------------------------------------------------
+
+static int getSegments(const std::vector<uint8_t> &elf, std::vector<Elf32_Phdr> &segs, uint32_t &entry)
+{
+    Elf32_Ehdr h;
+
+    if (elf.size() < sizeof(Elf32_Ehdr))
+    {
+        fprintf(stderr, "*** getSegments(): file too small for ELF header\n");
+        return USER_ERROR;
+    }
+
+    memcpy(&h, elf.data(), sizeof(Elf32_Ehdr));
+
+    if (memcmp(h.e_ident, ELF_IDENT, 4) != 0 || h.e_ident[EI_CLASS] != ELFCLASS32 || h.e_ident[EI_DATA] != ELFDATA2LSB)
+    {
+        fprintf(stderr, "*** getSegments(): not a 32 bit little endian ELF file\n");
+        return USER_ERROR;
+    }
+
+    if (h.e_type != ET_EXEC)
+    {
+        fprintf(stderr, "*** getSegments(): not an executable ELF file\n");
+        return USER_ERROR;
+    }
+
+    if (h.e_phentsize != sizeof(Elf32_Phdr) || ((uint64_t)h.e_phoff + (uint64_t)h.e_phnum * sizeof(Elf32_Phdr)) > elf.size())
+    {
+        fprintf(stderr, "*** getSegments(): program headers outside of file\n");
+        return USER_ERROR;
+    }
+
+    entry = h.e_entry;
+
+    for (uint32_t pcount = 0; pcount < h.e_phnum; pcount++)
+    {
+        Elf32_Phdr ph;
+
+        memcpy(&ph, elf.data() + h.e_phoff + pcount * sizeof(Elf32_Phdr), sizeof(Elf32_Phdr));
+
+        if (ph.p_type != PT_LOAD || ph.p_memsz == 0)
+        {
+            continue;
+        }
+
+        if (ph.p_filesz > ph.p_memsz || ((uint64_t)ph.p_offset + ph.p_filesz) > elf.size() || (ph.p_vaddr & 3))
+        {
+            fprintf(stderr, "*** getSegments(): segment %d invalid\n", pcount);
+            return USER_ERROR;
+        }
+
+        segs.push_back(ph);
+    }
+
+    if (segs.size() > SLZW_IMG_MAX_SEGS)
+    {
+        fprintf(stderr, "*** getSegments(): Number of segments (%zu) exceeds maximum supported (%d)\n", segs.size(), SLZW_IMG_MAX_SEGS);
+        return USER_ERROR;
+    }
+
+    return 0;
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    int          c;
+    const char*  ifname = NULL;
+    const char*  ofname = NULL;
+    slzwConfig_t cfg;
+
+    cfg.policy       = SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth = CORE_PARAM_CWMAX;
+    cfg.memSize      = CORE_PARAM_MEMSIZE;
+    cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+    while ((c = getopt(argc, argv, "hai:o:w:")) != -1)
+    {
+        switch (c)
+        {
+        case 'a':
+            cfg.policy       = SLZW_RESET_ADAPTIVE;
+            break;
+        case 'i':
+            ifname           = optarg;
+            break;
+        case 'o':
+            ofname           = optarg;
+            break;
+        case 'w':
+            cfg.maxCodeWidth = strtol(optarg, NULL, 0);
+            cfg.memSize      = 0;
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-a] [-w <width>] -i <elf file> -o <image file>\n", argv[0]);
+            printf("         -a Use adaptive dictionary reset policy (default reset on full)\n");
+            printf("         -w Maximum code width (default hardware build's %d)\n", CORE_PARAM_CWMAX);
+            printf("         -i Input ELF executable\n");
+            printf("         -o Output compressed image\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    if (ifname == NULL || ofname == NULL)
+    {
+        fprintf(stderr, "*** main(): input and output files must be specified\n");
+        return USER_ERROR;
+    }
+
+    std::vector<uint8_t>    elf;
+    std::vector<Elf32_Phdr> phdrs;
+    uint32_t                entry;
+
+    if (readFile(ifname, elf) || getSegments(elf, phdrs, entry))
+    {
+        return USER_ERROR;
+    }
+
+    slzwModel                 model(&cfg);
+    slzwImgHdr_t              hdr;
+    std::vector<slzwImgSeg_t> segs(phdrs.size());
+    std::vector<uint8_t>      data;
+    uint32_t                  rawTotal = 0;
+
+    hdr.magic        = SLZW_IMG_MAGIC;
+    hdr.version      = SLZW_IMG_VERSION;
+    hdr.numSegs      = phdrs.size();
+    hdr.entry        = entry;
+    hdr.maxCodeWidth = model.getConfig().maxCodeWidth;
+    hdr.resetPolicy  = cfg.policy;
+
+    uint32_t offset  = sizeof(slzwImgHdr_t) + segs.size() * sizeof(slzwImgSeg_t);
+
+    for (uint32_t idx = 0; idx < phdrs.size(); idx++)
+    {
+        const uint8_t*       raw = elf.data() + phdrs[idx].p_offset;
+        std::vector<uint8_t> comp(phdrs[idx].p_filesz * 2 + 16);
+        uint32_t             clen;
+
+        if (model.compress(raw, phdrs[idx].p_filesz, comp.data(), comp.size(), clen) != SLZW_OK)
+        {
+            fprintf(stderr, "*** main(): failed to compress segment %d\n", idx);
+            return USER_ERROR;
+        }
+
+        segs[idx].vaddr   = phdrs[idx].p_vaddr;
+        segs[idx].memSize = phdrs[idx].p_memsz;
+        segs[idx].rawSize = phdrs[idx].p_filesz;
+        segs[idx].offset  = offset + data.size();
+
+        // Store raw if compression doesn't help
+        if (clen >= phdrs[idx].p_filesz)
+        {
+            segs[idx].flags    = SLZW_IMG_SEG_RAW;
+            segs[idx].dataSize = phdrs[idx].p_filesz;
+            data.insert(data.end(), raw, raw + phdrs[idx].p_filesz);
+        }
+        else
+        {
+            segs[idx].flags    = 0;
+            segs[idx].dataSize = clen;
+            data.insert(data.end(), comp.begin(), comp.begin() + clen);
+        }
+
+        // Word align the next segment's data
+        data.resize((data.size() + 3) & ~3);
+
+        rawTotal += phdrs[idx].p_filesz;
+
+        printf("Segment %d: vaddr 0x%08x, %d bytes -> %d bytes%s\n", idx, segs[idx].vaddr,
+               segs[idx].rawSize, segs[idx].dataSize, segs[idx].flags & SLZW_IMG_SEG_RAW ? " (raw)" : "");
+    }
+
+    FILE* fp;
+
+    if ((fp = fopen(ofname, "wb")) == NULL)
+    {
+        fprintf(stderr, "*** main(): Unable to open file %s for writing\n", ofname);
+        return USER_ERROR;
+    }
+
+    fwrite(&hdr, sizeof(slzwImgHdr_t), 1, fp);
+    fwrite(segs.data(), sizeof(slzwImgSeg_t), segs.size(), fp);
+    fwrite(data.data(), 1, data.size(), fp);
+    fclose(fp);
+
+    printf("%s: %d bytes of segment data packed to %d byte image (CWMAX %d)\n",
+           ofname, rawTotal, offset + (uint32_t)data.size(), hdr.maxCodeWidth);
+
+    return 0;
+}
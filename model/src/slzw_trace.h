@@ -0,0 +1,86 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec event trace format
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_trace.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-06
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definitions for the slzw_codec event trace, as
+//  read from the codec's trace registers by the driver, and converted to
+//  Chrome/Perfetto trace JSON by the slzwtrace tool.
+//
+//  Each entry is a clock cycle timestamp and an event word, with a bit for
+//  each event seen in that cycle and the length - 1 of any burst issued.
+//  Trace files are text, with an entry per line as two hex words (timestamp
+//  then event word), and lines starting with # ignored.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_TRACE_H_
+#define _SLZW_TRACE_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <cstdint>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Event word bits, matching slzw_trace in slzw_lib.v
+#define SLZW_TRC_JOB_START        0x00000001
+#define SLZW_TRC_JOB_DONE         0x00000002
+#define SLZW_TRC_RD_ISSUE         0x00000004
+#define SLZW_TRC_RD_DONE          0x00000008
+#define SLZW_TRC_WR_ISSUE         0x00000010
+#define SLZW_TRC_WR_DONE          0x00000020
+#define SLZW_TRC_RX_EMPTY         0x00000040
+#define SLZW_TRC_RX_NOTEMPTY      0x00000080
+#define SLZW_TRC_RX_FULL          0x00000100
+#define SLZW_TRC_RX_NOTFULL       0x00000200
+#define SLZW_TRC_DICT_RESET       0x00000400
+#define SLZW_TRC_DICT_FULL        0x00000800
+
+#define SLZW_TRC_EVENT_MASK       0x0000ffff
+
+// Burst lengths - 1 of bursts issued in the entry's cycle
+#define SLZW_TRC_ARLEN(_ev)       (((_ev) >> 16) & 0xff)
+#define SLZW_TRC_AWLEN(_ev)       (((_ev) >> 24) & 0xff)
+
+// Trace file line format
+#define SLZW_TRC_FILE_FMT         "%08x %08x\n"
+
+// Trace FIFO depth of the hardware build (slzw_codec TRACEDEPTH parameter)
+#define SLZW_TRC_DEPTH            512
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t time;                  // Clock cycle timestamp (wraps)
+    uint32_t event;                 // Event word
+} slzwTraceEntry_t;
+
+#endif
@@ -0,0 +1,342 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec event trace to Chrome/Perfetto JSON converter
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_trace_json.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-06
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the top level code for a host command line program to
+//  convert an slzw_codec event trace file (see slzw_trace.h), captured in
+//  simulation or on the platform, to Chrome trace event JSON, for viewing in
+//  chrome://tracing or ui.perfetto.dev.
+//
+//  Jobs, and the RX FIFO empty and full periods, are shown as complete
+//  events on their own tracks. AXI read and write bursts overlap, so are
+//  shown as async events, from issue to last data (reads) or response
+//  (writes), paired in order. Dictionary resets and dictionary full are
+//  instant events. The 32 bit cycle timestamps are unwrapped, assuming
+//  less than 2^32 cycles between entries.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <unistd.h>
+
+#include "slzw_trace.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define USER_ERROR                1
+
+#define DEFAULT_CLK_MHZ           100
+#define MAX_LINE_LEN              256
+
+// Track (thread) IDs
+#define TID_JOB                   1
+#define TID_RX_FIFO               2
+#define TID_AXI_READ              3
+#define TID_AXI_WRITE             4
+#define TID_DICT                  5
+
+// --------------------------------------------------
+// TYPEDEFS
+// --------------------------------------------------
+
+typedef struct {
+    uint64_t cycle;
+    uint32_t beats;
+    uint32_t id;
+} burst_t;
+
+// --------------------------------------------------
+// STATIC VARIABLES
+// --------------------------------------------------
+
+static FILE*  ofp      = stdout;
+static double clkMhz   = DEFAULT_CLK_MHZ;
+static bool   first    = true;
+
+// --------------------------------------------------
+// Read a trace file into entries
+// --------------------------------------------------
+
+static int readTrace(const char* filename, std::vector<slzwTraceEntry_t> &entries)
+{
+    FILE* fp;
+    char  line[MAX_LINE_LEN];
+
+    if ((fp = fopen(filename, "r")) == NULL)
+    {
+        fprintf(stderr, "*** readTrace(): Unable to open file %s for reading\n", filename);
+        return USER_ERROR;
+    }
+
+    for (uint32_t lnum = 1; fgets(line, MAX_LINE_LEN, fp) != NULL; lnum++)
+    {
+        slzwTraceEntry_t entry;
+
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+
+        if (sscanf(line, "%x %x", &entry.time, &entry.event) != 2)
+        {
+            fprintf(stderr, "*** readTrace(): Bad entry at %s line %d\n", filename, lnum);
+            fclose(fp);
+            return USER_ERROR;
+        }
+
+        entries.push_back(entry);
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Output an event, with timestamps converted from
+// cycles to microseconds
+// --------------------------------------------------
+
+static void outEvent(const char* name, const char* ph, const int tid, const uint64_t cycle, const char* extra = "")
+{
+    fprintf(ofp, "%s\n    {\"name\": \"%s\", \"ph\": \"%s\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f%s}",
+            first ? "" : ",", name, ph, tid, cycle / clkMhz, extra);
+
+    first = false;
+}
+
+static void outComplete(const char* name, const int tid, const uint64_t start, const uint64_t end, const char* args = "")
+{
+    char extra[MAX_LINE_LEN];
+
+    snprintf(extra, MAX_LINE_LEN, ", \"dur\": %.3f%s", (end - start) / clkMhz, args);
+
+    outEvent(name, "X", tid, start, extra);
+}
+
+static void outAsync(const char* name, const char* ph, const int tid, const uint64_t cycle, const uint32_t id, const uint32_t beats)
+{
+    char extra[MAX_LINE_LEN];
+
+    snprintf(extra, MAX_LINE_LEN, ", \"cat\": \"axi\", \"id\": %d, \"args\": {\"beats\": %d}", id, beats);
+
+    outEvent(name, ph, tid, cycle, extra);
+}
+
+static void outTrackName(const int tid, const char* name)
+{
+    char extra[MAX_LINE_LEN];
+
+    snprintf(extra, MAX_LINE_LEN, ", \"args\": {\"name\": \"%s\"}", name);
+
+    outEvent("thread_name", "M", tid, 0, extra);
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    int          c;
+    const char*  ifname = NULL;
+    const char*  ofname = NULL;
+
+    while ((c = getopt(argc, argv, "hi:o:c:")) != -1)
+    {
+        switch (c)
+        {
+        case 'i':
+            ifname = optarg;
+            break;
+        case 'o':
+            ofname = optarg;
+            break;
+        case 'c':
+            clkMhz = strtod(optarg, NULL);
+            break;
+        case 'h':
+        default:
+            printf("Usage: %s [-h] [-c <MHz>] -i <trace file> [-o <json file>]\n", argv[0]);
+            printf("         -c Codec clock frequency in MHz (default %d)\n", DEFAULT_CLK_MHZ);
+            printf("         -i Input event trace file\n");
+            printf("         -o Output Chrome/Perfetto trace JSON file (default stdout)\n");
+            printf("\n");
+            return (c == 'h') ? 0 : USER_ERROR;
+        }
+    }
+
+    if (ifname == NULL || clkMhz <= 0.0)
+    {
+        fprintf(stderr, "*** main(): no input trace file, or invalid clock frequency\n");
+        return USER_ERROR;
+    }
+
+    std::vector<slzwTraceEntry_t> entries;
+
+    if (readTrace(ifname, entries))
+    {
+        return USER_ERROR;
+    }
+
+    if (ofname != NULL && (ofp = fopen(ofname, "w")) == NULL)
+    {
+        fprintf(stderr, "*** main(): Unable to open file %s for writing\n", ofname);
+        return USER_ERROR;
+    }
+
+    fprintf(ofp, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+
+    outTrackName(TID_JOB,       "Job");
+    outTrackName(TID_RX_FIFO,   "RX FIFO");
+    outTrackName(TID_AXI_READ,  "AXI read");
+    outTrackName(TID_AXI_WRITE, "AXI write");
+    outTrackName(TID_DICT,      "Dictionary");
+
+    std::deque<burst_t> rdq, wrq;
+    uint64_t            base       = 0;
+    uint32_t            last       = 0;
+    uint64_t            jobStart   = 0;
+    uint64_t            emptyStart = 0;
+    uint64_t            fullStart  = 0;
+    bool                inJob      = false;
+    bool                inEmpty    = false;
+    bool                inFull     = false;
+    uint32_t            burstId    = 0;
+    uint32_t            jobs       = 0;
+
+    for (auto &entry : entries)
+    {
+        // Unwrap the timestamp
+        if (entry.time < last)
+        {
+            base += 1ULL << 32;
+        }
+        last = entry.time;
+
+        uint64_t cycle = base + entry.time;
+        uint32_t ev    = entry.event;
+
+        // Completions before issues, as a burst can't complete in the cycle it's issued
+        if ((ev & SLZW_TRC_RD_DONE) && !rdq.empty())
+        {
+            outAsync("read", "e", TID_AXI_READ, cycle, rdq.front().id, rdq.front().beats);
+            rdq.pop_front();
+        }
+
+        if ((ev & SLZW_TRC_WR_DONE) && !wrq.empty())
+        {
+            outAsync("write", "e", TID_AXI_WRITE, cycle, wrq.front().id, wrq.front().beats);
+            wrq.pop_front();
+        }
+
+        if (ev & SLZW_TRC_RD_ISSUE)
+        {
+            burst_t b = {cycle, SLZW_TRC_ARLEN(ev) + 1, burstId++};
+            outAsync("read", "b", TID_AXI_READ, cycle, b.id, b.beats);
+            rdq.push_back(b);
+        }
+
+        if (ev & SLZW_TRC_WR_ISSUE)
+        {
+            burst_t b = {cycle, SLZW_TRC_AWLEN(ev) + 1, burstId++};
+            outAsync("write", "b", TID_AXI_WRITE, cycle, b.id, b.beats);
+            wrq.push_back(b);
+        }
+
+        if ((ev & SLZW_TRC_RX_EMPTY) && !inEmpty)
+        {
+            emptyStart = cycle;
+            inEmpty    = true;
+        }
+
+        if ((ev & SLZW_TRC_RX_NOTEMPTY) && inEmpty)
+        {
+            outComplete("empty", TID_RX_FIFO, emptyStart, cycle);
+            inEmpty    = false;
+        }
+
+        if ((ev & SLZW_TRC_RX_FULL) && !inFull)
+        {
+            fullStart  = cycle;
+            inFull     = true;
+        }
+
+        if ((ev & SLZW_TRC_RX_NOTFULL) && inFull)
+        {
+            outComplete("full", TID_RX_FIFO, fullStart, cycle);
+            inFull     = false;
+        }
+
+        if (ev & SLZW_TRC_DICT_RESET)
+        {
+            outEvent("reset", "i", TID_DICT, cycle, ", \"s\": \"t\"");
+        }
+
+        if (ev & SLZW_TRC_DICT_FULL)
+        {
+            outEvent("full", "i", TID_DICT, cycle, ", \"s\": \"t\"");
+        }
+
+        if ((ev & SLZW_TRC_JOB_DONE) && inJob)
+        {
+            char args[MAX_LINE_LEN];
+            snprintf(args, MAX_LINE_LEN, ", \"args\": {\"cycles\": %llu}", (unsigned long long)(cycle - jobStart));
+
+            outComplete("job", TID_JOB, jobStart, cycle, args);
+            inJob    = false;
+        }
+
+        if (ev & SLZW_TRC_JOB_START)
+        {
+            jobStart = cycle;
+            inJob    = true;
+            jobs++;
+        }
+    }
+
+    fprintf(ofp, "\n]}\n");
+
+    if (ofp != stdout)
+    {
+        fclose(ofp);
+    }
+
+    fprintf(stderr, "%zu entries, %d jobs, %zu read and %zu write bursts without completion\n",
+            entries.size(), jobs, rdq.size(), wrq.size());
+
+    return 0;
+}
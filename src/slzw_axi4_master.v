@@ -46,7 +46,12 @@ module slzw_axi4_master
   DEFAULTBURSTSIZE                     = 128,     // Must be no greater than AXI limit (256) and a power of 2. Preferably <= RXFIFODEPTH/2 to hide latency
   DEFAULTARUSER                        = 1'b1,    // If Cacheable accesses required, this must be 1
   DEFAULTARCACHE                       = 4'b1110, // For cacheable accesses, bit 3 must be 1, and the rest a valid value as per A4.4 of AXI4 spec.
-  DEFAULTPROT                          = 3'b000   // User level protection
+  DEFAULTAWUSER                        = 1'b1,    // As DEFAULTARUSER, for writes
+  DEFAULTAWCACHE                       = 4'b1110, // As DEFAULTARCACHE, for writes
+  ACPWINBASE                           = 32'h0,   // Address offset of the ACP window, for coherent jobs (0 if the system routes none)
+  DEFAULTPROT                          = 3'b000,  // User level protection
+  TXFIFODEPTH                          = 256,     // Must be at least DEFAULTBURSTSIZE
+  SGDEPTH                              = 16       // Scatter-gather segments per list. Must be a power of 2
 )
 (
   input                                aclk,
@@ -56,27 +61,55 @@ module slzw_axi4_master
   input                                clear,
   input                                start,
 
+  // Job data path. Coherent jobs access memory through the ACP window,
+  // with the cacheable AxCACHE and AxUSER values. Non-coherent jobs use
+  // the unmodified addresses and non-cacheable accesses.
+  input                                coherent,
+
   input      [31:0]                    rx_start_addr,
   input      [31:0]                    rx_len,
   input      [31:0]                    tx_start_addr,
   input      [31:0]                    tx_len,
 
+  // Scatter-gather segment lists. With rx_sg (tx_sg) set at start, the
+  // input (output) is the list of segments pushed, in order, rather than
+  // the single start address and length. Segment addresses are word
+  // aligned, and only the last input segment may have a partial word.
+  input                                rx_sg,
+  input                                tx_sg,
+  input      [31:0]                    sg_addr,
+  input      [31:0]                    sg_len,
+  input                                sg_rx_push,
+  input                                sg_tx_push,
+  input                                sg_clr,
+
   input                                user_read_byte,
   output     [USRPORTWIDTH-1:0]        user_read_data,
   output                               user_read_data_valid,
 
   input                                user_write_byte,
   input       [7:0]                    user_write_data,
+  input                                user_write_flush, // Asserted after the last output byte of a job
   output                               user_write_ready,
 
   output                               busy,
 
+  // Output bytes accepted for the job, and output dropped for lack of space
+  output reg [31:0]                    tx_out_len,
+  output reg                           tx_overflow,
+
+  // RX FIFO status, for tracing
+  output                               rx_fifo_empty,
+  output                               rx_fifo_full,
+
   // --- AXI-4 bus ---
 
   // AXI write address bus.
-  // Optional signals, unused: AWID, AWREGION, AWSIZE, AWBURST, AWLOCK, AWCACHE, AWQOS
-  output     [31:0]                    awaddr,
-  output      [7:0]                    awlen,   // Optional. Default length 1 (AWLEN == 0)
+  // Optional signals, unused: AWID, AWREGION, AWSIZE, AWBURST, AWLOCK, AWQOS
+  output reg [31:0]                    awaddr,
+  output reg  [7:0]                    awlen,   // Optional. Default length 1 (AWLEN == 0)
+  output      [3:0]                    awcache, // Optional. Used for cache coherency
+  output                               awuser,  // Optional. Used for cache coherency
   output      [2:0]                    awprot,
   output reg                           awvalid,
   input                                awready,
@@ -85,7 +118,7 @@ module slzw_axi4_master
   // Optional signals, unused:         WSTRB
   output     [31:0]                    wdata,
   output                               wlast,
-  output reg                           wvalid,
+  output                               wvalid,
   input                                wready,
 
   // AXI write response bus.
@@ -120,6 +153,9 @@ localparam                             MINUSRPORTWIDTH   =  8;
 localparam                             MAXAXIBURSTSIZE   = 256;
 localparam                             LOG2MAXAXIBURST   = $clog2(MAXAXIBURSTSIZE);
 localparam                             LOG2BURSTSIZE     = $clog2(DEFAULTBURSTSIZE);
+localparam                             LOG2RXFIFODEPTH   = $clog2(RXFIFODEPTH);
+localparam                             LOG2TXFIFODEPTH   = $clog2(TXFIFODEPTH);
+localparam                             LOG2SGDEPTH       = $clog2(SGDEPTH);
 
 // ---------------------------------------------
 // Configuration checks
@@ -142,7 +178,7 @@ endgenerate
 
 // Check USRPORTWIDTH is valid
 generate
-if ((USRPORTWIDTH & (USRPORTWIDTH-1) != 0) || (USRPORTWIDTH > MAXUSRPORTWIDTH) || (USRPORTWIDTH < MINUSRPORTWIDTH))
+if (((USRPORTWIDTH & (USRPORTWIDTH-1)) != 0) || (USRPORTWIDTH > MAXUSRPORTWIDTH) || (USRPORTWIDTH < MINUSRPORTWIDTH))
 begin
   initial
   begin
@@ -159,13 +195,37 @@ endgenerate
 // ---------------------------------------------
 
 reg                                    rbusy;
+reg                                    rx_sg_job;
 reg   [1:0]                            user_rd_byte_count;
-reg  [31:0]                            remaining_word_count;   // Total count of remaining words requiring new read commands
-reg  [31:0]                            rx_outstanding_count;   // Total count of outstanding words yet to be received
-reg  [LOG2MAXAXIBURST-1:0]             rx_fifo_count;          // Count of words in RX fifo plus any already requested but not yet received
-reg  [31:0]                            rx_len_int;
-reg  [31:0]                            rx_len_words;
-reg   [8:0]                            rx_words_to_boundary;
+reg  [31:0]                            rx_next_addr;           // Byte address of the next read command
+reg  [31:0]                            remaining_word_count;   // Count of words in the current segment requiring new read commands
+reg  [31:0]                            rx_outstanding_count;   // Count of requested words yet to be received
+reg  [LOG2RXFIFODEPTH:0]               rx_fifo_count;          // Count of words in RX fifo plus any already requested but not yet received
+reg                                    rx_word_loaded;         // RX fifo output holds the word being read by the user
+reg  [31:0]                            rx_bytes_total;         // Input bytes of the job's segments loaded so far
+reg  [31:0]                            rx_bytes_read;          // Input bytes read by the user
+
+reg                                    tbusy;
+reg                                    tx_sg_job;
+reg                                    tx_flushed;
+reg  [23:0]                            tx_pack;                // Output bytes packed for the next TX fifo word
+reg   [1:0]                            tx_byte_count;
+reg  [31:0]                            tx_next_addr;           // Byte address of the next write command
+reg  [31:0]                            tx_remaining_words;     // Count of words of space left in the current segment
+reg  [LOG2TXFIFODEPTH:0]               tx_fifo_count;          // Count of words in the TX fifo
+reg                                    tx_word_loaded;         // TX fifo output holds a word not yet written
+reg  [LOG2MAXAXIBURST:0]               wr_beats_left;          // Write data beats left in the current burst
+reg  [15:0]                            b_outstanding_count;    // Write bursts issued without a response
+
+// Scatter-gather segment lists
+reg  [31:0]                            rx_seg_addr [0:SGDEPTH-1];
+reg  [31:0]                            rx_seg_len  [0:SGDEPTH-1];
+reg  [LOG2SGDEPTH:0]                   rx_seg_wptr;
+reg  [LOG2SGDEPTH:0]                   rx_seg_rptr;
+reg  [31:0]                            tx_seg_addr [0:SGDEPTH-1];
+reg  [31:0]                            tx_seg_len  [0:SGDEPTH-1];
+reg  [LOG2SGDEPTH:0]                   tx_seg_wptr;
+reg  [LOG2SGDEPTH:0]                   tx_seg_rptr;
 
 // ---------------------------------------------
 // Signalling
@@ -174,22 +234,78 @@ reg   [8:0]                            rx_words_to_boundary;
 wire                                   clk;
 wire                                   reset_n;
 
+wire                                   job_start;
+
 wire   [31:0]                          user_read_data_int;
 
 wire                                   rx_empty;
 wire                                   rx_full;
 
 wire                                   rx_fifo_rd;
+wire                                   rx_word_done;
+wire                                   rx_bytes_left;
 wire                                   rx_fifo_clr;
 wire   [31:0]                          rx_fifo_data;
 
 wire   [31:0]                          rx_start_addr_int;
+wire   [31:0]                          rx_len_words;
 
-wire                                   remain_count_gt_burst;
-wire   [LOG2MAXAXIBURST-1:0]           next_burst_size;
+wire   [LOG2MAXAXIBURST:0]             next_burst_size;
+wire                                   rx_issue;
+wire                                   rx_done;
+
+wire                                   rx_seg_empty;
+wire                                   rx_seg_full;
+wire                                   rx_seg_load;
+wire   [31:0]                          rx_seg_head_addr;
+wire   [31:0]                          rx_seg_head_len;
 
 wire   [1:0]                           user_rd_byte_count_cmp;
 
+wire                                   tx_empty;
+wire                                   tx_fifo_wr;
+wire                                   tx_fifo_rd;
+wire   [31:0]                          tx_fifo_wdata;
+wire   [31:0]                          tx_fifo_rdata;
+wire                                   tx_byte_accept;
+wire                                   tx_pack_full;
+wire                                   tx_flush_now;
+wire   [LOG2TXFIFODEPTH+1:0]           tx_avail;
+
+wire   [31:0]                          tx_start_addr_int;
+wire   [LOG2MAXAXIBURST:0]             tx_burst_size;
+wire   [LOG2MAXAXIBURST:0]             tx_issue_size;
+wire                                   tx_issue;
+wire                                   tx_beat;
+wire                                   tx_no_space;
+wire                                   tx_drop;
+wire                                   tx_done;
+
+wire                                   tx_seg_empty;
+wire                                   tx_seg_full;
+wire                                   tx_seg_load;
+wire   [31:0]                          tx_seg_head_addr;
+wire   [31:0]                          tx_seg_head_len;
+
+// ---------------------------------------------
+// Functions
+// ---------------------------------------------
+
+// The length of the next burst from addr, with words left in the segment.
+// This is a whole burst, cut short at the segment's end or at the next
+// burst size boundary. As every segment's bursts after the first then start
+// on a DEFAULTBURSTSIZE boundary, no burst crosses the AXI 4K boundary limit.
+// (See "AMBA AXI and ACE Protocol Specification", section A3.4.1, Address Structure)
+function [LOG2MAXAXIBURST:0] burst_words;
+  input [31:0]                         addr;
+  input [31:0]                         words;
+  reg   [LOG2MAXAXIBURST:0]            to_boundary;
+begin
+  to_boundary                          = DEFAULTBURSTSIZE - addr[LOG2BURSTSIZE+1:2];
+  burst_words                          = (words < to_boundary) ? words[LOG2MAXAXIBURST:0] : to_boundary;
+end
+endfunction
+
 // ---------------------------------------------
 // Combinatorial logic
 // ---------------------------------------------
@@ -197,13 +313,21 @@ wire   [1:0]                           user_rd_byte_count_cmp;
 assign clk                             = aclk;
 assign reset_n                         = aresetn;
 
-assign busy                            = rbusy | ~rx_empty;
+assign busy                            = rbusy | ~rx_empty | rx_word_loaded | tbusy;
+
+assign rx_fifo_empty                   = rx_empty;
+assign rx_fifo_full                    = rx_full;
+
+// A job starts on request when neither engine is busy
+assign job_start                       = start & ~rbusy & ~tbusy;
 
 // Export the configured AXI control values
 assign awprot                          = DEFAULTPROT;
 assign arprot                          = DEFAULTPROT;
-assign arcache                         = DEFAULTARCACHE;
-assign aruser                          = DEFAULTARUSER;
+assign arcache                         = coherent ? DEFAULTARCACHE : 4'b0000;
+assign aruser                          = coherent ? DEFAULTARUSER  : 1'b0;
+assign awcache                         = coherent ? DEFAULTAWCACHE : 4'b0000;
+assign awuser                          = coherent ? DEFAULTAWUSER  : 1'b0;
 
 assign bready                          = 1'b1;
 assign rready                          = 1'b1;
@@ -215,14 +339,22 @@ assign user_rd_byte_count_cmp          = (USRPORTWIDTH == 32) ? 2'b00 :
                                          (USRPORTWIDTH == 16) ? 2'b10 :
                                                                 2'b11 ;
 
-// Pop a read fifo word if requested and not empty, and byte count is at word boundary
-assign rx_fifo_rd                      = ~rx_empty & user_read_byte & (user_rd_byte_count == user_rd_byte_count_cmp);
+// Bytes past the end of the input, in the last word's padding, are not presented to the user
+assign rx_bytes_left                   = (rx_bytes_read < rx_bytes_total);
+
+// The loaded word is done when its last byte is read, or when only padding is left
+assign rx_word_done                    = rx_word_loaded & (~rx_bytes_left |
+                                         (user_read_byte & (user_rd_byte_count == user_rd_byte_count_cmp)));
+
+// Pop a read fifo word, to the fifo's registered output, if not empty and none is loaded,
+// or the loaded one is done
+assign rx_fifo_rd                      = ~rx_empty & (~rx_word_loaded | rx_word_done);
 
 // Clear the read fifo when requested
 assign rx_fifo_clr                     = clear;
 
-// User read data is valid when te read fifo is not empty
-assign user_read_data_valid            = ~rx_empty;
+// User read data is valid when a word is loaded and it has bytes of the input left
+assign user_read_data_valid            = rx_word_loaded & rx_bytes_left;
 
 // Depending on the byte count, rotate the read FIFO output to present the correct
 // bits to the read data output
@@ -234,16 +366,94 @@ assign user_read_data_int              = (user_rd_byte_count == 2'b11) ? {rx_fif
 // Export the user data by picking off the relevant bits of the full width word
 assign user_read_data                  = user_read_data_int[USRPORTWIDTH-1:0];
 
-// Calculate the internal start byte address, rounding down to word boundary
+// Calculate the internal start byte addresses, rounding down to word boundary
 assign rx_start_addr_int               = {rx_start_addr[31:2], 2'b00}; // Round down
+assign tx_start_addr_int               = {tx_start_addr[31:2], 2'b00}; // Round down
+
+// Requested RX length in words, rounding up for partial word
+assign rx_len_words                    = rx_len[31:2] + {29'h0, |rx_len[1:0]}; // Round up
+
+// ---------------------------------------------
+// Scatter-gather segment list heads. A segment
+// is loaded when the previous one has been
+// fully requested (RX) or filled (TX). Input
+// segments round up to whole words, and output
+// segments round down, so no write goes beyond
+// a segment.
+// ---------------------------------------------
+
+assign rx_seg_empty                    = (rx_seg_wptr == rx_seg_rptr);
+assign rx_seg_full                     = ((rx_seg_wptr - rx_seg_rptr) == SGDEPTH);
+assign rx_seg_head_addr                = {rx_seg_addr[rx_seg_rptr[LOG2SGDEPTH-1:0]][31:2], 2'b00};
+assign rx_seg_head_len                 = rx_seg_len[rx_seg_rptr[LOG2SGDEPTH-1:0]];
+assign rx_seg_load                     = rbusy & rx_sg_job & (remaining_word_count == 32'd0) & ~rx_seg_empty;
+
+assign tx_seg_empty                    = (tx_seg_wptr == tx_seg_rptr);
+assign tx_seg_full                     = ((tx_seg_wptr - tx_seg_rptr) == SGDEPTH);
+assign tx_seg_head_addr                = {tx_seg_addr[tx_seg_rptr[LOG2SGDEPTH-1:0]][31:2], 2'b00};
+assign tx_seg_head_len                 = tx_seg_len[tx_seg_rptr[LOG2SGDEPTH-1:0]];
+assign tx_seg_load                     = tbusy & tx_sg_job & (tx_remaining_words == 32'd0) & ~tx_seg_empty;
+
+// ---------------------------------------------
+// RX command issue
+// ---------------------------------------------
+
+assign next_burst_size                 = burst_words(rx_next_addr, remaining_word_count);
 
-// Flag when the remaining word count is bigger than a burst segment
-assign remain_count_gt_burst           = (remaining_word_count > DEFAULTBURSTSIZE) ? 1'b1 : 1'b0;
+// If there are still words left to request in the segment and there is enough space
+// remaining in the rx fifo to take the largest requested data, issue a new read
+// command when the read address bus is not already active, or is ready.
+assign rx_issue                        = rbusy & (remaining_word_count != 32'd0) &
+                                         (rx_fifo_count <= (RXFIFODEPTH-DEFAULTBURSTSIZE)) & (~arvalid | arready);
 
-// The next command length is a whole burst segment if remaining words greater, else
-// just the remaining words.
-assign next_burst_size                 = remain_count_gt_burst ? DEFAULTBURSTSIZE[LOG2MAXAXIBURST-1:0] :
-                                                                 remaining_word_count[LOG2MAXAXIBURST-1:0];
+// Reading is done when all segments are requested and all data received
+assign rx_done                         = rbusy & (remaining_word_count == 32'd0) & (~rx_sg_job | rx_seg_empty) &
+                                         (rx_outstanding_count == 32'd0) & ~arvalid;
+
+// ---------------------------------------------
+// TX byte packing, command issue and data
+// ---------------------------------------------
+
+// Output bytes are accepted whilst busy and not flushing, with space in the
+// TX fifo for a full word and a flushed partial word
+assign user_write_ready                = tbusy & ~tx_flushed & ~user_write_flush & (tx_fifo_count < (TXFIFODEPTH-1));
+
+assign tx_byte_accept                  = user_write_byte & user_write_ready;
+assign tx_pack_full                    = tx_byte_accept & (tx_byte_count == 2'b11);
+assign tx_flush_now                    = tbusy & ~tx_flushed & user_write_flush;
+
+// Push a word when its last byte arrives, or a partial word when flushed
+assign tx_fifo_wr                      = tx_pack_full | (tx_flush_now & (tx_byte_count != 2'b00));
+assign tx_fifo_wdata                   = tx_pack_full ? {user_write_data, tx_pack} : {8'h00, tx_pack};
+
+// Keep the fifo output loaded with the next word to write
+assign tx_fifo_rd                      = ~tx_empty & (~tx_word_loaded | tx_beat | tx_drop);
+
+// Words available to write, not yet in an issued burst
+assign tx_avail                        = tx_fifo_count + {{LOG2TXFIFODEPTH+1{1'b0}}, tx_word_loaded};
+
+assign tx_burst_size                   = burst_words(tx_next_addr, tx_remaining_words);
+assign tx_issue_size                   = (tx_avail < tx_burst_size) ? tx_avail : tx_burst_size;
+
+// Issue a write command once the previous burst's data is sent, and all a burst's
+// data is available, or all that's left once flushed
+assign tx_issue                        = tbusy & (wr_beats_left == 0) & ~awvalid & (tx_remaining_words != 32'd0) &
+                                         ((tx_avail >= tx_burst_size) | (tx_flushed & (tx_avail != 0)));
+
+// Write data follows an accepted write command
+assign wdata                           = tx_fifo_rdata;
+assign wvalid                          = tx_word_loaded & (wr_beats_left != 0) & ~awvalid;
+assign wlast                           = (wr_beats_left == 1);
+assign tx_beat                         = wvalid & wready;
+
+// With no space left for output, words are dropped and the overflow flagged
+assign tx_no_space                     = tbusy & (tx_remaining_words == 32'd0) & (~tx_sg_job | tx_seg_empty) &
+                                         (wr_beats_left == 0);
+assign tx_drop                         = tx_no_space & tx_word_loaded;
+
+// Writing is done when flushed, all data written and all responses received
+assign tx_done                         = tbusy & tx_flushed & (tx_avail == 0) & (wr_beats_left == 0) & ~awvalid &
+                                         (b_outstanding_count == 16'd0);
 
 // ---------------------------------------------
 // Receive data FIFO
@@ -273,103 +483,154 @@ assign next_burst_size                 = remain_count_gt_burst ? DEFAULTBURSTSIZ
   );
 
 // ---------------------------------------------
-// RX Synchronous logic
+// Transmit data FIFO
+// ---------------------------------------------
+
+  slzw_fifo
+  #(
+     .DEPTH                            (TXFIFODEPTH),
+     .WIDTH                            (32)
+  ) tx_fifo
+  (
+    .clk                               (aclk),
+    .reset_n                           (aresetn),
+
+    .clr                               (clear),
+
+    .write                             (tx_fifo_wr),
+    .wdata                             (tx_fifo_wdata),
+
+    .read                              (tx_fifo_rd),
+    .rdata                             (tx_fifo_rdata),
+
+    .empty                             (tx_empty),
+    .full                              (),
+    .nearly_full                       ()
+  );
+
+// ---------------------------------------------
+// Scatter-gather segment list synchronous logic
 // ---------------------------------------------
 
 always @(posedge clk `RESET)
 begin
   if (reset_n == 1'b0)
   begin
-    user_rd_byte_count                 <= 2'b00;
-    rbusy                              <= 1'b0;
-    arvalid                            <= 1'b0;
-    wvalid                             <= 1'b0;
-    awvalid                            <= 1'b0;
+    rx_seg_wptr                        <= {LOG2SGDEPTH+1{1'b0}};
+    rx_seg_rptr                        <= {LOG2SGDEPTH+1{1'b0}};
+    tx_seg_wptr                        <= {LOG2SGDEPTH+1{1'b0}};
+    tx_seg_rptr                        <= {LOG2SGDEPTH+1{1'b0}};
   end
   else
   begin
+    // Push segments to the tail of a list, ignoring pushes when full
+    if (sg_rx_push & ~rx_seg_full)
+    begin
+      rx_seg_addr[rx_seg_wptr[LOG2SGDEPTH-1:0]] <= sg_addr;
+      rx_seg_len[rx_seg_wptr[LOG2SGDEPTH-1:0]]  <= sg_len;
+      rx_seg_wptr                      <= rx_seg_wptr + 1;
+    end
 
-    // Calculate requested RX length in words, rounding up for partial word
-    rx_len_words                       <= rx_len[31:2] + {29'h0, |rx_len[1:0]}; // Round up
-
-    // Calculate the number of words to the next burst size segment boundary.
-    // By making the end of the first transfer align to a DEFAULTBURSTSIZE boundary
-    // all sunsequent transfers won't cross the AXI burst 4K bounday crossing limit.
-    // (See "AMBA AXI and ACE Protocol Specification", section A3.4.1, Address Structure)
-    rx_words_to_boundary               <= DEFAULTBURSTSIZE[LOG2BURSTSIZE:0] - {2'b00, rx_start_addr_int[LOG2BURSTSIZE+1:2]};
+    if (sg_tx_push & ~tx_seg_full)
+    begin
+      tx_seg_addr[tx_seg_wptr[LOG2SGDEPTH-1:0]] <= sg_addr;
+      tx_seg_len[tx_seg_wptr[LOG2SGDEPTH-1:0]]  <= sg_len;
+      tx_seg_wptr                      <= tx_seg_wptr + 1;
+    end
 
-    // Default arvalid state is to clear unless set and arready not asserted
-    arvalid                            <= (arvalid & ~arready);
+    // Pop segments from the head as the engines load them
+    if (rx_seg_load)
+    begin
+      rx_seg_rptr                      <= rx_seg_rptr + 1;
+    end
 
-    // Decrement RX fifo count for every popped word.This logic must
-    // be before the rx_fifo_count update for the new read burst command
-    // logic below, in order not to overwrite adding the issued burst length.
-    // That logic will include subtracting any popped word when updating
-    // the state.
-    if (rx_fifo_rd)
+    if (tx_seg_load)
     begin
-      rx_fifo_count                    <= rx_fifo_count - 1;
+      tx_seg_rptr                      <= tx_seg_rptr + 1;
     end
 
-    // If start asserted and not already rbusy, calculate first AXI address command
-    if (start & ~rbusy)
+    // Empty both lists on request, or when clearing the codec
+    if (sg_clr | clear)
     begin
-      rbusy                            <= 1'b1;
-      arvalid                          <= 1'b1;
-      araddr                           <= rx_start_addr_int;
+      rx_seg_wptr                      <= {LOG2SGDEPTH+1{1'b0}};
+      rx_seg_rptr                      <= {LOG2SGDEPTH+1{1'b0}};
+      tx_seg_wptr                      <= {LOG2SGDEPTH+1{1'b0}};
+      tx_seg_rptr                      <= {LOG2SGDEPTH+1{1'b0}};
+    end
+  end
+end
 
-      // ARLEN is burst size - 1
-      arlen                            <= rx_words_to_boundary[LOG2MAXAXIBURST-1:0] - 1;
+// ---------------------------------------------
+// RX Synchronous logic
+// ---------------------------------------------
 
-      // Keep a count of words requested
-      rx_fifo_count                    <= rx_words_to_boundary[LOG2MAXAXIBURST-1:0];
+always @(posedge clk `RESET)
+begin
+  if (reset_n == 1'b0)
+  begin
+    user_rd_byte_count                 <= 2'b00;
+    rbusy                              <= 1'b0;
+    rx_sg_job                          <= 1'b0;
+    arvalid                            <= 1'b0;
+    remaining_word_count               <= 32'd0;
+    rx_outstanding_count               <= 32'd0;
+    rx_fifo_count                      <= {LOG2RXFIFODEPTH+1{1'b0}};
+    rx_word_loaded                     <= 1'b0;
+    rx_bytes_total                     <= 32'd0;
+    rx_bytes_read                      <= 32'd0;
+  end
+  else
+  begin
+    // Default arvalid state is to clear unless set and arready not asserted
+    arvalid                            <= (arvalid & ~arready);
 
-      // The remaining words to have read burst commands sent is requested
-      // length (in words) less this burst size.
-      remaining_word_count             <= rx_len_words - rx_words_to_boundary;
+    // Add any new command word count to the pending counts, and subtract any
+    // word popped from the RX fifo, or received.
+    rx_fifo_count                      <= rx_fifo_count + (rx_issue ? next_burst_size : 0) - (rx_fifo_rd ? 1 : 0);
+    rx_outstanding_count               <= rx_outstanding_count + (rx_issue ? next_burst_size : 0) - (rvalid ? 1 : 0);
 
-      // Store the requested transfer length to count down the received data
-      rx_outstanding_count             <= rx_len_words;
+    rx_word_loaded                     <= rx_fifo_rd | (rx_word_loaded & ~rx_word_done);
+
+    // If start asserted and not already busy, load the transfer as a single segment, or
+    // mark it for the first segment to be loaded from the list.
+    if (job_start)
+    begin
+      rbusy                            <= 1'b1;
+      rx_sg_job                        <= rx_sg;
+      rx_next_addr                     <= rx_start_addr_int;
+      remaining_word_count             <= rx_sg ? 32'd0 : rx_len_words;
+      rx_bytes_total                   <= rx_sg ? 32'd0 : rx_len;
+      rx_bytes_read                    <= 32'd0;
     end
 
-    // If a read transfer is already busy, send new read commands to cover all
-    // the burst remaining segments
-    if (rbusy)
+    // Load the next segment from the list when the current one is fully requested
+    if (rx_seg_load)
     begin
-      // If there are still words left to transfer and there is enough space remaining
-      // in the rx fifo to take the largest requested data, issue a new read command.
-      if (remaining_word_count != 0 && rx_fifo_count <= (RXFIFODEPTH-DEFAULTBURSTSIZE))
-      begin
-        // If read address bus not already active, or interface is ready, send the command
-        if (~arvalid | arready)
-        begin
-          arvalid                      <= 1'b1;
+      rx_next_addr                     <= rx_seg_head_addr;
+      remaining_word_count             <= rx_seg_head_len[31:2] + {29'h0, |rx_seg_head_len[1:0]}; // Round up
+      rx_bytes_total                   <= rx_bytes_total + rx_seg_head_len;
+    end
 
-          // The new burst address is the old, plus the previous length (arlen + 1) scaled to bytes
-          araddr                       <= araddr + {(arlen + 1), 2'b00};
+    // Send new read commands to cover all the segment's remaining words
+    if (rx_issue)
+    begin
+      arvalid                          <= 1'b1;
+      araddr                           <= rx_next_addr | (coherent ? ACPWINBASE : 32'h0);
 
-          // The command length is the next burst size - 1
-          arlen                        <= next_burst_size - 8'd1;
+      // ARLEN is burst size - 1
+      arlen                            <= next_burst_size - 1;
 
-          // Add new command word count to pending count, and subtract any word popped from RX fifo
-          rx_fifo_count             <= rx_fifo_count + next_burst_size - {{LOG2MAXAXIBURST-2{1'b0}}, rx_fifo_rd};
+      // The next burst address is this one plus the burst size scaled to bytes
+      rx_next_addr                     <= rx_next_addr + {next_burst_size, 2'b00};
 
-          // The words remaining is the current value minus the next burst size
-          remaining_word_count         <= remaining_word_count - next_burst_size;
-        end
-      end
+      // The words remaining is the current value minus the burst size
+      remaining_word_count             <= remaining_word_count - next_burst_size;
     end
 
-    // As data arrives, update rx state.
-    if (rvalid)
+    // Clear the busy flag when all segments are requested and the data has arrived
+    if (rx_done)
     begin
-      rx_outstanding_count             <= rx_outstanding_count - 32'd1;
-
-      // If this is the last expected word, clear the busy flag.
-      if (rx_outstanding_count == 32'd1)
-      begin
-        rbusy                          <= 1'b0;
-      end
+      rbusy                            <= 1'b0;
     end
 
     // As each byte is read over the user interface, keep track
@@ -379,6 +640,13 @@ begin
     if (user_read_byte & user_read_data_valid)
     begin
       user_rd_byte_count               <= user_rd_byte_count + USRPORTWIDTH/8;
+      rx_bytes_read                    <= rx_bytes_read + USRPORTWIDTH/8;
+    end
+
+    // A word dropped for padding restarts the byte count
+    if (rx_word_loaded & ~rx_bytes_left)
+    begin
+      user_rd_byte_count               <= 2'b00;
     end
 
     // When a user request to clear, reset all the relevant state
@@ -388,8 +656,12 @@ begin
       user_rd_byte_count               <= 2'b00;
       rbusy                            <= 1'b0;
       arvalid                          <= 1'b0;
-      wvalid                           <= 1'b0;
-      awvalid                          <= 1'b0;
+      remaining_word_count             <= 32'd0;
+      rx_outstanding_count             <= 32'd0;
+      rx_fifo_count                    <= {LOG2RXFIFODEPTH+1{1'b0}};
+      rx_word_loaded                   <= 1'b0;
+      rx_bytes_total                   <= 32'd0;
+      rx_bytes_read                    <= 32'd0;
     end
   end
 end
@@ -397,14 +669,126 @@ end
 // ---------------------------------------------
 // TX Synchronous logic
 // ---------------------------------------------
+
 always @(posedge clk `RESET)
 begin
   if (reset_n == 1'b0)
   begin
+    tbusy                              <= 1'b0;
+    tx_sg_job                          <= 1'b0;
+    tx_flushed                         <= 1'b0;
+    tx_pack                            <= 24'h0;
+    tx_byte_count                      <= 2'b00;
+    tx_remaining_words                 <= 32'd0;
+    tx_fifo_count                      <= {LOG2TXFIFODEPTH+1{1'b0}};
+    tx_word_loaded                     <= 1'b0;
+    wr_beats_left                      <= {LOG2MAXAXIBURST+1{1'b0}};
+    b_outstanding_count                <= 16'd0;
+    tx_out_len                         <= 32'd0;
+    tx_overflow                        <= 1'b0;
+    awvalid                            <= 1'b0;
   end
   else
   begin
+    // Default awvalid state is to clear unless set and awready not asserted
+    awvalid                            <= (awvalid & ~awready);
+
+    tx_fifo_count                      <= tx_fifo_count + (tx_fifo_wr ? 1 : 0) - (tx_fifo_rd ? 1 : 0);
+    tx_word_loaded                     <= tx_fifo_rd | (tx_word_loaded & ~tx_beat & ~tx_drop);
+    b_outstanding_count                <= b_outstanding_count + (tx_issue ? 1 : 0) - ((bvalid & bready) ? 1 : 0);
+
+    // If start asserted and not already busy, load the output buffer as a single segment,
+    // or mark it for the first segment to be loaded from the list.
+    if (job_start)
+    begin
+      tbusy                            <= 1'b1;
+      tx_sg_job                        <= tx_sg;
+      tx_flushed                       <= 1'b0;
+      tx_pack                          <= 24'h0;
+      tx_byte_count                    <= 2'b00;
+      tx_next_addr                     <= tx_start_addr_int;
+      tx_remaining_words               <= tx_sg ? 32'd0 : {2'b00, tx_len[31:2]}; // Round down
+      tx_out_len                       <= 32'd0;
+      tx_overflow                      <= 1'b0;
+    end
+
+    // Pack accepted output bytes, little endian, into words for the TX fifo
+    if (tx_byte_accept)
+    begin
+      tx_out_len                       <= tx_out_len + 32'd1;
+      tx_byte_count                    <= tx_byte_count + 2'b01;
+
+      if (tx_pack_full)
+      begin
+        tx_pack                        <= 24'h0;
+      end
+      else
+      begin
+        tx_pack[tx_byte_count*8 +: 8]  <= user_write_data;
+      end
+    end
+
+    // On the flush, any partial word has been pushed, and no more bytes are accepted
+    if (tx_flush_now)
+    begin
+      tx_flushed                       <= 1'b1;
+      tx_pack                          <= 24'h0;
+      tx_byte_count                    <= 2'b00;
+    end
+
+    // Load the next segment from the list when the current one is full
+    if (tx_seg_load)
+    begin
+      tx_next_addr                     <= tx_seg_head_addr;
+      tx_remaining_words               <= {2'b00, tx_seg_head_len[31:2]}; // Round down
+    end
+
+    // Send a write command for the next burst of available data
+    if (tx_issue)
+    begin
+      awvalid                          <= 1'b1;
+      awaddr                           <= tx_next_addr | (coherent ? ACPWINBASE : 32'h0);
+
+      // AWLEN is burst size - 1
+      awlen                            <= tx_issue_size - 1;
+
+      wr_beats_left                    <= tx_issue_size;
+      tx_next_addr                     <= tx_next_addr + {tx_issue_size, 2'b00};
+      tx_remaining_words               <= tx_remaining_words - tx_issue_size;
+    end
+
+    if (tx_beat)
+    begin
+      wr_beats_left                    <= wr_beats_left - 1;
+    end
+
+    if (tx_drop)
+    begin
+      tx_overflow                      <= 1'b1;
+    end
+
+    // Clear the busy flag when flushed and all the output is written
+    if (tx_done)
+    begin
+      tbusy                            <= 1'b0;
+    end
+
+    // When a user request to clear, reset all the relevant state
+    // to an idle condition.
+    if (clear)
+    begin
+      tbusy                            <= 1'b0;
+      tx_flushed                       <= 1'b0;
+      tx_pack                          <= 24'h0;
+      tx_byte_count                    <= 2'b00;
+      tx_remaining_words               <= 32'd0;
+      tx_fifo_count                    <= {LOG2TXFIFODEPTH+1{1'b0}};
+      tx_word_loaded                   <= 1'b0;
+      wr_beats_left                    <= {LOG2MAXAXIBURST+1{1'b0}};
+      b_outstanding_count              <= 16'd0;
+      awvalid                          <= 1'b0;
+    end
   end
 end
 
-endmodule
\ No newline at end of file
+endmodule
@@ -9,6 +9,13 @@
 // -----------------------------------------------------------------------------
 //  Description:
 //  This file contains the top level functionality for the SLZW codec
+//
+//  The CSR registers, AXI master and event trace run on clk, and the
+//  dictionary, ratio monitor and checksum on core_clk, which may be
+//  asynchronous to it. Bytes cross between the AXI master's user ports and
+//  the core through asynchronous FIFOs, and control and status through
+//  synchronisers (see slzw_lib.v). Connect core_clk to clk, and
+//  core_reset_n to reset_n, for a single clock codec.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2022 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -36,16 +43,29 @@
 
 module slzw_codec
 #(parameter
-  MEMSIZE                      = 10240,
+  CWMAX                        = 12,      // Maximum codeword width (9 to 16)
+  MEMSIZE                      = (5 * (1 << CWMAX)) / 2,
+  CHECKGAP                     = 10000,   // Input bytes per compression ratio check for adaptive reset policy
+  TRACEDEPTH                   = 512,     // Event trace FIFO entries
+  SGDEPTH                      = 16,      // Scatter-gather segments per input and output list
+  CHECKSUM                     = 1,       // Include the uncompressed data checksum unit
+  AFIFODEPTH                   = 16,      // Clock crossing byte FIFO depths (power of 2, >= 4)
   ARUSER                       = 1'b1,    // If Cacheable accesses required, this must be 1
-  ARCACHE                      = 4'b1110  // For cacheable accesses, bit 3 must be 1, and the rest a valid value as per A4.4 of AXI4 spec.
+  ARCACHE                      = 4'b1110, // For cacheable accesses, bit 3 must be 1, and the rest a valid value as per A4.4 of AXI4 spec.
+  AWUSER                       = 1'b1,    // As ARUSER, for writes
+  AWCACHE                      = 4'b1110, // As ARCACHE, for writes
+  ACPWINBASE                   = 32'h0    // Address offset of the ACP window for coherent (en_acp_win) jobs
 )
 (
   input                        clk,
   input                        reset_n,
 
+  // Core clock and its synchronous reset
+  input                        core_clk,
+  input                        core_reset_n,
+
   // --- Avalon CSR slave interface --
-  input  [3:0]                 avs_csr_address,
+  input  [4:0]                 avs_csr_address,
   input                        avs_csr_write,
   input  [31:0]                avs_csr_writedata,
   input                        avs_csr_read,
@@ -54,9 +74,11 @@ module slzw_codec
   // --- AXI-4 bus ---
 
   // AXI write address bus.
-  // Optional signals, unused: AWID, AWREGION, AWSIZE, AWBURST, AWLOCK, AWCACHE, AWQOS
+  // Optional signals, unused: AWID, AWREGION, AWSIZE, AWBURST, AWLOCK, AWQOS
   output [31:0]                axm_awaddr,
   output  [7:0]                axm_awlen,   // Optional. Default length 1 (AWLEN == 0)
+  output  [3:0]                axm_awcache, // Optional. Used for cache coherency
+  output                       axm_awuser,  // Optional. Used for cache coherency
   output  [2:0]                axm_awprot,
   output                       axm_awvalid,
   input                        axm_awready,
@@ -100,25 +122,147 @@ wire                           control_mode;
 wire                           control_clr;
 wire                           control_start;
 wire                           control_disable_flush;
+wire                           control_reset_policy;
+wire                           control_rx_sg;
+wire                           control_tx_sg;
+wire                           control_csum_adler;
 
 wire                           status_finished;
+wire                           status_tx_overflow;
 
 wire [31:0]                    rx_start_addr;
 wire [31:0]                    rx_len;
 wire [31:0]                    tx_start_addr;
 wire [31:0]                    tx_len;
+wire [31:0]                    tx_out_len;
 wire                           busy;
 
+wire [31:0]                    sg_addr;
+wire [31:0]                    sg_len;
+wire                           sg_control_rx_push;
+wire                           sg_control_tx_push;
+wire                           sg_control_clr;
+
+wire  [7:0]                    usr_rd_data;
+wire                           usr_rd_valid;
+wire                           usr_wr_byte;
+wire  [7:0]                    usr_wr_data;
+wire                           usr_wr_ready;
+wire [31:0]                    checksum;
+reg  [31:0]                    checksum_sync_r;
+wire                           busy_all;
+reg                            job_active_r;
+reg  [31:0]                    job_cycles_r;
+
+// Clock domain crossings
+wire                           rx_afifo_wfull;
+wire                           rx_afifo_wempty;
+wire                           tx_afifo_rempty;
+wire                           start_sync_busy;
+wire                           out_done;
+
+wire                           dict_full;
+wire                           dict_clr;
+
+// Core clock domain
+wire                           core_mode;
+wire                           core_reset_policy;
+wire                           core_csum_adler;
+wire                           core_clr;
+wire                           core_start;
+wire  [7:0]                    core_rd_data;
+wire                           core_rd_empty;
+wire                           core_rd_byte;
+wire  [7:0]                    core_wr_data;
+wire                           core_wr_byte;
+wire                           core_wr_full;
+wire                           core_out_done;
+wire [31:0]                    core_checksum;
+wire                           core_dict_full;
+wire  [4:0]                    core_dict_code_len;
+wire                           core_ratio_reset_req;
+wire                           core_dict_clr;
+
+wire                           trace_control_enable;
+wire                           trace_control_pop;
+wire                           trace_control_clr_overflow;
+wire                           trace_status_empty;
+wire                           trace_status_overflow;
+wire [31:0]                    trace_time;
+wire [31:0]                    trace_event;
+wire                           rx_fifo_empty;
+wire                           rx_fifo_full;
+
 // -----------------------------------------------------------------------------
 // TIE OFF signals
 // -----------------------------------------------------------------------------
 
-// STATUS
-assign status_finished         = ~busy;
+// STATUS. Busy until the input has crossed to the core and a job start has
+// reached it, as well as whilst the AXI master is busy.
+assign busy_all                = busy | ~rx_afifo_wempty | start_sync_busy;
+assign status_finished         = ~busy_all;
+
+// The dictionary is cleared on request, or when the adaptive reset
+// policy detects a degraded compression ratio (clear code issued)
+assign core_dict_clr           = core_clr | core_ratio_reset_req;
 
 // Byte address values are word aligned
 assign rx_start_addr[1:0]      = 2'b00;
 assign tx_start_addr[1:0]      = 2'b00;
+assign sg_addr[1:0]            = 2'b00;
+
+// Until the codec data path is connected, input is consumed as it arrives
+// and there is no output
+assign core_rd_byte            = 1'b1;
+assign core_wr_byte            = 1'b0;
+assign core_wr_data            = 8'h00;
+assign core_out_done           = 1'b1;
+
+// Output bytes are available to the AXI master whilst its crossing FIFO is
+// not empty, and it may flush once the core has finished and the FIFO drained
+assign usr_wr_byte             = ~tx_afifo_rempty;
+
+// The checksum is captured only whilst idle, when the core's value is stable
+always @(posedge clk or negedge reset_n)
+begin
+  if (reset_n == 1'b0)
+  begin
+    checksum_sync_r            <= 32'h0;
+  end
+  else
+  begin
+    if (~busy_all)
+    begin
+      checksum_sync_r          <= core_checksum;
+    end
+  end
+end
+
+assign checksum                = checksum_sync_r;
+
+// Job cycle counter, from the start until finished is next seen. The count
+// is held until the next start, for the driver's job telemetry.
+always @(posedge clk or negedge reset_n)
+begin
+  if (reset_n == 1'b0)
+  begin
+    job_active_r               <= 1'b0;
+    job_cycles_r               <= 32'h0;
+  end
+  else
+  begin
+    if (control_start & ~busy_all)
+    begin
+      job_active_r             <= 1'b1;
+      job_cycles_r             <= 32'h1;
+    end
+    else if (job_active_r)
+    begin
+      job_active_r             <= busy_all;
+      job_cycles_r             <= job_cycles_r + {31'h0, busy_all};
+    end
+  end
+end
 
 // -----------------------------------------------------------------------------
 // Local CSR registers
@@ -126,26 +270,53 @@ assign tx_start_addr[1:0]      = 2'b00;
 
   slzw_codec_csr_regs
   #(
-    .ADDR_DECODE_WIDTH         (4)
+    .ADDR_DECODE_WIDTH         (5)
   ) slzw_codec_csr_regs_i
   (
     .clk                       (clk),
-    .rst_n                     (rst_n),
+    .rst_n                     (reset_n),
 
     .control_en_acp_win        (control_en_acp_win),
     .control_mode              (control_mode),
     .control_clr               (control_clr),
     .control_start             (control_start),
     .control_disable_flush     (control_disable_flush),
+    .control_reset_policy      (control_reset_policy),
+    .control_rx_sg             (control_rx_sg),
+    .control_tx_sg             (control_tx_sg),
+    .control_csum_adler        (control_csum_adler),
 
     .status_finished           (status_finished),
+    .status_tx_overflow        (status_tx_overflow),
+
+    .config_max_cw             (CWMAX[4:0]),
+    .config_mem_size           (MEMSIZE[19:0]),
+    .config_sg_depth           (SGDEPTH[5:0]),
+    .config_checksum           (CHECKSUM != 0),
 
     .rx_start_addr_word        (rx_start_addr[31:2]),
     .rx_len                    (rx_len),
     .tx_start_addr_word        (tx_start_addr[31:2]),
     .tx_len                    (tx_len),
 
-    .avs_address               (avs_csr_address[3:0]),
+    .trace_control_enable      (trace_control_enable),
+    .trace_control_pop         (trace_control_pop),
+    .trace_control_clr_overflow(trace_control_clr_overflow),
+    .trace_status_empty        (trace_status_empty),
+    .trace_status_overflow     (trace_status_overflow),
+    .trace_time                (trace_time),
+    .trace_event               (trace_event),
+
+    .sg_addr_word              (sg_addr[31:2]),
+    .sg_len                    (sg_len),
+    .sg_control_rx_push        (sg_control_rx_push),
+    .sg_control_tx_push        (sg_control_tx_push),
+    .sg_control_clr            (sg_control_clr),
+    .tx_out_len                (tx_out_len),
+    .checksum                  (checksum),
+    .job_cycles                (job_cycles_r),
+
+    .avs_address               (avs_csr_address[4:0]),
     .avs_write                 (avs_csr_write),
     .avs_writedata             (avs_csr_writedata),
     .avs_read                  (avs_csr_read),
@@ -158,46 +329,77 @@ assign tx_start_addr[1:0]      = 2'b00;
 
   slzw_dict
   #(
+    .CWMAX                     (CWMAX),
     .MEMSIZE                   (MEMSIZE)
   ) slzw_dict_i
   (
-    .clk                       (clk),
-    .reset_n                   (reset_n),
+    .clk                       (core_clk),
+    .reset_n                   (core_reset_n),
 
     // Dictionary clear control
-    .clr                       (control_clr),
+    .clr                       (core_dict_clr),
 
     // Mode
-    .compress                  (control_mode),
+    .compress                  (core_mode),
+    .adaptive                  (core_reset_policy),
 
     // Entry match port (compress)
     .match                     (1'b0),
-    .match_code                (12'h000),
+    .match_code                ({CWMAX{1'b0}}),
     .match_byte                (8'h00),
     .matched                   (),
     .matched_valid             (),
 
     // Build entry port (decompress)
     .build_entry               (1'b0),
-    .build_code                (12'h000),
+    .build_code                ({CWMAX{1'b0}}),
     .build_byte                (8'h00),
 
     // Read Port (decompress)
-    .dict_decomp_ptr           (12'h000),
+    .dict_decomp_ptr           ({CWMAX{1'b0}}),
     .dict_code                 (),
     .dict_byte                 (),
 
-    .op_code_len               ()
+    .op_code_len               (core_dict_code_len),
+    .full                      (core_dict_full)
 
   );
 
+// -----------------------------------------------------------------------------
+// Compression ratio monitor for adaptive dictionary reset policy
+// -----------------------------------------------------------------------------
+
+  slzw_ratio_mon
+  #(
+    .CHECKGAP                  (CHECKGAP)
+  ) slzw_ratio_mon_i
+  (
+    .clk                       (core_clk),
+    .reset_n                   (core_reset_n),
+
+    .clr                       (core_dict_clr),
+    .enable                    (core_reset_policy & core_mode & core_dict_full),
+
+    .in_byte                   (1'b0),
+    .out_code                  (1'b0),
+    .code_len                  (core_dict_code_len),
+
+    .reset_req                 (core_ratio_reset_req)
+  );
+
 // -----------------------------------------------------------------------------
 // AXI Memory interface
 // -----------------------------------------------------------------------------
 
   slzw_axi4_master 
   # (
-    .USRPORTWIDTH              (8)
+    .USRPORTWIDTH              (8),
+    .DEFAULTARUSER             (ARUSER),
+    .DEFAULTARCACHE            (ARCACHE),
+    .DEFAULTAWUSER             (AWUSER),
+    .DEFAULTAWCACHE            (AWCACHE),
+    .ACPWINBASE                (ACPWINBASE),
+    .SGDEPTH                   (SGDEPTH)
   )
   slzw_axi4_master_i
   (
@@ -208,25 +410,43 @@ assign tx_start_addr[1:0]      = 2'b00;
 
     .clear                     (control_clr),
     .start                     (control_start),
+    .coherent                  (control_en_acp_win),
     .busy                      (busy),
 
+    .rx_fifo_empty             (rx_fifo_empty),
+    .rx_fifo_full              (rx_fifo_full),
+
     .rx_start_addr             (rx_start_addr),
     .rx_len                    (rx_len),
     .tx_start_addr             (tx_start_addr),
     .tx_len                    (tx_len),
 
+    .rx_sg                     (control_rx_sg),
+    .tx_sg                     (control_tx_sg),
+    .sg_addr                   (sg_addr),
+    .sg_len                    (sg_len),
+    .sg_rx_push                (sg_control_rx_push),
+    .sg_tx_push                (sg_control_tx_push),
+    .sg_clr                    (sg_control_clr),
+
+    .tx_out_len                (tx_out_len),
+    .tx_overflow               (status_tx_overflow),
+
     // User application ports
-    .user_read_byte            (1'b1),
-    .user_read_data            (),
-    .user_read_data_valid      (),
+    .user_read_byte            (~rx_afifo_wfull),
+    .user_read_data            (usr_rd_data),
+    .user_read_data_valid      (usr_rd_valid),
 
-    .user_write_byte           (1'b0),
-    .user_write_data           (8'h00),
-    .user_write_ready          (),
+    .user_write_byte           (usr_wr_byte),
+    .user_write_data           (usr_wr_data),
+    .user_write_flush          (out_done & tx_afifo_rempty),
+    .user_write_ready          (usr_wr_ready),
 
     // --- AXI-4 bus ---
     .awaddr                    (axm_awaddr),
     .awlen                     (axm_awlen),
+    .awcache                   (axm_awcache),
+    .awuser                    (axm_awuser),
     .awprot                    (axm_awprot),
     .awvalid                   (axm_awvalid),
     .awready                   (axm_awready),
@@ -248,4 +468,185 @@ assign tx_start_addr[1:0]      = 2'b00;
     .rready                    (axm_rready)
   );
 
-endmodule
\ No newline at end of file
+// -----------------------------------------------------------------------------
+// Clock domain crossings between the AXI master (clk) and the core (core_clk)
+// -----------------------------------------------------------------------------
+
+  // Input bytes, from the AXI master to the core
+  slzw_async_fifo
+  #(
+    .DEPTH                     (AFIFODEPTH),
+    .WIDTH                     (8)
+  ) rx_afifo_i
+  (
+    .wclk                      (clk),
+    .wreset_n                  (reset_n),
+    .write                     (usr_rd_valid & ~rx_afifo_wfull),
+    .wdata                     (usr_rd_data),
+    .wfull                     (rx_afifo_wfull),
+    .wempty                    (rx_afifo_wempty),
+
+    .rclk                      (core_clk),
+    .rreset_n                  (core_reset_n),
+    .read                      (core_rd_byte),
+    .rdata                     (core_rd_data),
+    .rempty                    (core_rd_empty)
+  );
+
+  // Output bytes, from the core to the AXI master
+  slzw_async_fifo
+  #(
+    .DEPTH                     (AFIFODEPTH),
+    .WIDTH                     (8)
+  ) tx_afifo_i
+  (
+    .wclk                      (core_clk),
+    .wreset_n                  (core_reset_n),
+    .write                     (core_wr_byte),
+    .wdata                     (core_wr_data),
+    .wfull                     (core_wr_full),
+    .wempty                    (),
+
+    .rclk                      (clk),
+    .rreset_n                  (reset_n),
+    .read                      (usr_wr_ready),
+    .rdata                     (usr_wr_data),
+    .rempty                    (tx_afifo_rempty)
+  );
+
+  // Control register fields, which are only changed between jobs
+  slzw_sync
+  #(
+    .WIDTH                     (3)
+  ) ctrl_sync_i
+  (
+    .clk                       (core_clk),
+    .reset_n                   (core_reset_n),
+    .d                         ({control_mode, control_reset_policy, control_csum_adler}),
+    .q                         ({core_mode,    core_reset_policy,    core_csum_adler})
+  );
+
+  // Dictionary clear and job start strobes. A clear written whilst the
+  // last is still crossing is dropped, which is harmless as the pending
+  // clear lands after both writes. Starts are held off whilst busy.
+  slzw_pulse_sync clr_sync_i
+  (
+    .src_clk                   (clk),
+    .src_reset_n               (reset_n),
+    .pulse_in                  (control_clr),
+    .busy                      (),
+
+    .dst_clk                   (core_clk),
+    .dst_reset_n               (core_reset_n),
+    .pulse_out                 (core_clr)
+  );
+
+  slzw_pulse_sync start_sync_i
+  (
+    .src_clk                   (clk),
+    .src_reset_n               (reset_n),
+    .pulse_in                  (control_start & ~busy_all),
+    .busy                      (start_sync_busy),
+
+    .dst_clk                   (core_clk),
+    .dst_reset_n               (core_reset_n),
+    .pulse_out                 (core_start)
+  );
+
+  // Core status, for output flushing and the event trace
+  slzw_sync
+  #(
+    .WIDTH                     (2)
+  ) status_sync_i
+  (
+    .clk                       (clk),
+    .reset_n                   (reset_n),
+    .d                         ({core_out_done, core_dict_full}),
+    .q                         ({out_done,      dict_full})
+  );
+
+  // Dictionary resets, for the event trace only. A reset within the
+  // synchroniser's round trip of the last is dropped, and not traced.
+  slzw_pulse_sync dict_clr_sync_i
+  (
+    .src_clk                   (core_clk),
+    .src_reset_n               (core_reset_n),
+    .pulse_in                  (core_dict_clr),
+    .busy                      (),
+
+    .dst_clk                   (clk),
+    .dst_reset_n               (reset_n),
+    .pulse_out                 (dict_clr)
+  );
+
+// -----------------------------------------------------------------------------
+// Uncompressed data checksum, over the bytes consumed when compressing, or
+// produced when decompressing. Restarted at each job start.
+// -----------------------------------------------------------------------------
+
+generate
+if (CHECKSUM != 0)
+begin : csum_g
+
+  slzw_checksum slzw_checksum_i
+  (
+    .clk                       (core_clk),
+    .reset_n                   (core_reset_n),
+
+    .clr                       (core_start),
+    .adler                     (core_csum_adler),
+
+    .valid                     (core_mode ? (core_rd_byte & ~core_rd_empty) : (core_wr_byte & ~core_wr_full)),
+    .data                      (core_mode ? core_rd_data : core_wr_data),
+
+    .checksum                  (core_checksum)
+  );
+
+end
+else
+begin : no_csum_g
+
+  assign core_checksum         = 32'h0;
+
+end
+endgenerate
+
+// -----------------------------------------------------------------------------
+// Event trace
+// -----------------------------------------------------------------------------
+
+  slzw_trace
+  #(
+    .DEPTH                     (TRACEDEPTH)
+  ) slzw_trace_i
+  (
+    .clk                       (clk),
+    .reset_n                   (reset_n),
+
+    .enable                    (trace_control_enable),
+
+    .start                     (control_start),
+    .busy                      (busy_all),
+    .arvalid                   (axm_arvalid),
+    .arready                   (axm_arready),
+    .arlen                     (axm_arlen),
+    .rvalid                    (axm_rvalid),
+    .awvalid                   (axm_awvalid),
+    .awready                   (axm_awready),
+    .awlen                     (axm_awlen),
+    .bvalid                    (axm_bvalid),
+    .bready                    (axm_bready),
+    .rx_empty                  (rx_fifo_empty),
+    .rx_full                   (rx_fifo_full),
+    .dict_clr                  (dict_clr),
+    .dict_full                 (dict_full),
+
+    .pop                       (trace_control_pop),
+    .clr_overflow              (trace_control_clr_overflow),
+    .trace_time                (trace_time),
+    .trace_event               (trace_event),
+    .empty                     (trace_status_empty),
+    .overflow                  (trace_status_overflow)
+  );
+
+endmodule
@@ -36,7 +36,8 @@
 
 module slzw_dict
 #(parameter
-  MEMSIZE                      = 10240
+  CWMAX                        = 12,                      // Maximum codeword width (9 to 16)
+  MEMSIZE                      = (5 * (1 << CWMAX)) / 2   // Dictionary memory entries (10240 for 12 bit codes)
 )
 (
   input                        clk,
@@ -47,24 +48,31 @@ module slzw_dict
   // Mode
   input                        compress,
 
+  // Reset policy. 0 => reset when full, 1 => freeze when full, with
+  // first code reserved for clear codeword (adaptive reset)
+  input                        adaptive,
+
   // Entry match port (compress)
   input                        match,
-  input      [11:0]            match_code,
+  input      [CWMAX-1:0]       match_code,
   input       [7:0]            match_byte,
   output reg                   matched,
   output reg                   matched_valid,
 
   // Build entry port (decompress)
   input                        build_entry,
-  input      [11:0]            build_code,
+  input      [CWMAX-1:0]       build_code,
   input       [7:0]            build_byte,
 
   // Read Port (decompress)
-  input      [11:0]            dict_decomp_ptr,
-  output     [12:0]            dict_code,
+  input      [CWMAX-1:0]       dict_decomp_ptr,
+  output     [CWMAX:0]         dict_code,
   output      [7:0]            dict_byte,
 
-  output reg  [3:0]            op_code_len
+  output reg  [4:0]            op_code_len,
+
+  // Dictionary full (frozen when adaptive)
+  output                       full
 
 );
 
@@ -73,9 +81,13 @@ module slzw_dict
 // -----------------------------------------------------------------------------
 
 // Bounding definitions
-localparam                     MINCWLEN           = 4'd9;
-localparam                     DICTFULL           = 13'h1000;
-localparam                     FIRSTCW            = 13'h0100;
+localparam                     MINCWLEN           = 5'd9;
+localparam                     DICTFULL           = 1 << CWMAX;
+localparam                     FIRSTCW            = 'h0100;
+localparam                     CLRCW              = 'h0100;
+
+// Address width of dictionary memory (as output by hash)
+localparam                     ADDRWIDTH          = CWMAX + 2;
 
 // FSM state definitions
 localparam                     state_idle         = 3'd0;
@@ -92,16 +104,16 @@ localparam                     state_rehash_retry = 3'd4;
 reg  [2:0]                     state;
 
 // Dictionary state
-reg  [12:0]                    next_avail_code;
-reg  [12:0]                    nac_plus_1;
+reg  [CWMAX:0]                 next_avail_code;
+reg  [CWMAX:0]                 nac_plus_1;
 
 // Holding state for matching final values
-reg  [13:0]                    last_match_addr;
-reg  [13:0]                    last_match_code;
+reg  [ADDRWIDTH-1:0]           last_match_addr;
+reg  [ADDRWIDTH-1:0]           last_match_code;
 reg   [7:0]                    last_match_byte;
 
 // Hashing state
-reg  [13:0]                    seed;
+reg  [ADDRWIDTH-1:0]           seed;
 reg                            rehash;
 reg                            cmp_build;
 reg                            occ_clr;
@@ -111,29 +123,34 @@ reg                            occ_clr;
 // -----------------------------------------------------------------------------
 
 // Next available codeword compare value for generating o/p codewidth
-wire [12:0]                    nac_cmp;
+wire [CWMAX:0]                 nac_cmp;
+
+// Next available codeword value at which o/p codewidth increments
+wire [CWMAX:0]                 nac_width_limit;
 
 // Signalling for writing to dictionary memory
 wire                           wr_dict;
-wire [13:0]                    wr_addr;
-wire [12:0]                    wr_code;
+wire [ADDRWIDTH-1:0]           wr_addr;
+wire [CWMAX:0]                 wr_code;
 wire  [7:0]                    wr_byte;
 
 // Signalling for reading from dictionary memory
-wire [13:0]                    raddr;
+wire [ADDRWIDTH-1:0]           raddr;
 
 // Signalling for rehash locations
-wire [13:0]                    raddr1;
-wire [13:0]                    raddr2;
+wire [ADDRWIDTH-1:0]           raddr1;
+wire [ADDRWIDTH-1:0]           raddr2;
 
 // Signals for hash calculations
-wire [12:0]                    hcode;
-wire [13:0]                    haddr;
-wire [13:0]                    addr1;
-wire [13:0]                    addr2;
+wire [CWMAX:0]                 hcode;
+wire [ADDRWIDTH-1:0]           haddr;
+wire [ADDRWIDTH-1:0]           addr1;
+wire [ADDRWIDTH-1:0]           addr2;
 
 // Signals for dictionary status
 wire                           dict_full;
+wire                           frozen;
+wire [CWMAX:0]                 first_cw;
 
 // Signals for entry status
 wire                           collision;
@@ -147,7 +164,8 @@ wire                           occ_set;
 
   slzw_dictmem
   #(.MEMSIZE                   (MEMSIZE),
-    .WIDTH                     (8)
+    .WIDTH                     (8),
+    .ADDRWIDTH                 (ADDRWIDTH)
   ) dictmem_byte
   (
     .clk                       (clk),
@@ -162,7 +180,8 @@ wire                           occ_set;
 
   slzw_dictmem
   #(.MEMSIZE                   (MEMSIZE),
-    .WIDTH                     (13)
+    .WIDTH                     (CWMAX+1),
+    .ADDRWIDTH                 (ADDRWIDTH)
   ) dictmem_code
   (
     .clk                       (clk),
@@ -176,7 +195,8 @@ wire                           occ_set;
   );
 
   slzw_mem_occupied
-  #(.MEMSIZE                   (MEMSIZE)
+  #(.MEMSIZE                   (MEMSIZE),
+    .ADDRWIDTH                 (ADDRWIDTH)
   ) mem_occ
   (
     .clk                       (clk),
@@ -193,7 +213,8 @@ wire                           occ_set;
   );
 
   slzw_mem_occupied
-  #(.MEMSIZE                   (MEMSIZE)
+  #(.MEMSIZE                   (MEMSIZE),
+    .ADDRWIDTH                 (ADDRWIDTH)
   ) mem_occ_aux
   (
     .clk                       (clk),
@@ -213,24 +234,30 @@ wire                           occ_set;
 // Hash module instantiations
 // -----------------------------------------------------------------------------
 
-  slzw_hash hash_i
+  slzw_hash
+  #(.CWMAX                     (CWMAX)
+  ) hash_i
   (
     .code                      (hcode),
-    .byte                      (match_byte),
+    .byte_in                   (match_byte),
     .haddr                     (haddr)
   );
 
-  slzw_hash seed_hash_1
+  slzw_hash
+  #(.CWMAX                     (CWMAX)
+  ) seed_hash_1
   (
-    .code                      (seed[12:0]),
-    .byte                      (match_byte),
+    .code                      (seed[CWMAX:0]),
+    .byte_in                   (match_byte),
     .haddr                     (addr1)
   );
 
-  slzw_hash seed_hash_2
+  slzw_hash
+  #(.CWMAX                     (CWMAX)
+  ) seed_hash_2
   (
-    .code                      (seed[12:0]),
-    .byte                      (last_match_byte),
+    .code                      (seed[CWMAX:0]),
+    .byte_in                   (last_match_byte),
     .haddr                     (addr2)
   );
 
@@ -238,11 +265,18 @@ wire                           occ_set;
 // Combinatorial Logic
 // -----------------------------------------------------------------------------
 
-// Dictionary full if next_avail_code == 0x1000
-assign dict_full               = next_avail_code[12];
+// Dictionary full if next_avail_code == DICTFULL
+assign dict_full               = next_avail_code[CWMAX];
+
+// Dictionary frozen if seed == 2*DICTFULL
+assign frozen                  = seed[CWMAX+1];
 
-// Dictionary frozen if seed == 0x2000
-assign frozen                  = seed[13];
+// Export full status, which holds when using the adaptive reset policy
+assign full                    = dict_full;
+
+// With the adaptive reset policy, the first code is reserved for a clear
+// codeword, so the first available dictionary code is one more.
+assign first_cw                = adaptive ? (CLRCW + 1) : FIRSTCW;
 
 //assign build_done              = ~compress | (~occ_busy);
 
@@ -261,8 +295,11 @@ assign raddr2                  = addr2;
 // (nac_plus_1).
 assign nac_cmp                 = ~compress ? nac_plus_1              : next_avail_code;
 
-assign hcode                   = (state == state_idle) ? match_code  : dict_code;
-assign collision               = dict_code[12];
+// The codeword width increments when the compare value reaches 2^op_code_len
+assign nac_width_limit         = {{CWMAX{1'b0}}, 1'b1} << op_code_len;
+
+assign hcode                   = (state == state_idle) ? {1'b0, match_code} : dict_code;
+assign collision               = dict_code[CWMAX];
 
 // -----------------------------------------------------------------------------
 // Dictionary state control
@@ -284,30 +321,36 @@ begin
 
     if (clr)
     begin
-      next_avail_code          <= FIRSTCW;
-      nac_plus_1               <= FIRSTCW + 1;
+      next_avail_code          <= first_cw;
+      nac_plus_1               <= first_cw + 1'b1;
+      op_code_len              <= MINCWLEN;
       occ_clr                  <= 1'b1;
     end
     else if (build_entry | cmp_build)
     begin
       if (~dict_full)
       begin
-        next_avail_code        <= next_avail_code + 13'h0001;
-        nac_plus_1             <= nac_plus_1      + 13'h0001;
+        next_avail_code        <= next_avail_code + 1'b1;
+        nac_plus_1             <= nac_plus_1      + 1'b1;
       end
-      else
+      // When adaptive, a full dictionary is frozen until a clear
+      else if (~adaptive)
       begin
-        next_avail_code        <= FIRSTCW;
-        nac_plus_1             <= FIRSTCW+1;
+        next_avail_code        <= first_cw;
+        nac_plus_1             <= first_cw + 1'b1;
         occ_clr                <= 1'b1;
       end
 
-      case (nac_cmp)
-        13'h0200 : op_code_len <= MINCWLEN + 1;
-        13'h0400 : op_code_len <= MINCWLEN + 2;
-        13'h0800 : op_code_len <= MINCWLEN + 3;
-        13'h1000 : op_code_len <= MINCWLEN;
-      endcase
+      // Increment the codeword width each time the next available code reaches
+      // the next power of 2, and restore when the dictionary wraps.
+      if (nac_cmp == DICTFULL)
+      begin
+        op_code_len            <= adaptive ? op_code_len : MINCWLEN;
+      end
+      else if (nac_cmp == nac_width_limit)
+      begin
+        op_code_len            <= op_code_len + 5'd1;
+      end
     end
   end
 end
@@ -323,7 +366,7 @@ begin
     state                      <= state_idle;
     matched_valid              <= 1'b0;
     matched                    <= 1'b0;
-    seed                       <= 14'h0000;
+    seed                       <= {ADDRWIDTH{1'b0}};
 
     rehash                     <= 1'b0;
     cmp_build                  <= 1'b0;
@@ -392,7 +435,7 @@ begin
         
         if (dict_full)
         begin
-          seed                 <= 14'h0000;
+          seed                 <= {ADDRWIDTH{1'b0}};
         end
         state                  <= state_idle;
       end
@@ -402,7 +445,7 @@ begin
         if (~frozen)
         begin
           state                <= state_rehash_retry;
-          seed                 <= seed + 14'd1;
+          seed                 <= seed + 1'b1;
         end
         else
         begin
@@ -417,7 +460,7 @@ begin
         begin
           state                <= state_build;
         end
-        seed                   <= seed + 14'd1;
+        seed                   <= seed + 1'b1;
       end
 
       default:
@@ -430,7 +473,7 @@ begin
       state                    <= state_idle;
       matched_valid            <= 1'b0;
       matched                  <= 1'b0;
-      seed                     <= 14'h0000;
+      seed                     <= {ADDRWIDTH{1'b0}};
       rehash                   <= 1'b0;
       cmp_build                <= 1'b0;
     end
@@ -45,59 +45,157 @@
 // -----------------------------------------------------------------------------
 
 module slzw_hash
+#(parameter
+   CWMAX                       = 12
+)
 (
-  input  [12:0] code,
-  input   [7:0] byte,
+  input      [CWMAX:0]         code,
+  input          [7:0]         byte_in,
 
-  output [13:0] haddr
+  output   [CWMAX+1:0]         haddr
 
  );
 
-wire [13:0] num1 = {1'b0, byte[4:0], byte[7:0]};
-wire [13:0] num2 = {1'b0, code[ 0], code[ 1], code[ 2], code[ 3],
-                          code[ 4], code[ 5], code[ 6], code[ 7],
-                          code[ 8], code[ 9], code[10], code[11],
-                          code[12]};
+// The byte is repeated to fill the code width. For 12 bit codes this
+// gives {byte_in[4:0], byte_in[7:0]}.
+wire         [23:0]            byte_rep = {byte_in, byte_in, byte_in};
+
+wire    [CWMAX+1:0]            num1     = {1'b0, byte_rep[CWMAX:0]};
+wire    [CWMAX+1:0]            num2;
+
+// num2 is the bit reversed code
+genvar idx;
+generate
+  for (idx = 0; idx <= CWMAX; idx = idx + 1)
+  begin : rev_g
+    assign num2[idx]           = code[CWMAX-idx];
+  end
+endgenerate
+
+assign num2[CWMAX+1]           = 1'b0;
 
-assign haddr      = num1 + num2;
+assign haddr                   = num1 + num2;
 
 endmodule
 
 // -----------------------------------------------------------------------------
-// Occupied flag memory
+// Compression ratio monitor
+//
+// Used with the adaptive dictionary reset policy. Whilst enabled (dictionary
+// frozen when full) the input bytes are counted in windows of CHECKGAP bytes,
+// along with the output codeword bits. At the first codeword output after a
+// window completes, the window's output bits are compared with those of the
+// previous window. If greater, the compression ratio has degraded and
+// reset_req is pulsed for a clear code to be issued and the dictionary reset.
 // -----------------------------------------------------------------------------
 
-module slzw_mem_occupied
+module slzw_ratio_mon
 #(parameter
-   MEMSIZE                     = 10240
+   CHECKGAP                    = 10000
 )
 (
   input             clk,
   input             reset_n,
 
   input             clr,
+  input             enable,
 
-  input      [13:0] waddr,
-  input      [13:0] raddr,
-  input             set,
+  input             in_byte,
+  input             out_code,
+  input       [4:0] code_len,
 
-  output            occupied,
-  output            busy
+  output reg        reset_req
+);
+
+reg  [31:0] win_bytes;
+reg  [31:0] win_bits;
+reg  [31:0] last_bits;
+
+wire [31:0] win_bytes_next     = win_bytes + {31'h0, in_byte};
+wire [31:0] win_bits_next      = win_bits  + {27'h0, code_len};
+wire        win_done           = (win_bytes_next >= CHECKGAP) ? 1'b1 : 1'b0;
+wire        degraded           = (last_bits != 32'h0) && (win_bits_next > last_bits);
+
+always @ (posedge clk `RESET)
+begin
+  if (reset_n == 1'b0)
+  begin
+    win_bytes                  <= 32'h0;
+    win_bits                   <= 32'h0;
+    last_bits                  <= 32'h0;
+    reset_req                  <= 1'b0;
+  end
+  else
+  begin
+    reset_req                  <= 1'b0;
+
+    if (clr || !enable)
+    begin
+      win_bytes                <= 32'h0;
+      win_bits                 <= 32'h0;
+      last_bits                <= clr ? 32'h0 : last_bits;
+    end
+    else
+    begin
+      win_bytes                <= win_bytes_next;
+
+      if (out_code)
+      begin
+        win_bits               <= win_bits_next;
+
+        // At the end of a window, compare with the last window and
+        // restart the counts. A degraded window also clears the history.
+        if (win_done)
+        begin
+          reset_req            <= degraded;
+          last_bits            <= degraded ? 32'h0 : win_bits_next;
+          win_bytes            <= 32'h0;
+          win_bits             <= 32'h0;
+        end
+      end
+    end
+  end
+end
+
+endmodule
+
+// -----------------------------------------------------------------------------
+// Occupied flag memory
+// -----------------------------------------------------------------------------
+
+module slzw_mem_occupied
+#(parameter
+   MEMSIZE                     = 10240,
+   ADDRWIDTH                   = 14
+)
+(
+  input                  clk,
+  input                  reset_n,
+
+  input                  clr,
+
+  input  [ADDRWIDTH-1:0] waddr,
+  input  [ADDRWIDTH-1:0] raddr,
+  input                  set,
+
+  output                 occupied,
+  output                 busy
 );
 
 localparam  OCCMEMSIZE         = MEMSIZE/32;
+localparam  CLRCOUNTWIDTH      = $clog2(OCCMEMSIZE+1);
 
-reg  [31:0] occmem [0:OCCMEMSIZE-1];
-reg         set_last;
-reg  [13:0] addr_last;
-reg  [31:0] rval;
-reg         clr_last;
-reg   [8:0] clr_count;
+reg                 [31:0] occmem [0:OCCMEMSIZE-1];
+reg                        set_last;
+reg        [ADDRWIDTH-1:0] addr_last;
+reg                 [31:0] rval;
+reg                        clr_last;
+reg    [CLRCOUNTWIDTH-1:0] clr_count;
 
-wire        out_of_range       = (waddr > (OCCMEMSIZE[13:0]-14'b1)) ? 1'b1 : 1'b0;
+wire        out_of_range       = (waddr > (OCCMEMSIZE[ADDRWIDTH-1:0]-1'b1)) ? 1'b1 : 1'b0;
 
 assign      occupied           = rval[waddr[4:0]] | (set_last && (addr_last == waddr)) | out_of_range;
-assign      busy               = (clr_count > 9'h000);
+assign      busy               = (clr_count != {CLRCOUNTWIDTH{1'b0}});
 
 always @ (posedge clk `RESET)
 begin
@@ -105,7 +203,7 @@ begin
   begin
     set_last                   <= 1'b0;
     clr_last                   <= 1'b0;
-    clr_count                  <= 9'h000;
+    clr_count                  <= {CLRCOUNTWIDTH{1'b0}};
   end
   else
   begin
@@ -117,17 +215,17 @@ begin
     // If a valid address, read the occupied flag memory
     if (!out_of_range)
     begin
-      rval                     <= occmem[raddr[13:5]];
+      rval                     <= occmem[raddr[ADDRWIDTH-1:5]];
     end
 
     // If a rising edge on the clear input, or already clearing, reset the memory
-    if ((clr && !clr_last && clr_count == 9'h000) || busy)
+    if ((clr && !clr_last && !busy) || busy)
     begin
       occmem[clr_count]        <= 32'h00000000;
-      clr_count                <= clr_count + 9'h001;
-      if (clr_count == (OCCMEMSIZE[8:0]-9'd1))
+      clr_count                <= clr_count + 1'b1;
+      if (clr_count == (OCCMEMSIZE[CLRCOUNTWIDTH-1:0]-1'b1))
       begin
-        clr_count              <= 9'h00;
+        clr_count              <= {CLRCOUNTWIDTH{1'b0}};
       end
     end
 
@@ -135,7 +233,7 @@ begin
     // relevant bit of the value just read with 1.
     else if (set_last && !out_of_range)
     begin
-      occmem[addr_last[13:5]]  <= rval | (32'h1 << addr_last[4:0]);
+      occmem[addr_last[ADDRWIDTH-1:5]] <= rval | (32'h1 << addr_last[4:0]);
     end
   end
 end
@@ -149,16 +247,17 @@ endmodule
 module slzw_dictmem
 #(parameter
    MEMSIZE                     = 10240,
-   WIDTH                       = 8
+   WIDTH                       = 8,
+   ADDRWIDTH                   = 14
 )
 (
   input                        clk,
 
-  input           [13:0]       waddr,
+  input      [ADDRWIDTH-1:0]   waddr,
   input                        write,
   input      [WIDTH-1:0]       wdata,
 
-  input           [13:0]       raddr,
+  input      [ADDRWIDTH-1:0]   raddr,
   output reg [WIDTH-1:0]       rdata
 
 );
@@ -323,7 +422,500 @@ begin
       nearly_full              <= (word_count <= NEARLYFULL)   ? 1'b0 : 1'b1;
       full                     <= 1'b0;
     end
+
+    // A clear empties the FIFO, discarding any write or read in the same cycle
+    if (clr)
+    begin
+      wptr                     <= {LOG2DEPTH+1{1'b0}};
+      rptr                     <= {LOG2DEPTH+1{1'b0}};
+      empty                    <= 1'b1;
+      full                     <= 1'b0;
+      nearly_full              <= 1'b0;
+    end
+  end
+end
+
+endmodule
+// -----------------------------------------------------------------------------
+// Event trace
+//
+// Captures codec events, with a free running cycle count timestamp, into a
+// FIFO read over the CSR bus. Each entry is a pair of 32 bit words: the
+// timestamp, and an event word with a bit per event seen in that cycle
+// (bits 15:0) plus the length - 1 of any read (bits 23:16) and write (bits
+// 31:24) burst issued. When the FIFO is full, entries are dropped and the
+// sticky overflow flag set. A pop loads the head entry into trace_time and
+// trace_event.
+//
+// The AXI master has no RLAST, so the read burst lengths issued are queued
+// to flag the completion of each burst from the count of data beats.
+// -----------------------------------------------------------------------------
+
+module slzw_trace
+#(parameter
+   DEPTH                       = 512,
+   LOG2OUTSTANDING             = 5        // Read burst length queue depth
+)
+(
+  input                        clk,
+  input                        reset_n,
+
+  input                        enable,
+
+  // Events
+  input                        start,
+  input                        busy,
+  input                        arvalid,
+  input                        arready,
+  input       [7:0]            arlen,
+  input                        rvalid,
+  input                        awvalid,
+  input                        awready,
+  input       [7:0]            awlen,
+  input                        bvalid,
+  input                        bready,
+  input                        rx_empty,
+  input                        rx_full,
+  input                        dict_clr,
+  input                        dict_full,
+
+  // Trace read interface
+  input                        pop,
+  input                        clr_overflow,
+  output     [31:0]            trace_time,
+  output     [31:0]            trace_event,
+  output                       empty,
+  output reg                   overflow
+);
+
+// Event bits (see slzw_trace.h)
+localparam                     EV_JOB_START   = 0;
+localparam                     EV_JOB_DONE    = 1;
+localparam                     EV_RD_ISSUE    = 2;
+localparam                     EV_RD_DONE     = 3;
+localparam                     EV_WR_ISSUE    = 4;
+localparam                     EV_WR_DONE     = 5;
+localparam                     EV_RX_EMPTY    = 6;
+localparam                     EV_RX_NOTEMPTY = 7;
+localparam                     EV_RX_FULL     = 8;
+localparam                     EV_RX_NOTFULL  = 9;
+localparam                     EV_DICT_RESET  = 10;
+localparam                     EV_DICT_FULL   = 11;
+
+reg  [31:0]                    count;
+reg                            busy_last;
+reg                            rx_empty_last;
+reg                            rx_full_last;
+reg                            dict_full_last;
+
+reg   [7:0]                    rd_len_q [0:(1<<LOG2OUTSTANDING)-1];
+reg  [LOG2OUTSTANDING-1:0]     rd_q_wptr;
+reg  [LOG2OUTSTANDING-1:0]     rd_q_rptr;
+reg   [7:0]                    rd_beat_count;
+
+wire                           fifo_full;
+wire [63:0]                    fifo_rdata;
+
+wire                           ar_issue       = arvalid & arready;
+wire                           aw_issue       = awvalid & awready;
+wire                           rd_done        = rvalid  & (rd_beat_count == rd_len_q[rd_q_rptr]);
+
+wire [15:0]                    events;
+
+assign events[EV_JOB_START]    = start & ~busy;
+assign events[EV_JOB_DONE]     = busy_last & ~busy;
+assign events[EV_RD_ISSUE]     = ar_issue;
+assign events[EV_RD_DONE]      = rd_done;
+assign events[EV_WR_ISSUE]     = aw_issue;
+assign events[EV_WR_DONE]      = bvalid & bready;
+assign events[EV_RX_EMPTY]     = rx_empty & ~rx_empty_last;
+assign events[EV_RX_NOTEMPTY]  = ~rx_empty & rx_empty_last;
+assign events[EV_RX_FULL]      = rx_full & ~rx_full_last;
+assign events[EV_RX_NOTFULL]   = ~rx_full & rx_full_last;
+assign events[EV_DICT_RESET]   = dict_clr;
+assign events[EV_DICT_FULL]    = dict_full & ~dict_full_last;
+assign events[15:12]           = 4'h0;
+
+wire                           capture        = enable & (|events);
+
+assign trace_time              = fifo_rdata[31:0];
+assign trace_event             = fifo_rdata[63:32];
+
+always @ (posedge clk `RESET)
+begin
+  if (reset_n == 1'b0)
+  begin
+    count                      <= 32'h0;
+    busy_last                  <= 1'b0;
+    rx_empty_last              <= 1'b1;
+    rx_full_last               <= 1'b0;
+    dict_full_last             <= 1'b0;
+    rd_q_wptr                  <= {LOG2OUTSTANDING{1'b0}};
+    rd_q_rptr                  <= {LOG2OUTSTANDING{1'b0}};
+    rd_beat_count              <= 8'h00;
+    overflow                   <= 1'b0;
+  end
+  else
+  begin
+    count                      <= count + 32'h1;
+    busy_last                  <= busy;
+    rx_empty_last              <= rx_empty;
+    rx_full_last               <= rx_full;
+    dict_full_last             <= dict_full;
+
+    // Queue the length of each read burst issued, and count the data
+    // beats received against the head burst's length
+    if (ar_issue)
+    begin
+      rd_len_q[rd_q_wptr]      <= arlen;
+      rd_q_wptr                <= rd_q_wptr + 1;
+    end
+
+    if (rvalid)
+    begin
+      rd_beat_count            <= rd_done ? 8'h00 : rd_beat_count + 8'h01;
+      rd_q_rptr                <= rd_done ? rd_q_rptr + 1 : rd_q_rptr;
+    end
+
+    if (capture & fifo_full)
+    begin
+      overflow                 <= 1'b1;
+    end
+
+    if (clr_overflow)
+    begin
+      overflow                 <= 1'b0;
+    end
   end
 end
 
-endmodule
\ No newline at end of file
+  slzw_fifo
+  #(
+     .DEPTH                    (DEPTH),
+     .WIDTH                    (64)
+  ) trace_fifo
+  (
+    .clk                       (clk),
+    .reset_n                   (reset_n),
+
+    .clr                       (1'b0),
+
+    .write                     (capture),
+    .wdata                     ({aw_issue ? awlen : 8'h00, ar_issue ? arlen : 8'h00, events, count}),
+
+    .read                      (pop),
+    .rdata                     (fifo_rdata),
+
+    .empty                     (empty),
+    .full                      (fifo_full),
+    .nearly_full               ()
+  );
+
+endmodule
+
+// -----------------------------------------------------------------------------
+// Checksum
+//
+// Calculates a CRC-32 (IEEE 802.3, reflected, as zlib's crc32()) or Adler-32
+// (RFC 1950) checksum of a byte stream, a byte per cycle. The checksum is
+// restarted by clr. The Adler-32 sums are kept below the modulus with a
+// single conditional subtract, as each addition is of values already below
+// it.
+// -----------------------------------------------------------------------------
+
+module slzw_checksum
+(
+  input                        clk,
+  input                        reset_n,
+
+  input                        clr,
+  input                        adler,     // 0 => CRC-32, 1 => Adler-32
+
+  input                        valid,
+  input       [7:0]            data,
+
+  output     [31:0]            checksum
+);
+
+localparam                     CRCPOLY        = 32'hedb88320;
+localparam                     ADLERMOD       = 17'd65521;
+
+reg  [31:0]                    crc;
+reg  [15:0]                    adler_a;
+reg  [15:0]                    adler_b;
+
+wire [16:0]                    a_sum          = adler_a + data;
+wire [15:0]                    a_next         = (a_sum >= ADLERMOD) ? a_sum - ADLERMOD : a_sum[15:0];
+wire [16:0]                    b_sum          = adler_b + a_next;
+wire [15:0]                    b_next         = (b_sum >= ADLERMOD) ? b_sum - ADLERMOD : b_sum[15:0];
+
+// CRC update for a byte, a bit at a time, LSB first
+function [31:0] crc_byte;
+  input [31:0]                 crc_in;
+  input  [7:0]                 byte_in;
+  integer                      idx;
+begin
+  crc_byte                     = crc_in ^ {24'h0, byte_in};
+
+  for (idx = 0; idx < 8; idx = idx + 1)
+  begin
+    crc_byte                   = crc_byte[0] ? ((crc_byte >> 1) ^ CRCPOLY) : (crc_byte >> 1);
+  end
+end
+endfunction
+
+assign checksum                = adler ? {adler_b, adler_a} : ~crc;
+
+always @(posedge clk `RESET)
+begin
+  if (reset_n == 1'b0)
+  begin
+    crc                        <= 32'hffffffff;
+    adler_a                    <= 16'h0001;
+    adler_b                    <= 16'h0000;
+  end
+  else
+  begin
+    if (clr)
+    begin
+      crc                      <= 32'hffffffff;
+      adler_a                  <= 16'h0001;
+      adler_b                  <= 16'h0000;
+    end
+    else if (valid)
+    begin
+      crc                      <= crc_byte(crc, data);
+      adler_a                  <= a_next;
+      adler_b                  <= b_next;
+    end
+  end
+end
+
+endmodule
+
+// -----------------------------------------------------------------------------
+// Clock domain crossing
+//
+// Modules for crossing between the codec's AXI/CSR clock and its core
+// clock. Synchroniser flops are named sync_r, for timing constraints
+// (see top.sdc): those of the level, pulse and reset synchronisers are
+// false paths, whilst the async FIFO's gray pointer synchronisers
+// (sync_r_rgray and sync_r_wgray) are delay and skew constrained. These
+// use asynchronous resets, independent of the RESET definition, as each
+// side has its own reset.
+// -----------------------------------------------------------------------------
+
+// Reset synchroniser, asserting asynchronously and deasserting synchronously
+// to clk
+
+module slzw_reset_sync
+(
+  input                        clk,
+  input                        reset_n_in,
+  output                       reset_n
+);
+
+reg   [1:0]                    sync_r;
+
+assign reset_n                 = sync_r[1];
+
+always @(posedge clk or negedge reset_n_in)
+begin
+  if (reset_n_in == 1'b0)
+  begin
+    sync_r                     <= 2'b00;
+  end
+  else
+  begin
+    sync_r                     <= {sync_r[0], 1'b1};
+  end
+end
+
+endmodule
+
+// Two flop synchroniser, for levels. A multi-bit value must be a gray code or
+// only change when not sampled.
+
+module slzw_sync
+#(parameter
+   WIDTH                       = 1
+)
+(
+  input                        clk,
+  input                        reset_n,
+
+  input      [WIDTH-1:0]       d,
+  output reg [WIDTH-1:0]       q
+);
+
+reg  [WIDTH-1:0]               sync_r;
+
+always @(posedge clk or negedge reset_n)
+begin
+  if (reset_n == 1'b0)
+  begin
+    sync_r                     <= {WIDTH{1'b0}};
+    q                          <= {WIDTH{1'b0}};
+  end
+  else
+  begin
+    sync_r                     <= d;
+    q                          <= sync_r;
+  end
+end
+
+endmodule
+
+// Single cycle pulse synchroniser. A source pulse flips a toggle, and its
+// change, once synchronised, is a destination pulse. The synchronised toggle
+// is returned as an acknowledge, with busy set until it arrives. Source
+// pulses whilst busy are lost.
+
+module slzw_pulse_sync
+(
+  input                        src_clk,
+  input                        src_reset_n,
+  input                        pulse_in,
+  output                       busy,
+
+  input                        dst_clk,
+  input                        dst_reset_n,
+  output                       pulse_out
+);
+
+reg                            src_toggle;
+reg   [1:0]                    ack_sync_r;
+reg                            sync_r;
+reg   [1:0]                    dst_toggle;
+
+assign pulse_out               = dst_toggle[1] ^ dst_toggle[0];
+assign busy                    = src_toggle ^ ack_sync_r[1];
+
+always @(posedge src_clk or negedge src_reset_n)
+begin
+  if (src_reset_n == 1'b0)
+  begin
+    src_toggle                 <= 1'b0;
+    ack_sync_r                 <= 2'b00;
+  end
+  else
+  begin
+    src_toggle                 <= src_toggle ^ (pulse_in & ~busy);
+    ack_sync_r                 <= {ack_sync_r[0], dst_toggle[0]};
+  end
+end
+
+always @(posedge dst_clk or negedge dst_reset_n)
+begin
+  if (dst_reset_n == 1'b0)
+  begin
+    sync_r                     <= 1'b0;
+    dst_toggle                 <= 2'b00;
+  end
+  else
+  begin
+    sync_r                     <= src_toggle;
+    dst_toggle                 <= {dst_toggle[0], sync_r};
+  end
+end
+
+endmodule
+
+// Asynchronous FIFO, with gray coded pointers synchronised across the
+// clock domains. Read data is valid whilst not empty (first word fall
+// through). The write side also flags empty, from its synchronised copy of
+// the read pointer, which lags the read side by the synchroniser delay.
+// DEPTH must be a power of 2, and at least 4.
+
+module slzw_async_fifo
+#(parameter
+   DEPTH                       = 16,
+   WIDTH                       = 8
+)
+(
+  input                        wclk,
+  input                        wreset_n,
+  input                        write,
+  input      [WIDTH-1:0]       wdata,
+  output                       wfull,
+  output                       wempty,
+
+  input                        rclk,
+  input                        rreset_n,
+  input                        read,
+  output     [WIDTH-1:0]       rdata,
+  output                       rempty
+);
+
+localparam                     LOG2DEPTH = $clog2(DEPTH);
+
+reg  [WIDTH-1:0]               mem [0:DEPTH-1];
+
+reg  [LOG2DEPTH:0]             wbin;
+reg  [LOG2DEPTH:0]             wgray;
+reg  [LOG2DEPTH:0]             rbin;
+reg  [LOG2DEPTH:0]             rgray;
+
+// Pointers synchronised to the other side
+reg  [LOG2DEPTH:0]             sync_r_rgray;
+reg  [LOG2DEPTH:0]             wclk_rgray;
+reg  [LOG2DEPTH:0]             sync_r_wgray;
+reg  [LOG2DEPTH:0]             rclk_wgray;
+
+wire [LOG2DEPTH:0]             wbin_next      = wbin + {{LOG2DEPTH{1'b0}}, (write & ~wfull)};
+wire [LOG2DEPTH:0]             rbin_next      = rbin + {{LOG2DEPTH{1'b0}}, (read & ~rempty)};
+
+// Full when the pointers differ only in the wrap bits (the top two bits of the gray code)
+assign wfull                   = (wgray == {~wclk_rgray[LOG2DEPTH:LOG2DEPTH-1], wclk_rgray[LOG2DEPTH-2:0]});
+assign wempty                  = (wgray == wclk_rgray);
+assign rempty                  = (rgray == rclk_wgray);
+
+assign rdata                   = mem[rbin[LOG2DEPTH-1:0]];
+
+always @(posedge wclk)
+begin
+  if (write & ~wfull)
+  begin
+    mem[wbin[LOG2DEPTH-1:0]]   <= wdata;
+  end
+end
+
+always @(posedge wclk or negedge wreset_n)
+begin
+  if (wreset_n == 1'b0)
+  begin
+    wbin                       <= {LOG2DEPTH+1{1'b0}};
+    wgray                      <= {LOG2DEPTH+1{1'b0}};
+    sync_r_rgray               <= {LOG2DEPTH+1{1'b0}};
+    wclk_rgray                 <= {LOG2DEPTH+1{1'b0}};
+  end
+  else
+  begin
+    wbin                       <= wbin_next;
+    wgray                      <= (wbin_next >> 1) ^ wbin_next;
+
+    sync_r_rgray               <= rgray;
+    wclk_rgray                 <= sync_r_rgray;
+  end
+end
+
+always @(posedge rclk or negedge rreset_n)
+begin
+  if (rreset_n == 1'b0)
+  begin
+    rbin                       <= {LOG2DEPTH+1{1'b0}};
+    rgray                      <= {LOG2DEPTH+1{1'b0}};
+    sync_r_wgray               <= {LOG2DEPTH+1{1'b0}};
+    rclk_wgray                 <= {LOG2DEPTH+1{1'b0}};
+  end
+  else
+  begin
+    rbin                       <= rbin_next;
+    rgray                      <= (rbin_next >> 1) ^ rbin_next;
+
+    sync_r_wgray               <= wgray;
+    rclk_wgray                 <= sync_r_wgray;
+  end
+end
+
+endmodule
@@ -0,0 +1,149 @@
+// -----------------------------------------------------------------------------
+//  Title      : Avalon CSR bus round robin arbiter
+// -----------------------------------------------------------------------------
+//  File       : avs_arbiter.v
+//  Author     : Simon Southwell
+//  Created    : 2022-03-14
+//  Platform   :
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  This block shares the test bench CSR bus between several virtual
+//  processor BFMs, so that each VProc node can act as an independent host
+//  thread. One access is granted per cycle, in round robin order starting
+//  after the last master granted, and the other requesting masters are held
+//  off with waitrequest.
+//
+//  The slaves on the CSR bus give no read data valid, returning read data in
+//  the cycle after the read. The arbiter generates the valid for the granted
+//  master, and makes no grant in that cycle, so a read's data can't be
+//  confused with that of a following access.
+//
+//  The master ports are concatenated vectors, with master 0 in the least
+//  significant bits. Up to 16 masters are supported.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+`timescale 1ns / 10ps
+
+module avs_arbiter
+#(parameter
+  NUM_MASTERS                          = 2
+)
+(
+  input                                clk,
+  input                                rst_n,
+
+  // --- Avalon slave ports, from the masters ---
+
+  input  [NUM_MASTERS*32-1:0]          avs_address,
+  input  [NUM_MASTERS-1:0]             avs_write,
+  input  [NUM_MASTERS*32-1:0]          avs_writedata,
+  input  [NUM_MASTERS-1:0]             avs_read,
+  output [31:0]                        avs_readdata,
+  output reg [NUM_MASTERS-1:0]         avs_readdatavalid,
+  output [NUM_MASTERS-1:0]             avs_waitrequest,
+
+  // --- Avalon master port, to the CSR bus ---
+
+  output [31:0]                        avm_address,
+  output                               avm_write,
+  output [31:0]                        avm_writedata,
+  output                               avm_read,
+  input  [31:0]                        avm_readdata
+);
+
+// ---------------------------------------------
+// Signal declarations
+// ---------------------------------------------
+
+reg  [3:0]                             last;           // Last master granted
+reg                                    rd_pending;     // Read data is returned this cycle
+
+reg  [3:0]                             sel;
+reg                                    sel_valid;
+
+wire [NUM_MASTERS-1:0]                 req;
+wire [NUM_MASTERS-1:0]                 grant;
+
+integer                                idx;
+integer                                master;
+
+// ---------------------------------------------
+// Combinatorial logic
+// ---------------------------------------------
+
+assign req                             = avs_read | avs_write;
+
+// Select the first requesting master after the last granted, searching down
+// from the furthest so that the nearest is selected. No grant is made whilst
+// read data is returned.
+always @(*)
+begin
+  sel                                  = 4'h0;
+  sel_valid                            = 1'b0;
+
+  for (idx = NUM_MASTERS; idx > 0; idx = idx - 1)
+  begin
+    master                             = (last + idx) % NUM_MASTERS;
+
+    if (req[master] && !rd_pending)
+    begin
+      sel                              = master;
+      sel_valid                        = 1'b1;
+    end
+  end
+end
+
+assign grant                           = sel_valid ? (1 << sel) : {NUM_MASTERS{1'b0}};
+assign avs_waitrequest                 = req & ~grant;
+
+assign avm_address                     = avs_address[sel*32 +: 32];
+assign avm_writedata                   = avs_writedata[sel*32 +: 32];
+assign avm_write                       = sel_valid & avs_write[sel];
+assign avm_read                        = sel_valid & avs_read[sel];
+
+// Read data is common to all the masters, qualified by their valids
+assign avs_readdata                    = avm_readdata;
+
+// ---------------------------------------------
+// Synchronous logic
+// ---------------------------------------------
+
+always @(posedge clk or negedge rst_n)
+begin
+  if (rst_n == 1'b0)
+  begin
+    last                               <= NUM_MASTERS - 1;
+    rd_pending                         <= 1'b0;
+    avs_readdatavalid                  <= {NUM_MASTERS{1'b0}};
+  end
+  else
+  begin
+    rd_pending                         <= avm_read;
+    avs_readdatavalid                  <= avm_read ? grant : {NUM_MASTERS{1'b0}};
+
+    if (sel_valid)
+    begin
+      last                             <= sel;
+    end
+  end
+end
+
+endmodule
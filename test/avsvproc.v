@@ -11,6 +11,9 @@
 //  Description:
 //  This block is a Virtual processor with Avalon memory mapped master BFM,
 //  based on VProc co-simulation element.
+//
+//  Accesses are held whilst avs_csr_waitrequest is asserted, so that several
+//  BFMs can share a bus through an arbiter. Tie it low for a single BFM.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2022 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -48,6 +51,7 @@ module avsvproc
   output        avs_csr_read,
   input  [31:0] avs_csr_readdata,
   input         avs_csr_readdatavalid,
+  input         avs_csr_waitrequest,
 
   // Interrupt
   input         irq
@@ -66,7 +70,7 @@ wire        RDAck;
 // Avalon  bus protocol signals
 wire       avs_read;
 
-reg RDLast;
+reg RDIssued;
 reg avs_csr_readdatavalid_int;
 
 // If auto-generation of read valid for CSR bus is selected, generate in cycle after avs_csr_read
@@ -80,7 +84,7 @@ if (AUTO_VALID_CSR != 0)
     else
     begin
       avs_csr_readdatavalid_int        <= 1'b0;
-      if (avs_csr_read == 1'b1)
+      if (avs_csr_read == 1'b1 && avs_csr_waitrequest == 1'b0)
       begin
         avs_csr_readdatavalid_int      <= 1'b1;
       end
@@ -113,7 +117,7 @@ assign RDAck                           = avs_csr_readdatavalid_int;
       .RD                              (RD),
       .DataOut                         (DataOut),
       .DataIn                          (DataIn),
-      .WRAck                           (WE),
+      .WRAck                           (WE & ~avs_csr_waitrequest),
       .RDAck                           (RDAck),
       .Interrupt                       ({2'h0,  irq}),
       .Update                          (update),
@@ -122,19 +126,21 @@ assign RDAck                           = avs_csr_readdatavalid_int;
     );
 
   // ---------------------------------------
-  //  Generate a delayed version of the RD
-  //  output of VProc
+  //  Flag when the read for the current RD
+  //  output of VProc has been accepted
   // ---------------------------------------
   always @(posedge clk or negedge rst_n)
   begin
     if (rst_n == 1'b0)
-      RDLast                           <= 1'b0;
-    else                               
-      RDLast                           <= RD;
+      RDIssued                         <= 1'b0;
+    else if (RDAck == 1'b1)
+      RDIssued                         <= 1'b0;
+    else if (avs_read == 1'b1 && avs_csr_waitrequest == 1'b0)
+      RDIssued                         <= 1'b1;
   end
 
-  // Pulse the AVS read signal only for the first cycles of RD, which won't be
+  // Assert the AVS read signal only until accepted, as RD won't be
   // deasserted until the RDAck/avs_readdatavalid is returned.
-  assign avs_read                      = RD & ~RDLast;
+  assign avs_read                      = RD & ~RDIssued;
 
 endmodule
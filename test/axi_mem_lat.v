@@ -0,0 +1,299 @@
+// -----------------------------------------------------------------------------
+//  Title      : AXI memory latency and bandwidth model
+// -----------------------------------------------------------------------------
+//  File       : axi_mem_lat.v
+//  Author     : Simon Southwell
+//  Created    : 2022-03-05
+//  Platform   :
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  This block sits between the core's AXI-4 master and the AXI to Avalon
+//  converter, to give the otherwise ideal memory model the timing of a real
+//  memory port, such as the DE10-nano's F2SDRAM port. It adds programmable
+//  read and write latency, with random jitter, bounds the number of
+//  outstanding transactions, and randomly deasserts the ready signals (and
+//  withholds read data) at a programmable rate to model backpressure and
+//  limit bandwidth.
+//
+//  Read data returned from the memory model, which can't be stalled, is
+//  held in a FIFO and released to the master once the burst's latency has
+//  expired. Read bursts are only accepted when there is room in the FIFO
+//  for all their data. As the converter gives no write responses, these
+//  are generated here, a latency after the last write data.
+//
+//  With all the configuration inputs zero, the only added delay is the
+//  cycle through the read data FIFO.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+`timescale 1ns / 10ps
+
+module axi_mem_lat
+#(parameter
+  LOG2RDFIFODEPTH                      = 10,      // Read data FIFO depth, in words (must be >= 256)
+  LOG2MAXOUTSTANDING                   = 4        // Burst queue depths
+)
+(
+  input                                clk,
+  input                                rst_n,
+
+  // Configuration
+  input  [15:0]                        rd_latency,      // Cycles from read address to first data
+  input  [15:0]                        wr_latency,      // Cycles from last write data to response
+  input   [7:0]                        jitter,          // Random extra latency, 0 to jitter cycles
+  input   [7:0]                        max_outstanding, // Per direction burst limit (0 for queue depth)
+  input   [7:0]                        stall_rate,      // Probability, in 256ths, of a stall each cycle
+
+  // --- AXI-4 slave bus, from the master ---
+
+  input  [31:0]                        axs_awaddr,
+  input   [7:0]                        axs_awlen,
+  input                                axs_awvalid,
+  output                               axs_awready,
+
+  input  [31:0]                        axs_wdata,
+  input                                axs_wlast,
+  input                                axs_wvalid,
+  output                               axs_wready,
+
+  output                               axs_bvalid,
+  input                                axs_bready,
+
+  input  [31:0]                        axs_araddr,
+  input   [7:0]                        axs_arlen,
+  input                                axs_arvalid,
+  output                               axs_arready,
+
+  output [31:0]                        axs_rdata,
+  output                               axs_rvalid,
+  input                                axs_rready,
+
+  // --- AXI-4 master bus, to the memory ---
+
+  output [31:0]                        axm_awaddr,
+  output  [7:0]                        axm_awlen,
+  output                               axm_awvalid,
+  input                                axm_awready,
+
+  output [31:0]                        axm_wdata,
+  output                               axm_wlast,
+  output                               axm_wvalid,
+  input                                axm_wready,
+
+  input                                axm_bvalid,      // Unused, responses generated locally
+  output                               axm_bready,
+
+  output [31:0]                        axm_araddr,
+  output  [7:0]                        axm_arlen,
+  output                               axm_arvalid,
+  input                                axm_arready,
+
+  input  [31:0]                        axm_rdata,
+  input                                axm_rvalid,
+  output                               axm_rready
+);
+
+localparam                             RDFIFODEPTH       = 1 << LOG2RDFIFODEPTH;
+localparam                             MAXOUTSTANDING    = 1 << LOG2MAXOUTSTANDING;
+
+// ---------------------------------------------
+// Registers
+// ---------------------------------------------
+
+reg [31:0]                             cycle;
+
+// Per cycle random stalls
+reg                                    stall_ar;
+reg                                    stall_aw;
+reg                                    stall_r;
+reg                                    stall_w;
+
+// Read data FIFO
+reg [31:0]                             rd_fifo [0:RDFIFODEPTH-1];
+reg [LOG2RDFIFODEPTH-1:0]              rd_fifo_wptr;
+reg [LOG2RDFIFODEPTH-1:0]              rd_fifo_rptr;
+reg [LOG2RDFIFODEPTH:0]                rd_fifo_count;     // Words held
+reg [LOG2RDFIFODEPTH:0]                rd_reserved;       // Words held plus requested
+
+// Read burst queue: beats remaining and release cycle
+reg  [8:0]                             rd_beats   [0:MAXOUTSTANDING-1];
+reg [31:0]                             rd_release [0:MAXOUTSTANDING-1];
+reg [LOG2MAXOUTSTANDING-1:0]           rd_q_wptr;
+reg [LOG2MAXOUTSTANDING-1:0]           rd_q_rptr;
+reg [LOG2MAXOUTSTANDING:0]             rd_outstanding;
+
+// Write response queue: response cycle
+reg [31:0]                             wr_release [0:MAXOUTSTANDING-1];
+reg [LOG2MAXOUTSTANDING-1:0]           wr_q_wptr;
+reg [LOG2MAXOUTSTANDING-1:0]           wr_q_rptr;
+reg [LOG2MAXOUTSTANDING:0]             wr_q_count;        // Responses pending
+reg [LOG2MAXOUTSTANDING:0]             wr_outstanding;    // Addresses accepted without response
+
+// ---------------------------------------------
+// Combinatorial signals
+// ---------------------------------------------
+
+wire [LOG2MAXOUTSTANDING:0]            out_limit         = (max_outstanding == 0 || max_outstanding > MAXOUTSTANDING) ?
+                                                             MAXOUTSTANDING : max_outstanding[LOG2MAXOUTSTANDING:0];
+
+wire                                   ar_allow          = ~stall_ar && rd_outstanding < out_limit &&
+                                                           (rd_reserved + {1'b0, axs_arlen} + 1) <= RDFIFODEPTH;
+wire                                   aw_allow          = ~stall_aw && wr_outstanding < out_limit;
+
+wire                                   ar_accept         = axs_arvalid & axs_arready;
+wire                                   aw_accept         = axs_awvalid & axs_awready;
+wire                                   r_beat            = axs_rvalid  & axs_rready;
+wire                                   w_last            = axs_wvalid  & axs_wready & axs_wlast;
+wire                                   b_resp            = axs_bvalid  & axs_bready;
+
+// ---------------------------------------------
+// Address and data channels
+// ---------------------------------------------
+
+// Read address, passed through when allowed
+assign axm_araddr                      = axs_araddr;
+assign axm_arlen                       = axs_arlen;
+assign axm_arvalid                     = axs_arvalid & ar_allow;
+assign axs_arready                     = axm_arready & ar_allow;
+
+// Read data, from the FIFO once the head burst's latency has expired
+assign axm_rready                      = 1'b1;
+assign axs_rdata                       = rd_fifo[rd_fifo_rptr];
+assign axs_rvalid                      = ~stall_r && rd_outstanding != 0 && rd_fifo_count != 0 &&
+                                         cycle >= rd_release[rd_q_rptr];
+
+// Write address, passed through when allowed
+assign axm_awaddr                      = axs_awaddr;
+assign axm_awlen                       = axs_awlen;
+assign axm_awvalid                     = axs_awvalid & aw_allow;
+assign axs_awready                     = axm_awready & aw_allow;
+
+// Write data, passed through when not stalled
+assign axm_wdata                       = axs_wdata;
+assign axm_wlast                       = axs_wlast;
+assign axm_wvalid                      = axs_wvalid & ~stall_w;
+assign axs_wready                      = axm_wready & ~stall_w;
+
+// Write response, once its latency has expired
+assign axm_bready                      = 1'b1;
+assign axs_bvalid                      = wr_q_count != 0 && cycle >= wr_release[wr_q_rptr];
+
+// ---------------------------------------------
+// Latency with random jitter added
+// ---------------------------------------------
+
+function [31:0] add_jitter;
+  input [15:0] latency;
+  reg   [31:0] rnd;
+begin
+  rnd                                  = $random;
+  add_jitter                           = latency + ((jitter == 0) ? 0 : (rnd[15:0] % (jitter + 1)));
+end
+endfunction
+
+// ---------------------------------------------
+// Process for the model state
+// ---------------------------------------------
+
+always @(posedge clk or negedge rst_n)
+begin
+  if (rst_n == 1'b0)
+  begin
+    cycle                              <= 32'h0;
+    stall_ar                           <= 1'b0;
+    stall_aw                           <= 1'b0;
+    stall_r                            <= 1'b0;
+    stall_w                            <= 1'b0;
+    rd_fifo_wptr                       <= {LOG2RDFIFODEPTH{1'b0}};
+    rd_fifo_rptr                       <= {LOG2RDFIFODEPTH{1'b0}};
+    rd_fifo_count                      <= {LOG2RDFIFODEPTH+1{1'b0}};
+    rd_reserved                        <= {LOG2RDFIFODEPTH+1{1'b0}};
+    rd_q_wptr                          <= {LOG2MAXOUTSTANDING{1'b0}};
+    rd_q_rptr                          <= {LOG2MAXOUTSTANDING{1'b0}};
+    rd_outstanding                     <= {LOG2MAXOUTSTANDING+1{1'b0}};
+    wr_q_wptr                          <= {LOG2MAXOUTSTANDING{1'b0}};
+    wr_q_rptr                          <= {LOG2MAXOUTSTANDING{1'b0}};
+    wr_q_count                         <= {LOG2MAXOUTSTANDING+1{1'b0}};
+    wr_outstanding                     <= {LOG2MAXOUTSTANDING+1{1'b0}};
+  end
+  else
+  begin
+    cycle                              <= cycle + 1;
+
+    // Choose the stalls for the next cycle
+    stall_ar                           <= ({$random} % 256) < stall_rate;
+    stall_aw                           <= ({$random} % 256) < stall_rate;
+    stall_r                            <= ({$random} % 256) < stall_rate;
+    stall_w                            <= ({$random} % 256) < stall_rate;
+
+    // Queue an accepted read burst, reserving its FIFO space
+    if (ar_accept)
+    begin
+      rd_beats[rd_q_wptr]              <= {1'b0, axs_arlen} + 9'h001;
+      rd_release[rd_q_wptr]            <= cycle + add_jitter(rd_latency);
+      rd_q_wptr                        <= rd_q_wptr + 1;
+    end
+
+    rd_reserved                        <= rd_reserved    + (ar_accept ? {1'b0, axs_arlen} + 1 : 0) - (r_beat ? 1 : 0);
+    rd_outstanding                     <= rd_outstanding + (ar_accept ? 1 : 0) -
+                                          ((r_beat && rd_beats[rd_q_rptr] == 9'h001) ? 1 : 0);
+
+    // Store read data from the memory
+    if (axm_rvalid)
+    begin
+      rd_fifo[rd_fifo_wptr]            <= axm_rdata;
+      rd_fifo_wptr                     <= rd_fifo_wptr + 1;
+    end
+
+    rd_fifo_count                      <= rd_fifo_count + (axm_rvalid ? 1 : 0) - (r_beat ? 1 : 0);
+
+    // Release read data to the master
+    if (r_beat)
+    begin
+      rd_fifo_rptr                     <= rd_fifo_rptr + 1;
+
+      if (rd_beats[rd_q_rptr] == 9'h001)
+      begin
+        rd_q_rptr                      <= rd_q_rptr + 1;
+      end
+      else
+      begin
+        rd_beats[rd_q_rptr]            <= rd_beats[rd_q_rptr] - 1;
+      end
+    end
+
+    // Queue a write response a latency after the last data
+    if (w_last)
+    begin
+      wr_release[wr_q_wptr]            <= cycle + add_jitter(wr_latency);
+      wr_q_wptr                        <= wr_q_wptr + 1;
+    end
+
+    if (b_resp)
+    begin
+      wr_q_rptr                        <= wr_q_rptr + 1;
+    end
+
+    wr_q_count                         <= wr_q_count     + (w_last    ? 1 : 0) - (b_resp ? 1 : 0);
+    wr_outstanding                     <= wr_outstanding + (aw_accept ? 1 : 0) - (b_resp ? 1 : 0);
+  end
+end
+
+endmodule
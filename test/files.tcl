@@ -4,9 +4,12 @@
 ../../Vproc/f_VProc.v
 
 avsvproc.v
+avs_arbiter.v
 axi_av_conv.v
+axi_mem_lat.v
 test_auto.vh
 test_csr_decode_auto.v
 test_csr_regs_auto.v
 tb_ctrl.v
+tb_ticket_lock.v
 tb.v
\ No newline at end of file
@@ -8,7 +8,9 @@
 //  Standard   : C++11
 // -----------------------------------------------------------------------------
 //  Description:
-//  This file contains the code for the node 0 VProc main entry point
+//  This file contains the code for the node 0 VProc main entry point, and
+//  the test bench access functions of VUserMain0.h, which are also used by
+//  the client nodes (VUserMainN.cpp)
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2022 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -35,6 +37,7 @@
 
 #include "VUserMain0.h"
 #include "tests.h"
+#include "contention.h"
 #include "utils.h"
 #include "tb.h"
 #include "hal/CTestAuto.h"
@@ -68,8 +71,9 @@ extern "C" {
 // --------------------------------------------------
 // STATIC VARIABLES
 // --------------------------------------------------
-// I'm node 0
-static int node           = 0;
+// I'm node 0. Each VProc node runs on its own thread, so client nodes
+// select themselves, for the access functions, with setNodeSim()
+static thread_local int node = 0;
 
 
 // This must match the test bench system clock period to get accurate sleep times in the software.
@@ -153,6 +157,62 @@ void directWriteMem (uint32_t addr, uint32_t data)
     WriteRamWord(addr/4, data, true, node);
 }
 
+// --------------------------------------------------
+// Read a block of len bytes directly from memory
+// (bypass sim) into buf. addr must be word aligned.
+// --------------------------------------------------
+uint32_t directReadMemBlock (uint32_t addr, uint8_t* buf, uint32_t len)
+{
+    uint32_t words = len / 4;
+    uint32_t tail  = len & 3;
+
+    for (uint32_t idx = 0; idx < words; idx++)
+    {
+        uint32_t word = ReadRamWord(addr/4 + idx, true, node);
+        memcpy(buf + idx*4, &word, 4);
+    }
+
+    if (tail)
+    {
+        uint32_t word = ReadRamWord(addr/4 + words, true, node);
+        memcpy(buf + words*4, &word, tail);
+    }
+
+#ifdef DEBUG
+    VPrint("directReadMemBlock : addr = 0x%08x len = %d\n", addr, len); fflush(NULL);
+#endif
+    return 0;
+}
+
+// --------------------------------------------------
+// Write a block of len bytes from buf directly to
+// memory (bypass sim). addr must be word aligned,
+// and a final partial word is zero padded.
+// --------------------------------------------------
+void directWriteMemBlock (uint32_t addr, const uint8_t* buf, uint32_t len)
+{
+#ifdef DEBUG
+    VPrint("directWriteMemBlock : addr = 0x%08x len = %d\n", addr, len); fflush(NULL);
+#endif
+
+    uint32_t words = len / 4;
+    uint32_t tail  = len & 3;
+
+    for (uint32_t idx = 0; idx < words; idx++)
+    {
+        uint32_t word;
+        memcpy(&word, buf + idx*4, 4);
+        WriteRamWord(addr/4 + idx, word, true, node);
+    }
+
+    if (tail)
+    {
+        uint32_t word = 0;
+        memcpy(&word, buf + words*4, tail);
+        WriteRamWord(addr/4 + words, word, true, node);
+    }
+}
+
 // --------------------------------------------------
 // Simulation control functions
 // --------------------------------------------------
@@ -182,6 +242,16 @@ void nsleepSim(unsigned time)
     VTick(ticks, node);
 }
 
+// --------------------------------------------------
+// Select the node used by the calling thread's
+// test bench accesses
+// --------------------------------------------------
+
+void setNodeSim(int nodeIn)
+{
+    node = nodeIn;
+}
+
 // ==================================================
 // ENTRY POINT TO USER CODE FROM VPROC
 // ==================================================
@@ -214,6 +284,13 @@ extern "C" void VUserMain0()
     // file doesn't exist, no parsing is done.
     parseArgs(0, NULL, cfg);
 
+    // Configure the memory model's timing
+    pTestBench->pMemRdLatency->SetMemRdLatency(cfg.memRdLatency);
+    pTestBench->pMemWrLatency->SetMemWrLatency(cfg.memWrLatency);
+    pTestBench->pMemJitter->SetMemJitter(cfg.memJitter);
+    pTestBench->pMemMaxOutstanding->SetMemMaxOutstanding(cfg.memOutstanding);
+    pTestBench->pMemStallRate->SetMemStallRate(cfg.memStallRate);
+
     usleepSim(1);
 
     // Write to a core register via the HAL
@@ -243,6 +320,13 @@ extern "C" void VUserMain0()
 
         pTest->start(CORE_0_BASE, cfg, node);
 
+        // Run any client nodes' jobs, contending for the codec
+        uint32_t numClients = pTestBench->pConfigClients->GetConfigClients();
+
+        if (numClients)
+        {
+            error |= contention::run(cfg, numClients);
+        }
     }
 
     // Wait a bit
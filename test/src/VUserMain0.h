@@ -59,11 +59,14 @@ void     stopSim                   (bool     error);
 void     finishSim                 (int      error);
 void     usleepSim                 (unsigned time);
 void     nsleepSim                 (unsigned time);
+void     setNodeSim                (int      node);
 
 uint32_t csrReadMem                (uint32_t addr, uint32_t* data);
 void     csrWriteMem               (uint32_t addr, uint32_t  data);
 uint32_t directReadMem             (uint32_t addr, uint32_t* data);
 void     directWriteMem            (uint32_t addr, uint32_t  data);
+uint32_t directReadMemBlock        (uint32_t addr, uint8_t*  buf, uint32_t len);
+void     directWriteMemBlock       (uint32_t addr, const uint8_t* buf, uint32_t len);
 
 // Used by auto-generated HAL
 extern "C" uint32_t read_ext       (uint32_t addr, uint32_t* data);
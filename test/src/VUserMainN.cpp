@@ -0,0 +1,94 @@
+// -----------------------------------------------------------------------------
+//  Title      : VProc client node main entry points code
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : VUserMainN.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-14
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the code for the VProc main entry points of client
+//  nodes 1 to 15, instantiated in the test bench with its NUM_CLIENTS
+//  parameter. Each acts as an independent host thread, running codec jobs in
+//  the contention test once released by node 0.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include "VUserMain0.h"
+#include "contention.h"
+#include "hal/CTestAuto.h"
+#include "hal/CCoreAuto.h"
+
+#ifndef CORE_0_BASE
+#define CORE_0_BASE 0
+#endif
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+// Entry point for a client node, called by VProc on the node's own thread
+#define VUSERMAIN_CLIENT(_node) extern "C" void VUserMain##_node() { clientMain(_node); }
+
+// --------------------------------------------------
+// Common client node code
+// --------------------------------------------------
+
+static void clientMain (int node)
+{
+    // Make this thread's test bench accesses on this node's bus
+    setNodeSim(node);
+
+    CTestAuto* pTestBench = new CTestAuto((uint32_t*)(CORE_0_BASE));
+    CCoreAuto* pCore      = new CCoreAuto(CORE_0_BASE);
+
+    VPrint("Entered VUserMain%d()\n\n", node);
+
+    contention::client(pTestBench, pCore, node);
+
+    VPrint("VUserMain%d() finished its jobs\n", node);
+
+    // Sleep for ever, ticking, as node 0 ends the simulation
+    SLEEP_FOREVER;
+}
+
+// ==================================================
+// ENTRY POINTS TO USER CODE FROM VPROC
+// ==================================================
+
+VUSERMAIN_CLIENT(1)
+VUSERMAIN_CLIENT(2)
+VUSERMAIN_CLIENT(3)
+VUSERMAIN_CLIENT(4)
+VUSERMAIN_CLIENT(5)
+VUSERMAIN_CLIENT(6)
+VUSERMAIN_CLIENT(7)
+VUSERMAIN_CLIENT(8)
+VUSERMAIN_CLIENT(9)
+VUSERMAIN_CLIENT(10)
+VUSERMAIN_CLIENT(11)
+VUSERMAIN_CLIENT(12)
+VUSERMAIN_CLIENT(13)
+VUSERMAIN_CLIENT(14)
+VUSERMAIN_CLIENT(15)
@@ -0,0 +1,276 @@
+// -----------------------------------------------------------------------------
+//  Title      : Multi-node codec contention test
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : contention.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-14
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the code for the codec contention test class methods
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <string.h>
+
+#include <vector>
+#include <atomic>
+
+#include "VUserMain0.h"
+#include "contention.h"
+#include "testsLocal.h"
+#include "tb.h"
+#include "slzw_model.h"
+
+// --------------------------------------------------
+// LOCAL STATICS
+// --------------------------------------------------
+
+// Shared between the nodes' threads. Node 0 sets the configuration before
+// releasing the clients, and only reads their statistics once they are done.
+static std::atomic<bool>     go(false);
+static std::atomic<uint32_t> done(0);
+static config_t              clientCfg;
+static contentionStats_t     stats[CONTENTION_MAX_NODES];
+
+// --------------------------------------------------
+// Node 0: release the client nodes, wait for them to
+// finish their jobs, and report
+// --------------------------------------------------
+
+int contention::run (const config_t &cfg, const uint32_t numClients)
+{
+    if (numClients >= CONTENTION_MAX_NODES)
+    {
+        VPrint("***ERROR: %d client nodes, but a maximum of %d supported\n", numClients, CONTENTION_MAX_NODES - 1);
+        return TEST_ERROR;
+    }
+
+    clientCfg = cfg;
+
+    VPrint("Releasing %d client nodes, each to run %d codec jobs of %d bytes\n",
+           numClients, cfg.clientJobs, cfg.dataLen);
+
+    go = true;
+
+    while (done < numClients)
+    {
+        usleepSim(1);
+    }
+
+    return report(numClients);
+}
+
+// --------------------------------------------------
+// Client node: wait to be released by node 0, then
+// run its jobs, queueing for the codec on the test
+// bench ticket lock
+// --------------------------------------------------
+
+void contention::client (CTestAuto* pTb, CCoreAuto* pCore, const int node)
+{
+    while (!go)
+    {
+        usleepSim(1);
+    }
+
+    const config_t    &cfg = clientCfg;
+    contentionStats_t &st  = stats[node];
+
+    // Each node compresses its own data, generated from its own seed
+    config_t             nodeCfg = cfg;
+    std::vector<uint8_t> rxData;
+
+    nodeCfg.seed += node;
+
+    genTestData(rxData, cfg.dataLen, nodeCfg, pCore->pSlzwCodec->pConfig->GetMaxCw(),
+                pCore->pSlzwCodec->pConfig->GetMemSize());
+
+    // Give each node its own buffers, after those of the lower nodes
+    const uint32_t txLen   = rxData.size() * 2 + 16;
+    const uint32_t region  = (rxData.size() + TX_BUF_GAP + txLen + 0xfff) & ~0xfff;
+    const uint32_t rxAddr  = START_PHY_MEM + RX_BUF_OFFSET + node * region;
+    const uint32_t txAddr  = (rxAddr + rxData.size() + TX_BUF_GAP + 3) & ~3;
+
+    directWriteMemBlock(rxAddr, rxData.data(), rxData.size());
+
+    // The expected output, from the software model configured to match the codec build
+    std::vector<uint8_t> golden(txLen);
+    uint32_t             goldenLen = 0;
+
+    if (cfg.checkOutput)
+    {
+        slzwConfig_t mcfg;
+        mcfg.policy       = SLZW_RESET_ON_FULL;
+        mcfg.maxCodeWidth = pCore->pSlzwCodec->pConfig->GetMaxCw();
+        mcfg.memSize      = pCore->pSlzwCodec->pConfig->GetMemSize();
+        mcfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+        slzwModel model(&mcfg);
+
+        if (model.compress(rxData.data(), rxData.size(), golden.data(), golden.size(), goldenLen) != SLZW_OK)
+        {
+            VPrint("***ERROR: node %d software model failed to compress test data\n", node);
+            st.error = TEST_ERROR;
+        }
+    }
+
+    st.startCycle = pTb->pTimeCount->GetTimeCount();
+
+    for (uint32_t job = 0; job < cfg.clientJobs && !st.error; job++)
+    {
+        if (job && cfg.clientIdleNs)
+        {
+            nsleepSim(cfg.clientIdleNs);
+        }
+
+        const uint32_t submitted = pTb->pTimeCount->GetTimeCount();
+
+        // Queue for the codec
+        uint32_t ticket, serving, queued;
+
+        csrReadMem(TB_LOCK_TICKET_REG, &ticket);
+        csrReadMem(TB_LOCK_QUEUED_REG, &queued);
+        csrReadMem(TB_LOCK_SERVING_REG, &serving);
+
+        st.maxQueued = (queued > st.maxQueued) ? queued : st.maxQueued;
+
+        while (serving != ticket)
+        {
+            nsleepSim(CONTENTION_POLL_NS);
+            csrReadMem(TB_LOCK_SERVING_REG, &serving);
+        }
+
+        const uint32_t acquired = pTb->pTimeCount->GetTimeCount();
+
+        // Run the job from an empty dictionary, so each matches the model's output
+        pCore->pSlzwCodec->pControl->SetClr(1);
+        pCore->pSlzwCodec->pRxStartAddr->SetRxStartAddr(rxAddr);
+        pCore->pSlzwCodec->pRxLen->SetRxLen(rxData.size());
+        pCore->pSlzwCodec->pTxStartAddr->SetTxStartAddr(txAddr);
+        pCore->pSlzwCodec->pTxLen->SetTxLen(txLen);
+        pCore->pSlzwCodec->pControl->SetMode(1);
+        pCore->pSlzwCodec->pControl->SetStart(1);
+
+        do
+        {
+            nsleepSim(CONTENTION_POLL_NS);
+        }
+        while (!pCore->pSlzwCodec->pStatus->GetFinished());
+
+        const uint32_t finished = pTb->pTimeCount->GetTimeCount();
+        const uint32_t outLen   = pCore->pSlzwCodec->pTxOutLen->GetTxOutLen();
+
+        st.codecCycles += pCore->pSlzwCodec->pJobCycles->GetJobCycles();
+
+        // Release the codec to the next ticket
+        csrWriteMem(TB_LOCK_SERVING_REG, 0);
+
+        st.latency.record(finished - submitted);
+        st.queue.record(acquired - submitted);
+        st.service.record(finished - acquired);
+        st.jobs++;
+
+        // The output stays in this node's buffer until its next job
+        if (cfg.checkOutput)
+        {
+            std::vector<uint8_t> txData(goldenLen);
+
+            directReadMemBlock(txAddr, txData.data(), goldenLen);
+
+            if (outLen != goldenLen || memcmp(txData.data(), golden.data(), goldenLen))
+            {
+                VPrint("***ERROR: node %d job %d output mismatched (%d bytes, expected %d)\n",
+                       node, job, outLen, goldenLen);
+                st.error = TEST_ERROR;
+            }
+        }
+    }
+
+    st.endCycle = pTb->pTimeCount->GetTimeCount();
+
+    done++;
+}
+
+// --------------------------------------------------
+// Report the client nodes' statistics, returning
+// TEST_ERROR if any node had an error
+// --------------------------------------------------
+
+int contention::report (const uint32_t numClients)
+{
+    slzwHistogram latency;
+    slzwHistogram queue;
+    uint64_t      serviceCycles = 0;
+    uint64_t      codecCycles   = 0;
+    uint32_t      firstCycle    = stats[1].startCycle;
+    uint32_t      lastCycle     = stats[1].endCycle;
+    double        tputSum       = 0.0;
+    double        tputSqSum     = 0.0;
+    int           error         = NOERROR;
+
+    VPrint("\nnode  jobs   p50 cyc   p99 cyc   max cyc  queue mean  queue max  max queued  jobs/Mcyc\n");
+
+    for (uint32_t node = 1; node <= numClients; node++)
+    {
+        const contentionStats_t &st = stats[node];
+
+        const uint32_t elapsed = st.endCycle - st.startCycle;
+        const double   tput    = elapsed ? st.jobs * 1e6 / elapsed : 0.0;
+
+        VPrint("%4d %5d %9lu %9lu %9lu %11.1f %10lu %11d %10.2f\n",
+               node, st.jobs,
+               (unsigned long)st.latency.percentile(50.0), (unsigned long)st.latency.percentile(99.0),
+               (unsigned long)st.latency.max(), st.queue.mean(), (unsigned long)st.queue.max(),
+               st.maxQueued, tput);
+
+        latency.merge(st.latency);
+        queue.merge(st.queue);
+
+        serviceCycles += st.service.sum();
+        codecCycles   += st.codecCycles;
+        tputSum       += tput;
+        tputSqSum     += tput * tput;
+
+        // Time counter differences are modulo 2^32
+        firstCycle     = ((int32_t)(st.startCycle - firstCycle) < 0) ? st.startCycle : firstCycle;
+        lastCycle      = ((int32_t)(st.endCycle   - lastCycle)  > 0) ? st.endCycle   : lastCycle;
+
+        error         |= st.error;
+    }
+
+    const uint32_t elapsed = lastCycle - firstCycle;
+
+    VPrint(" all %5lu %9lu %9lu %9lu %11.1f %10lu\n\n",
+           (unsigned long)latency.count(),
+           (unsigned long)latency.percentile(50.0), (unsigned long)latency.percentile(99.0),
+           (unsigned long)latency.max(), queue.mean(), (unsigned long)queue.max());
+
+    VPrint("Codec held by a node for %.1f%%, and running jobs for %.1f%%, of %d cycles\n",
+           elapsed ? serviceCycles * 100.0 / elapsed : 0.0, elapsed ? codecCycles * 100.0 / elapsed : 0.0, elapsed);
+    VPrint("Jain's fairness index of node throughput: %.3f\n\n",
+           tputSqSum > 0.0 ? (tputSum * tputSum) / (numClients * tputSqSum) : 0.0);
+
+    return error ? TEST_ERROR : NOERROR;
+}
@@ -0,0 +1,99 @@
+// -----------------------------------------------------------------------------
+//  Title      : Multi-node codec contention test header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : contention.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-14
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definition for the codec contention test,
+//  where client VProc nodes (VUserMainN.cpp) act as independent host threads
+//  submitting compression jobs to the one codec. The nodes share the CSR bus
+//  through the test bench arbiter, and queue for the codec on the test bench
+//  ticket lock, in first come, first served order.
+//
+//  Each client node runs its jobs once released by node 0, timing them in
+//  clock cycles from the test bench time counter: from submission to taking
+//  the lock (queueing delay), and on to the job finishing (service time).
+//  Node 0 waits for all the clients, and reports each node's latency and
+//  queueing delay distributions, its throughput, the codec utilisation, and
+//  Jain's fairness index over the nodes' throughputs.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _CONTENTION_H_
+#define _CONTENTION_H_
+
+#include <stdint.h>
+
+#include "utils.h"
+#include "slzw_telemetry.h"
+
+// Include the test bench and top level HAL headers
+#include "hal/CTestAuto.h"
+#include "hal/CCoreAuto.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// VProc nodes supported, including node 0 (the test bench limit)
+#define CONTENTION_MAX_NODES                    16
+
+// Interval between polls of the lock and of the codec finished status, in ns
+#define CONTENTION_POLL_NS                      100
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// A client node's job measurements, in clock cycles
+typedef struct {
+    slzwHistogram latency;      // Submit to job finished
+    slzwHistogram queue;        // Submit to taking the lock
+    slzwHistogram service;      // Taking the lock to job finished
+    uint64_t      codecCycles;  // Total of the codec's job_cycles counts
+    uint32_t      maxQueued;    // Most tickets outstanding seen on submitting
+    uint32_t      startCycle;   // Time of first submission
+    uint32_t      endCycle;     // Time last job finished
+    uint32_t      jobs;         // Jobs run
+    int           error;
+} contentionStats_t;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITIONS
+// -------------------------------------------------------------------------
+
+class contention
+{
+public:
+    // Node 0: release the client nodes to run their jobs, wait for them all
+    // to finish, and report. Returns TEST_ERROR if any node had an error.
+    static int  run    (const config_t &cfg, const uint32_t numClients);
+
+    // Client node: wait to be released by node 0, then run its jobs
+    static void client (CTestAuto* pTb, CCoreAuto* pCore, const int node);
+
+private:
+    static int  report (const uint32_t numClients);
+};
+
+#endif
@@ -0,0 +1,734 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec asynchronous job driver
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_driver.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-02-25
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods for the slzw_codec asynchronous job driver.
+//
+//  Jobs are held in a deque in submission order, with the head entry being
+//  the one issued to the codec. The completion thread (or service(), when not
+//  threaded) issues the head job by programming the buffer and control
+//  registers, polls the finished status, and then retires the job by popping
+//  it, calling any callback, and fulfilling its promise. Retiring from the
+//  head only guarantees results complete in submission order.
+//
+//  Scatter-gather jobs have their segment lists checked against the codec's
+//  list depth before issue, and are retired with SLZW_DRV_BADSEG, without
+//  being issued, if they don't fit.
+//
+//  Non-coherent jobs have their input buffers cleaned, and output buffers
+//  invalidated, before issue, with the output invalidated again once
+//  finished, as the CPU may speculatively fetch lines whilst the job runs.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "slzw_driver.h"
+
+#ifdef HDL_SIM
+#include "VUserMain0.h"
+#endif
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+slzwDriver::slzwDriver(CCoreAuto*     pCoreIn,
+                       const uint32_t maxDepthIn,
+                       const bool     threadedIn,
+                       const uint32_t timeoutUsIn) :
+    pCore(pCoreIn),
+    maxDepth(maxDepthIn ? maxDepthIn : 1),
+    threaded(threadedIn),
+    timeoutUs(timeoutUsIn),
+    acpCrossover(SLZW_DRV_DEFAULT_ACP_CROSSOVER),
+    nextJobId(0),
+    outstanding(0),
+    terminate(false)
+{
+    maxSegs  = pCore->pSlzwCodec->pConfig->GetSgDepth();
+    csumUnit = pCore->pSlzwCodec->pConfig->GetChecksum() != 0;
+
+    acpWinBase = pCore->pAcpWinBase->GetAcpWinBase();
+
+    if (threaded)
+    {
+        worker = std::thread(&slzwDriver::completionThread, this);
+    }
+}
+
+// --------------------------------------------------
+// Destructor
+// --------------------------------------------------
+
+slzwDriver::~slzwDriver()
+{
+    if (threaded)
+    {
+        {
+            std::lock_guard<std::mutex> lock(qMutex);
+            terminate = true;
+        }
+
+        qNotEmpty.notify_all();
+        worker.join();
+    }
+    else
+    {
+        service();
+    }
+}
+
+// --------------------------------------------------
+// Submit a job to the queue
+// --------------------------------------------------
+
+std::future<slzwJobResult_t> slzwDriver::submit(const slzwJob_t &job, slzwJobCallback_t callback)
+{
+    // When not threaded there is nothing to retire jobs whilst waiting, so
+    // run the head job here to make space.
+    if (!threaded && inFlight() >= maxDepth)
+    {
+        serviceOne();
+    }
+
+    std::unique_lock<std::mutex> lock(qMutex);
+
+    qNotFull.wait(lock, [this]{ return queue.size() < maxDepth; });
+
+    qEntry_t entry;
+
+    entry.jobId    = nextJobId++;
+    entry.job      = job;
+    entry.callback = callback;
+    entry.submitUs = nowUs();
+
+    std::future<slzwJobResult_t> future = entry.result.get_future();
+
+    queue.push_back(std::move(entry));
+    outstanding++;
+
+    lock.unlock();
+    qNotEmpty.notify_one();
+
+    return future;
+}
+
+// --------------------------------------------------
+// Run queued jobs to completion in the calling thread
+// --------------------------------------------------
+
+uint32_t slzwDriver::service()
+{
+    uint32_t count = 0;
+
+    while (serviceOne())
+    {
+        count++;
+    }
+
+    return count;
+}
+
+// --------------------------------------------------
+// Wait until all outstanding jobs are retired
+// --------------------------------------------------
+
+void slzwDriver::drain()
+{
+    if (!threaded)
+    {
+        service();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(qMutex);
+
+    qEmpty.wait(lock, [this]{ return outstanding == 0; });
+}
+
+// --------------------------------------------------
+// Number of jobs queued or in the codec
+// --------------------------------------------------
+
+uint32_t slzwDriver::inFlight()
+{
+    std::lock_guard<std::mutex> lock(qMutex);
+
+    return queue.size();
+}
+
+// --------------------------------------------------
+// Completion thread. Runs until terminated, and the
+// queue is empty.
+// --------------------------------------------------
+
+void slzwDriver::completionThread()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(qMutex);
+
+            qNotEmpty.wait(lock, [this]{ return terminate || !queue.empty(); });
+
+            if (queue.empty())
+            {
+                return;
+            }
+        }
+
+        serviceOne();
+    }
+}
+
+// --------------------------------------------------
+// Issue the head job to the codec and retire it.
+// Returns false if the queue was empty.
+// --------------------------------------------------
+
+bool slzwDriver::serviceOne()
+{
+    slzwJob_t job;
+    uint32_t  polls  = 0;
+    uint32_t  outLen = 0;
+    uint32_t  csum   = 0;
+    uint32_t  cycles = 0;
+    uint32_t  path;
+
+    {
+        std::lock_guard<std::mutex> lock(qMutex);
+
+        if (queue.empty())
+        {
+            return false;
+        }
+
+        job = queue.front().job;
+    }
+
+    path = selectPath(job);
+
+    // Segment lists that don't fit the codec are rejected without issuing the job
+    if (!validSegs(job.rxSegs, maxSegs) || !validSegs(job.txSegs, maxSegs))
+    {
+        retire(SLZW_DRV_BADSEG, polls, outLen, csum, path, 0, 0, 0, cycles);
+        return true;
+    }
+
+    if (path == SLZW_DRV_PATH_NONCOHERENT)
+    {
+        cacheMaint(cacheOps.clean,      job, true);
+        cacheMaint(cacheOps.invalidate, job, false);
+    }
+
+    const uint64_t start = nowUs();
+
+    issue(job, path == SLZW_DRV_PATH_ACP);
+
+    const uint64_t started = nowUs();
+
+    int status = waitFinished(polls);
+
+    // Simulation has no wall clock view of simulated time, so uses the 1us polls
+#ifdef HDL_SIM
+    const uint32_t timeUs = polls;
+    const uint32_t waitUs = polls;
+#else
+    const uint64_t finished = nowUs();
+    const uint32_t timeUs   = (uint32_t)(finished - start);
+    const uint32_t waitUs   = (uint32_t)(finished - started);
+#endif
+
+    // A timed out job leaves the codec busy, so clear it for the next job
+    if (status != SLZW_DRV_OK)
+    {
+        pCore->pSlzwCodec->pControl->SetClr(1);
+    }
+    else
+    {
+        outLen = pCore->pSlzwCodec->pTxOutLen->GetTxOutLen();
+        csum   = pCore->pSlzwCodec->pChecksum->GetChecksum();
+        cycles = pCore->pSlzwCodec->pJobCycles->GetJobCycles();
+
+        // tx_out_len counts the dropped bytes too, so limit it to what was written
+        if (pCore->pSlzwCodec->pStatus->GetTxOverflow())
+        {
+            const uint32_t capacity = txCapacity(job);
+
+            status = SLZW_DRV_OVERFLOW;
+            outLen = (outLen < capacity) ? outLen : capacity;
+        }
+
+        if (path == SLZW_DRV_PATH_NONCOHERENT)
+        {
+            cacheMaint(cacheOps.invalidate, job, false);
+        }
+    }
+
+    retire(status, polls, outLen, csum, path, timeUs, (uint32_t)(started - start), waitUs, cycles);
+
+    return true;
+}
+
+// --------------------------------------------------
+// Program the codec registers for a job and start it
+// --------------------------------------------------
+
+void slzwDriver::issue(const slzwJob_t &job, const bool coherent)
+{
+    const bool rxSg = !job.rxSegs.empty();
+    const bool txSg = !job.txSegs.empty();
+
+    // Start from an empty dictionary, independent of earlier jobs
+    if (job.clrDict)
+    {
+        pCore->pSlzwCodec->pControl->SetClr(1);
+    }
+
+    // Empty any segments left by a cleared job before pushing new lists
+    if (rxSg || txSg)
+    {
+        pCore->pSlzwCodec->pSgControl->SetClr(1);
+    }
+
+    if (rxSg)
+    {
+        pushSegs(job.rxSegs, true);
+    }
+    else
+    {
+        pCore->pSlzwCodec->pRxStartAddr->SetRxStartAddr(job.rxAddr);
+        pCore->pSlzwCodec->pRxLen->SetRxLen(job.rxLen);
+    }
+
+    if (txSg)
+    {
+        pushSegs(job.txSegs, false);
+    }
+    else
+    {
+        pCore->pSlzwCodec->pTxStartAddr->SetTxStartAddr(job.txAddr);
+        pCore->pSlzwCodec->pTxLen->SetTxLen(job.txLen);
+    }
+
+    pCore->pSlzwCodec->pControl->SetEnAcpWin(coherent ? 1 : 0);
+    pCore->pSlzwCodec->pControl->SetMode(job.mode);
+    pCore->pSlzwCodec->pControl->SetResetPolicy(job.resetPolicy);
+    pCore->pSlzwCodec->pControl->SetCsumAdler(job.csumType);
+    pCore->pSlzwCodec->pControl->SetRxSg(rxSg ? 1 : 0);
+    pCore->pSlzwCodec->pControl->SetTxSg(txSg ? 1 : 0);
+
+    pCore->pSlzwCodec->pControl->SetStart(1);
+}
+
+// --------------------------------------------------
+// Select a job's data path. Auto path jobs are
+// coherent if their buffers total no more than the
+// crossover size.
+// --------------------------------------------------
+
+uint32_t slzwDriver::selectPath(const slzwJob_t &job)
+{
+    if (job.path != SLZW_DRV_PATH_AUTO)
+    {
+        return job.path;
+    }
+
+    uint64_t bytes = 0;
+
+    if (job.rxSegs.empty())
+    {
+        bytes += job.rxLen;
+    }
+
+    if (job.txSegs.empty())
+    {
+        bytes += job.txLen;
+    }
+
+    for (auto &seg : job.rxSegs)
+    {
+        bytes += seg.len;
+    }
+
+    for (auto &seg : job.txSegs)
+    {
+        bytes += seg.len;
+    }
+
+    return (bytes <= acpCrossover) ? SLZW_DRV_PATH_ACP : SLZW_DRV_PATH_NONCOHERENT;
+}
+
+// --------------------------------------------------
+// Call a cache maintenance operation on each of a
+// job's input (rx) or output buffers
+// --------------------------------------------------
+
+void slzwDriver::cacheMaint(const slzwCacheOp_t &op, const slzwJob_t &job, const bool rx)
+{
+    if (!op)
+    {
+        return;
+    }
+
+    const std::vector<slzwSeg_t> &segs = rx ? job.rxSegs : job.txSegs;
+
+    if (segs.empty())
+    {
+        op(rx ? job.rxAddr : job.txAddr, rx ? job.rxLen : job.txLen);
+    }
+
+    for (auto &seg : segs)
+    {
+        op(seg.addr, seg.len);
+    }
+}
+
+// --------------------------------------------------
+// Push a segment list to the codec's RX or TX list
+// --------------------------------------------------
+
+void slzwDriver::pushSegs(const std::vector<slzwSeg_t> &segs, const bool rx)
+{
+    for (auto &seg : segs)
+    {
+        pCore->pSlzwCodec->pSgAddr->SetSgAddr(seg.addr);
+        pCore->pSlzwCodec->pSgLen->SetSgLen(seg.len);
+
+        if (rx)
+        {
+            pCore->pSlzwCodec->pSgControl->SetRxPush(1);
+        }
+        else
+        {
+            pCore->pSlzwCodec->pSgControl->SetTxPush(1);
+        }
+    }
+}
+
+// --------------------------------------------------
+// Check a segment list fits in depth entries, with
+// word aligned addresses and, for all but the last
+// segment, whole word lengths. An empty list (no
+// scatter-gather) is valid.
+// --------------------------------------------------
+
+bool slzwDriver::validSegs(const std::vector<slzwSeg_t> &segs, const uint32_t depth)
+{
+    if (segs.size() > depth)
+    {
+        return false;
+    }
+
+    for (size_t idx = 0; idx < segs.size(); idx++)
+    {
+        if ((segs[idx].addr & 0x3) || (idx != segs.size() - 1 && (segs[idx].len & 0x3)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Build a segment list from an iovec array
+// --------------------------------------------------
+
+int slzwDriver::iovToSegs(const struct iovec* iov, const int iovcnt,
+                          const void* virtBase, const uint32_t physBase, const uint32_t mapSize,
+                          std::vector<slzwSeg_t> &segs)
+{
+    segs.clear();
+
+    for (int idx = 0; idx < iovcnt; idx++)
+    {
+        const uintptr_t base   = (uintptr_t)iov[idx].iov_base;
+        const uintptr_t offset = base - (uintptr_t)virtBase;
+
+        if (iov[idx].iov_len == 0)
+        {
+            continue;
+        }
+
+        if (base < (uintptr_t)virtBase || offset > mapSize || iov[idx].iov_len > mapSize - offset)
+        {
+            return SLZW_DRV_BADSEG;
+        }
+
+        const uint32_t addr = physBase + (uint32_t)offset;
+
+        // Merge with the previous segment when contiguous
+        if (!segs.empty() && segs.back().addr + segs.back().len == addr)
+        {
+            segs.back().len += (uint32_t)iov[idx].iov_len;
+        }
+        else
+        {
+            segs.push_back({addr, (uint32_t)iov[idx].iov_len});
+        }
+    }
+
+    return validSegs(segs, segs.size()) ? SLZW_DRV_OK : SLZW_DRV_BADSEG;
+}
+
+// --------------------------------------------------
+// Poll the codec's finished status until set or timed
+// out. A poll takes much longer than its 1us sleep on
+// the hardware, so the timeout is a monotonic clock
+// deadline. In simulation each poll is 1us of
+// simulated time, so the polls are counted.
+//
+// The start bit always reads back clear on the codec,
+// but the FPGA model's device thread only clears it,
+// after clearing the last job's status, when it takes
+// the job. So finished is not polled until the start
+// reads back clear.
+// --------------------------------------------------
+
+int slzwDriver::waitFinished(uint32_t &polls)
+{
+#ifndef HDL_SIM
+    const uint64_t deadline = nowUs() + timeoutUs;
+#endif
+    bool taken = false;
+
+    polls = 0;
+
+    do
+    {
+        sleepUs(1);
+        polls++;
+
+        taken = taken || !pCore->pSlzwCodec->pControl->GetStart();
+
+        if (taken && pCore->pSlzwCodec->pStatus->GetFinished())
+        {
+            return SLZW_DRV_OK;
+        }
+    }
+#ifdef HDL_SIM
+    while (polls < timeoutUs);
+#else
+    while (nowUs() < deadline);
+#endif
+
+    return SLZW_DRV_TIMEOUT;
+}
+
+// --------------------------------------------------
+// Retire the head job, recording its telemetry, and
+// calling its callback (if any) and then fulfilling
+// its promise
+// --------------------------------------------------
+
+void slzwDriver::retire(const int status, const uint32_t polls, const uint32_t outLen, const uint32_t checksum, const uint32_t path,
+                        const uint32_t timeUs, const uint32_t setupUs, const uint32_t waitUs, const uint32_t codecCycles)
+{
+    qEntry_t        entry;
+    slzwJobResult_t result;
+
+    {
+        std::lock_guard<std::mutex> lock(qMutex);
+
+        entry = std::move(queue.front());
+        queue.pop_front();
+    }
+
+    qNotFull.notify_one();
+
+    result.jobId       = entry.jobId;
+    result.status      = status;
+    result.polls       = polls;
+    result.outLen      = outLen;
+    result.checksum    = checksum;
+    result.path        = path;
+    result.engine      = SLZW_DRV_ENGINE_CODEC;
+    result.timeUs      = timeUs;
+    result.codecCycles = codecCycles;
+
+    slzwTlmSample_t sample;
+
+    sample.mode        = entry.job.mode;
+    sample.status      = status;
+    sample.inLen       = inputLen(entry.job);
+    sample.outLen      = outLen;
+    sample.latencyUs   = nowUs() - entry.submitUs;
+    sample.setupUs     = setupUs;
+    sample.waitUs      = waitUs;
+    sample.codecCycles = codecCycles;
+
+    telem.record(sample);
+
+    if (entry.callback)
+    {
+        entry.callback(result);
+    }
+
+    entry.result.set_value(result);
+
+    // The job is popped before its result is delivered, so drain() waits on
+    // the outstanding count, which is only decremented once the result is visible
+    {
+        std::lock_guard<std::mutex> lock(qMutex);
+
+        if (--outstanding == 0)
+        {
+            qEmpty.notify_all();
+        }
+    }
+}
+
+// --------------------------------------------------
+// Total input length of a job, over any segments
+// --------------------------------------------------
+
+uint32_t slzwDriver::inputLen(const slzwJob_t &job)
+{
+    uint32_t len = job.rxSegs.empty() ? job.rxLen : 0;
+
+    for (auto &seg : job.rxSegs)
+    {
+        len += seg.len;
+    }
+
+    return len;
+}
+
+// --------------------------------------------------
+// Output bytes the codec can write for a job. It
+// writes whole words, so each buffer or segment's
+// length is rounded down.
+// --------------------------------------------------
+
+uint32_t slzwDriver::txCapacity(const slzwJob_t &job)
+{
+    uint32_t len = job.txSegs.empty() ? (job.txLen & ~0x3U) : 0;
+
+    for (auto &seg : job.txSegs)
+    {
+        len += seg.len & ~0x3U;
+    }
+
+    return len;
+}
+
+// --------------------------------------------------
+// Enable or disable event trace capture
+// --------------------------------------------------
+
+void slzwDriver::enableTrace(const bool enable)
+{
+    pCore->pSlzwCodec->pTraceControl->SetEnable(enable ? 1 : 0);
+}
+
+// --------------------------------------------------
+// Pop all the captured trace entries. The pops are
+// bounded by the trace FIFO depth, in case entries
+// are added whilst reading.
+// --------------------------------------------------
+
+bool slzwDriver::readTrace(std::vector<slzwTraceEntry_t> &entries)
+{
+    for (uint32_t idx = 0; idx < SLZW_TRC_DEPTH && !pCore->pSlzwCodec->pTraceStatus->GetEmpty(); idx++)
+    {
+        slzwTraceEntry_t entry;
+
+        pCore->pSlzwCodec->pTraceControl->SetPop(1);
+
+        entry.time  = pCore->pSlzwCodec->pTraceTime->GetTraceTime();
+        entry.event = pCore->pSlzwCodec->pTraceEvent->GetTraceEvent();
+
+        entries.push_back(entry);
+    }
+
+    bool overflow = pCore->pSlzwCodec->pTraceStatus->GetOverflow();
+
+    if (overflow)
+    {
+        pCore->pSlzwCodec->pTraceControl->SetClrOverflow(1);
+    }
+
+    return overflow;
+}
+
+// --------------------------------------------------
+// Write trace entries to a file
+// --------------------------------------------------
+
+int slzwDriver::writeTrace(const char* filename, const std::vector<slzwTraceEntry_t> &entries)
+{
+    FILE* fp;
+
+    if ((fp = fopen(filename, "w")) == NULL)
+    {
+        fprintf(stderr, "*** writeTrace(): Unable to open file %s for writing\n", filename);
+        return 1;
+    }
+
+    fprintf(fp, "# slzw_codec event trace: cycle event\n");
+
+    for (auto &entry : entries)
+    {
+        fprintf(fp, SLZW_TRC_FILE_FMT, entry.time, entry.event);
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Platform independent microsecond sleep
+// --------------------------------------------------
+
+void slzwDriver::sleepUs(const uint32_t us)
+{
+#ifdef HDL_SIM
+    usleepSim(us);
+#else
+    usleep(us);
+#endif
+}
+
+// --------------------------------------------------
+// Monotonic time in microseconds
+// --------------------------------------------------
+
+uint64_t slzwDriver::nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
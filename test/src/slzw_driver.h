@@ -0,0 +1,321 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec asynchronous job driver header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_driver.h
+//  Author     : Simon Southwell
+//  Created    : 2022-02-25
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definition for an asynchronous job driver
+//  for the slzw_codec. Jobs are submitted to a bounded queue, returning a
+//  future (with an optional callback), and are issued to the codec and
+//  retired in order by a completion thread.
+//
+//  The current CSR interface has no job queue, so SLZW_DRV_HW_DEPTH is 1 and
+//  jobs execute in the codec one at a time. Queueing, buffer preparation and
+//  waiting on results are still overlapped with the codec's execution.
+//
+//  A job's input and output can each be a scatter-gather list of segments,
+//  pushed to the codec's segment lists when the job is issued, so that
+//  chained buffers need not first be copied into one contiguous buffer.
+//
+//  Each job's data is accessed either coherently, through the ACP window,
+//  or non-coherently, with the driver calling the platform's cache
+//  maintenance operations around the job. The ACP has lower bandwidth, but
+//  no maintenance cost, so by default a job takes the coherent path only if
+//  its buffers total no more than a crossover size, as measured on the
+//  platform with the slzw_pathbench program. A build with no ACP window
+//  routed (the core's acp_win_base register reads 0) has only the one path,
+//  whichever is selected, which acpWindow() reports.
+//
+//  The driver keeps telemetry of its jobs (slzw_telemetry.h): histograms of
+//  latency from submit to complete, of register setup and of wait time, of
+//  throughput, and of the codec's job_cycles counter, by mode and job size.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <deque>
+#include <vector>
+#include <future>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifndef _SLZW_DRIVER_H_
+#define _SLZW_DRIVER_H_
+
+// Include top level HAL header
+#include "hal/CCoreAuto.h"
+
+#include "slzw_trace.h"
+#include "slzw_telemetry.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Number of jobs the codec hardware can hold at once. The CSR interface has
+// a single set of job registers, so this is 1.
+#define SLZW_DRV_HW_DEPTH                       1
+
+// Default maximum number of jobs queued or in the codec
+#define SLZW_DRV_DEFAULT_DEPTH                  8
+
+// Default time for a job to finish before it is timed out, in microseconds
+// (of simulated time in simulation)
+#define SLZW_DRV_DEFAULT_TIMEOUT_US             1000000
+
+// Job modes, matching the control register mode field
+#define SLZW_DRV_DECOMPRESS                     0
+#define SLZW_DRV_COMPRESS                       1
+
+// Checksum types, matching the control register csum_adler field
+#define SLZW_DRV_CRC32                          0
+#define SLZW_DRV_ADLER32                        1
+
+// Job data paths. Auto selects by the buffer size crossover.
+#define SLZW_DRV_PATH_AUTO                      0
+#define SLZW_DRV_PATH_ACP                       1
+#define SLZW_DRV_PATH_NONCOHERENT               2
+
+// Default coherent path crossover. All jobs use the ACP, as the control
+// register's en_acp_win reset value.
+#define SLZW_DRV_DEFAULT_ACP_CROSSOVER          0xffffffff
+
+// Job result status values
+#define SLZW_DRV_OK                             0
+#define SLZW_DRV_TIMEOUT                        1
+#define SLZW_DRV_BADSEG                         2
+#define SLZW_DRV_SWERR                          3   // Software engine (slzwScheduler) decode error
+#define SLZW_DRV_OVERFLOW                       4   // Output exceeded the output buffer and was truncated
+
+// Engines a job can run on
+#define SLZW_DRV_ENGINE_CODEC                   0
+#define SLZW_DRV_ENGINE_SOFTWARE                1
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Scatter-gather segment. The address is word aligned and, except for the
+// last segment of a list, the length is a whole number of words.
+typedef struct {
+    uint32_t     addr;          // Physical address
+    uint32_t     len;           // Length in bytes
+} slzwSeg_t;
+
+// Job description. Buffers are physical addresses visible to the codec.
+typedef struct {
+    uint32_t     mode;          // SLZW_DRV_COMPRESS or SLZW_DRV_DECOMPRESS
+    uint32_t     resetPolicy;   // Dictionary reset policy (control register reset_policy)
+    uint32_t     csumType;      // SLZW_DRV_CRC32 or SLZW_DRV_ADLER32
+    uint32_t     path;          // SLZW_DRV_PATH_AUTO, SLZW_DRV_PATH_ACP or SLZW_DRV_PATH_NONCOHERENT
+    uint32_t     clrDict;       // Non-zero to clear the codec (and its dictionary) before the job
+    uint32_t     rxAddr;        // Input buffer address (word aligned)
+    uint32_t     rxLen;         // Input length in bytes
+    uint32_t     txAddr;        // Output buffer address (word aligned)
+    uint32_t     txLen;         // Output buffer capacity in bytes
+    std::vector<slzwSeg_t> rxSegs; // Input segments. If not empty, used instead of rxAddr and rxLen
+    std::vector<slzwSeg_t> txSegs; // Output segments. If not empty, used instead of txAddr and txLen
+} slzwJob_t;
+
+typedef struct {
+    uint64_t     jobId;         // Submission order sequence number
+    int          status;        // SLZW_DRV_OK, SLZW_DRV_TIMEOUT, SLZW_DRV_BADSEG, SLZW_DRV_SWERR or SLZW_DRV_OVERFLOW
+    uint32_t     polls;         // Number of status polls until finished
+    uint32_t     outLen;        // Output bytes written (on overflow, those that fitted the buffer)
+    uint32_t     checksum;      // Checksum of the uncompressed data (0 if no checksum unit)
+    uint32_t     path;          // Data path taken (SLZW_DRV_PATH_ACP or SLZW_DRV_PATH_NONCOHERENT)
+    uint32_t     engine;        // SLZW_DRV_ENGINE_CODEC, or SLZW_DRV_ENGINE_SOFTWARE from slzwScheduler
+    uint32_t     timeUs;        // Time from issue to finished (polls in simulation)
+    uint32_t     codecCycles;   // Codec clock cycles from start to finished (0 if no job_cycles counter)
+} slzwJobResult_t;
+
+typedef std::function<void(const slzwJobResult_t &)> slzwJobCallback_t;
+
+// Cache maintenance for non-coherent jobs, on a physical address range in
+// the codec's memory. Clean writes back the CPU's data before the codec reads
+// it, and invalidate discards stale lines before and after the codec writes.
+// Either may be empty, as when the memory is mapped uncached.
+typedef std::function<void(const uint32_t addr, const uint32_t len)> slzwCacheOp_t;
+
+typedef struct {
+    slzwCacheOp_t clean;
+    slzwCacheOp_t invalidate;
+} slzwCacheOps_t;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITION
+// -------------------------------------------------------------------------
+
+class slzwDriver
+{
+public:
+    // Constructor. If threaded is false, no completion thread is started and
+    // queued jobs are run by calling service(), e.g. from the single VProc
+    // thread in simulation. A job not finished timeoutUs after it is started
+    // is timed out.
+    slzwDriver(CCoreAuto*     pCore,
+               const uint32_t maxDepth  = SLZW_DRV_DEFAULT_DEPTH,
+               const bool     threaded  = true,
+               const uint32_t timeoutUs = SLZW_DRV_DEFAULT_TIMEOUT_US);
+
+    // Destructor. Retires all outstanding jobs before returning.
+    ~slzwDriver();
+
+    // Submit a job. Blocks whilst maxDepth jobs are outstanding. The callback,
+    // if given, is called from the completion thread before the future is made
+    // ready.
+    std::future<slzwJobResult_t> submit (const slzwJob_t &job, slzwJobCallback_t callback = nullptr);
+
+    // Run all queued jobs to completion in the calling thread (non-threaded
+    // use). Returns the number of jobs retired.
+    uint32_t service  ();
+
+    // Wait until all outstanding jobs are retired
+    void     drain    ();
+
+    // Number of jobs queued or in the codec
+    uint32_t inFlight ();
+
+    // Number of jobs the codec can hold at once
+    uint32_t hwDepth  () { return SLZW_DRV_HW_DEPTH; };
+
+    // Number of segments the codec takes per scatter-gather list (0 if not supported)
+    uint32_t sgDepth  () { return maxSegs; };
+
+    // Whether the codec calculates checksums of the uncompressed data
+    bool     hasChecksum () { return csumUnit; };
+
+    // Whether the build routes an ACP window, so that the coherent and
+    // non-coherent paths differ
+    bool     acpWindow   () { return acpWinBase != 0; };
+
+    // Set the platform's cache maintenance operations for non-coherent jobs.
+    // Not thread safe with jobs in flight.
+    void     setCacheOps     (const slzwCacheOps_t &ops) { cacheOps = ops; };
+
+    // Set the largest total of input and output buffer bytes for which an
+    // auto path job is coherent
+    void     setAcpCrossover (const uint32_t bytes) { acpCrossover = bytes; };
+
+    // Data path a job would take
+    uint32_t selectPath      (const slzwJob_t &job);
+
+    // Build a segment list from an iovec array of buffers in the codec's memory,
+    // mapped at virtBase (of mapSize bytes), and at physBase for the codec.
+    // Adjacent buffers are merged. Returns SLZW_DRV_BADSEG if a buffer is
+    // outside of the mapping, or the list breaks the slzwSeg_t alignment rules.
+    static int iovToSegs (const struct iovec* iov, const int iovcnt,
+                          const void* virtBase, const uint32_t physBase, const uint32_t mapSize,
+                          std::vector<slzwSeg_t> &segs);
+
+    // Enable or disable the codec's event trace capture
+    void     enableTrace (const bool enable);
+
+    // Pop the captured trace entries, appending them to entries. Returns
+    // true if entries were dropped with the trace FIFO full, clearing the
+    // overflow status.
+    bool     readTrace   (std::vector<slzwTraceEntry_t> &entries);
+
+    // Write trace entries to a file, in the slzw_trace.h text format
+    static int writeTrace (const char* filename, const std::vector<slzwTraceEntry_t> &entries);
+
+    // Job telemetry, updated as each job is retired (before its callback).
+    // In simulation, latency and setup times are of the host, and wait times
+    // are in 1us polls, as timeUs.
+    slzwTelemetry &telemetry () { return telem; };
+
+private:
+
+    // Queue entry
+    typedef struct {
+        uint64_t                        jobId;
+        slzwJob_t                       job;
+        slzwJobCallback_t               callback;
+        std::promise<slzwJobResult_t>   result;
+        uint64_t                        submitUs;
+    } qEntry_t;
+
+    // Completion thread loop
+    void     completionThread ();
+
+    // Issue the head job to the codec, wait for it to finish, and retire it
+    bool     serviceOne       ();
+
+    // Program and start a job in the codec, and wait for it to finish
+    void     issue            (const slzwJob_t &job, const bool coherent);
+    int      waitFinished     (uint32_t &polls);
+
+    // Retire the job at the head of the queue, recording its telemetry
+    void     retire           (const int status, const uint32_t polls, const uint32_t outLen, const uint32_t checksum, const uint32_t path,
+                               const uint32_t timeUs, const uint32_t setupUs, const uint32_t waitUs, const uint32_t codecCycles);
+
+    // Total input length of a job
+    static uint32_t inputLen  (const slzwJob_t &job);
+
+    // Output buffer capacity of a job, in the whole words the codec writes
+    static uint32_t txCapacity(const slzwJob_t &job);
+
+    // Call a cache maintenance operation on a job's input or output buffers
+    void     cacheMaint       (const slzwCacheOp_t &op, const slzwJob_t &job, const bool rx);
+
+    // Check a segment list's alignment and length
+    static bool validSegs     (const std::vector<slzwSeg_t> &segs, const uint32_t depth);
+
+    // Push a segment list to the codec
+    void     pushSegs         (const std::vector<slzwSeg_t> &segs, const bool rx);
+
+    void     sleepUs          (const uint32_t us);
+    uint64_t nowUs            ();
+
+    CCoreAuto*                  pCore;
+    const uint32_t              maxDepth;
+    const bool                  threaded;
+    const uint32_t              timeoutUs;
+    uint32_t                    maxSegs;
+    bool                        csumUnit;
+    uint32_t                    acpWinBase;
+    slzwCacheOps_t              cacheOps;
+    std::atomic<uint32_t>       acpCrossover;
+    slzwTelemetry               telem;
+
+    // Jobs in submission order. The head entry is the one in the codec.
+    std::deque<qEntry_t>        queue;
+    uint64_t                    nextJobId;
+    // Jobs submitted whose results are not yet delivered
+    uint32_t                    outstanding;
+    bool                        terminate;
+
+    std::mutex                  qMutex;
+    std::condition_variable     qNotEmpty;
+    std::condition_variable     qNotFull;
+    std::condition_variable     qEmpty;
+
+    std::thread                 worker;
+};
+
+#endif
@@ -0,0 +1,33 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW file utilities build for the test code
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_file_sim.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file builds the file utilities, from the model source directory,
+//  into the test code, for reading codec test input files. The VProc build
+//  only compiles user code from the test source directory.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#include "slzw_file.cpp"
@@ -0,0 +1,445 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW hybrid hardware/software job scheduler
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_scheduler.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-11
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods for the hybrid codec and software job
+//  scheduler.
+//
+//  A job's expected finish time on the codec is the estimated time of the
+//  jobs already given to it (which it runs one at a time) plus its own. For
+//  the software, the queued work is shared between the workers. Until an
+//  engine has a time for a job's mode and size bucket, jobs go to it to
+//  calibrate it, and thereafter every SLZW_SCHED_PROBE_INTERVAL jobs in a
+//  bucket go to the engine not expected to be fastest, so that estimates
+//  follow changes in load or memory contention.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "slzw_scheduler.h"
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+slzwScheduler::slzwScheduler(slzwDriver*    pDriverIn,
+                             uint8_t*       virtBaseIn,
+                             const uint32_t physBaseIn,
+                             const uint32_t mapSizeIn,
+                             const uint32_t maxCodeWidthIn,
+                             const uint32_t numWorkers) :
+    pDriver(pDriverIn),
+    virtBase(virtBaseIn),
+    physBase(physBaseIn),
+    mapSize(mapSizeIn),
+    maxCodeWidth(maxCodeWidthIn),
+    engineSel(SLZW_SCHED_AUTO),
+    nextJobId(0),
+    outstanding(0),
+    terminate(false)
+{
+    memset(est,        0, sizeof(est));
+    memset(sinceProbe, 0, sizeof(sinceProbe));
+
+    backlogUs[SLZW_DRV_ENGINE_CODEC]    = 0;
+    backlogUs[SLZW_DRV_ENGINE_SOFTWARE] = 0;
+    jobCount[SLZW_DRV_ENGINE_CODEC]     = 0;
+    jobCount[SLZW_DRV_ENGINE_SOFTWARE]  = 0;
+
+    for (uint32_t idx = 0; idx < numWorkers && virtBase != NULL; idx++)
+    {
+        workers.push_back(std::thread(&slzwScheduler::workerThread, this));
+    }
+}
+
+// --------------------------------------------------
+// Destructor
+// --------------------------------------------------
+
+slzwScheduler::~slzwScheduler()
+{
+    drain();
+
+    {
+        std::lock_guard<std::mutex> lock(qMutex);
+        terminate = true;
+    }
+
+    qNotEmpty.notify_all();
+
+    for (auto &t : workers)
+    {
+        t.join();
+    }
+}
+
+// --------------------------------------------------
+// Submit a job to the engine expected to finish it
+// first
+// --------------------------------------------------
+
+std::future<slzwJobResult_t> slzwScheduler::submit(const slzwJob_t &job, slzwJobCallback_t callback)
+{
+    const uint32_t len     = jobLen(job);
+    promisePtr_t   promise = std::make_shared<std::promise<slzwJobResult_t>>();
+    double         estUs;
+    uint64_t       jobId;
+    uint32_t       engine;
+
+    std::future<slzwJobResult_t> future = promise->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+
+        engine = selectEngine(job, len, estUs);
+        jobId  = nextJobId++;
+
+        backlogUs[engine] += estUs;
+        outstanding++;
+    }
+
+    jobCount[engine]++;
+
+    if (engine == SLZW_DRV_ENGINE_SOFTWARE)
+    {
+        swEntry_t entry;
+
+        entry.jobId    = jobId;
+        entry.job      = job;
+        entry.callback = callback;
+        entry.result   = promise;
+        entry.estUs    = estUs;
+
+        {
+            std::lock_guard<std::mutex> lock(qMutex);
+            swQueue.push_back(std::move(entry));
+        }
+
+        qNotEmpty.notify_one();
+    }
+    // A job only the software could take, with no software workers
+    else if (pDriver == NULL)
+    {
+        slzwJobResult_t result = {};
+
+        result.jobId  = jobId;
+        result.status = SLZW_DRV_BADSEG;
+
+        complete(job.mode, len, estUs, result, callback, promise);
+    }
+    else
+    {
+        const uint32_t mode = job.mode;
+
+        pDriver->submit(job, [this, jobId, mode, len, estUs, callback, promise](const slzwJobResult_t &driverResult)
+        {
+            slzwJobResult_t result = driverResult;
+
+            result.jobId = jobId;
+
+            complete(mode, len, estUs, result, callback, promise);
+        });
+    }
+
+    return future;
+}
+
+// --------------------------------------------------
+// Wait for all outstanding jobs to be retired
+// --------------------------------------------------
+
+void slzwScheduler::drain()
+{
+    std::unique_lock<std::mutex> lock(sMutex);
+
+    sEmpty.wait(lock, [this]{ return outstanding == 0; });
+}
+
+// --------------------------------------------------
+// Estimated job time on an engine
+// --------------------------------------------------
+
+uint32_t slzwScheduler::estimateUs(const uint32_t mode, const uint32_t len, const uint32_t engine)
+{
+    std::lock_guard<std::mutex> lock(sMutex);
+
+    return (uint32_t)(est[mode ? 1 : 0][bucket(len)][engine].usPerByte * (len ? len : 1));
+}
+
+// --------------------------------------------------
+// Choose a job's engine. Called with sMutex held.
+// --------------------------------------------------
+
+uint32_t slzwScheduler::selectEngine(const slzwJob_t &job, const uint32_t len, double &estUs)
+{
+    const uint32_t mode   = job.mode ? 1 : 0;
+    const uint32_t bkt    = bucket(len);
+    const uint32_t sel    = engineSel;
+    const bool     codec  = pDriver != NULL;
+    const bool     sw     = !workers.empty() && job.rxSegs.empty() && job.txSegs.empty() &&
+                            inMap(job.rxAddr, job.rxLen) && inMap(job.txAddr, job.txLen);
+
+    estimate_t*    e      = est[mode][bkt];
+    uint32_t       engine;
+
+    if (!sw || (codec && sel == SLZW_SCHED_CODEC_ONLY))
+    {
+        engine = SLZW_DRV_ENGINE_CODEC;
+    }
+    else if (!codec || sel == SLZW_SCHED_SOFTWARE_ONLY)
+    {
+        engine = SLZW_DRV_ENGINE_SOFTWARE;
+    }
+    // Calibrate engines without a time for this bucket
+    else if (e[SLZW_DRV_ENGINE_CODEC].samples == 0)
+    {
+        engine = SLZW_DRV_ENGINE_CODEC;
+    }
+    else if (e[SLZW_DRV_ENGINE_SOFTWARE].samples == 0)
+    {
+        engine = SLZW_DRV_ENGINE_SOFTWARE;
+    }
+    else
+    {
+        const uint32_t bytes    = len ? len : 1;
+        const double   codecEnd = backlogUs[SLZW_DRV_ENGINE_CODEC] + e[SLZW_DRV_ENGINE_CODEC].usPerByte * bytes;
+        const double   swEnd    = backlogUs[SLZW_DRV_ENGINE_SOFTWARE] / workers.size() +
+                                  e[SLZW_DRV_ENGINE_SOFTWARE].usPerByte * bytes;
+
+        engine = (codecEnd <= swEnd) ? SLZW_DRV_ENGINE_CODEC : SLZW_DRV_ENGINE_SOFTWARE;
+
+        if (++sinceProbe[mode][bkt] >= SLZW_SCHED_PROBE_INTERVAL)
+        {
+            sinceProbe[mode][bkt] = 0;
+            engine ^= 1;
+        }
+    }
+
+    estUs = e[engine].usPerByte * (len ? len : 1);
+
+    return engine;
+}
+
+// --------------------------------------------------
+// Retire a finished job from either engine
+// --------------------------------------------------
+
+void slzwScheduler::complete(const uint32_t mode, const uint32_t len, const double estUs, const slzwJobResult_t &result,
+                             const slzwJobCallback_t &callback, const promisePtr_t &promise)
+{
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+
+        backlogUs[result.engine] -= estUs;
+
+        if (backlogUs[result.engine] < 0)
+        {
+            backlogUs[result.engine] = 0;
+        }
+
+        // Only successful jobs' times are representative
+        if (result.status == SLZW_DRV_OK)
+        {
+            estimate_t &e      = est[mode ? 1 : 0][bucket(len)][result.engine];
+            const double sample = (double)result.timeUs / (len ? len : 1);
+
+            if (e.samples++ == 0)
+            {
+                e.usPerByte = sample;
+            }
+            else
+            {
+                e.usPerByte += (sample - e.usPerByte) / (1 << SLZW_SCHED_EWMA_SHIFT);
+            }
+        }
+    }
+
+    if (callback)
+    {
+        std::lock_guard<std::mutex> lock(cbMutex);
+        callback(result);
+    }
+
+    promise->set_value(result);
+
+    // Signal drain() only once the result is visible
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+
+        if (--outstanding == 0)
+        {
+            sEmpty.notify_all();
+        }
+    }
+}
+
+// --------------------------------------------------
+// Software worker thread, with a model for each
+// dictionary reset policy
+// --------------------------------------------------
+
+void slzwScheduler::workerThread()
+{
+    slzwConfig_t cfg;
+    cfg.policy       = SLZW_RESET_ON_FULL;
+    cfg.maxCodeWidth = maxCodeWidth;
+    cfg.memSize      = 0;
+    cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+    slzwModel onFull(&cfg);
+
+    cfg.policy       = SLZW_RESET_ADAPTIVE;
+
+    slzwModel adaptive(&cfg);
+
+    slzwModel* models[2] = {&onFull, &adaptive};
+
+    while (true)
+    {
+        swEntry_t entry;
+
+        {
+            std::unique_lock<std::mutex> lock(qMutex);
+
+            qNotEmpty.wait(lock, [this]{ return terminate || !swQueue.empty(); });
+
+            if (swQueue.empty())
+            {
+                return;
+            }
+
+            entry = std::move(swQueue.front());
+            swQueue.pop_front();
+        }
+
+        slzwJobResult_t result = {};
+
+        result.jobId  = entry.jobId;
+        result.engine = SLZW_DRV_ENGINE_SOFTWARE;
+
+        const uint64_t start = nowUs();
+
+        runSoftware(models, entry.job, result);
+
+        result.timeUs = (uint32_t)(nowUs() - start);
+
+        complete(entry.job.mode, jobLen(entry.job), entry.estUs, result, entry.callback, entry.result);
+    }
+}
+
+// --------------------------------------------------
+// Run a job on the software model. As for the codec,
+// output beyond the buffer is truncated, with an
+// overflow status and outLen the bytes written.
+// --------------------------------------------------
+
+void slzwScheduler::runSoftware(slzwModel* models[2], const slzwJob_t &job, slzwJobResult_t &result)
+{
+    slzwModel*     model = models[job.resetPolicy ? 1 : 0];
+    const uint8_t* rx    = virtBase + (job.rxAddr - physBase);
+    uint8_t*       tx    = virtBase + (job.txAddr - physBase);
+    int            status;
+
+    model->setChecksum(job.csumType == SLZW_DRV_ADLER32 ? SLZW_CSUM_ADLER32 : SLZW_CSUM_CRC32);
+
+    if (job.mode == SLZW_DRV_COMPRESS)
+    {
+        status = model->compress(rx, job.rxLen, tx, job.txLen, result.outLen);
+    }
+    else
+    {
+        status = model->decompress(rx, job.rxLen, tx, job.txLen, result.outLen);
+    }
+
+    result.status   = (status == SLZW_OK)           ? SLZW_DRV_OK :
+                      (status == SLZW_ERR_OVERFLOW) ? SLZW_DRV_OVERFLOW : SLZW_DRV_SWERR;
+    result.checksum = model->getChecksum();
+}
+
+// --------------------------------------------------
+// Check a buffer is in the codec memory mapping
+// --------------------------------------------------
+
+bool slzwScheduler::inMap(const uint32_t addr, const uint32_t len)
+{
+    return addr >= physBase && ((uint64_t)addr - physBase + len) <= mapSize;
+}
+
+// --------------------------------------------------
+// Size bucket of a job's input length
+// --------------------------------------------------
+
+uint32_t slzwScheduler::bucket(const uint32_t len)
+{
+    uint32_t bkt = 0;
+
+    while ((len >> (bkt + 1)) != 0 && bkt < (SLZW_SCHED_NUM_BUCKETS - 1))
+    {
+        bkt++;
+    }
+
+    return bkt;
+}
+
+// --------------------------------------------------
+// Input length of a job
+// --------------------------------------------------
+
+uint32_t slzwScheduler::jobLen(const slzwJob_t &job)
+{
+    uint32_t len = job.rxLen;
+
+    if (!job.rxSegs.empty())
+    {
+        len = 0;
+
+        for (auto &seg : job.rxSegs)
+        {
+            len += seg.len;
+        }
+    }
+
+    return len;
+}
+
+// --------------------------------------------------
+// Monotonic time in microseconds
+// --------------------------------------------------
+
+uint64_t slzwScheduler::nowUs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
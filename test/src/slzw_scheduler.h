@@ -0,0 +1,186 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW hybrid hardware/software job scheduler header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_scheduler.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-11
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definition for a scheduler running codec
+//  jobs either on the slzw_codec, through an slzwDriver, or on software
+//  worker threads running the SLZW model.
+//
+//  For small jobs the codec's register setup and status polling outweigh
+//  its speed, and for large ones the software is slow. The scheduler keeps
+//  running estimates of the job time on each engine, per mode and for sizes
+//  in power of two buckets, calibrated from the codec's measured job times
+//  (slzwJobResult_t timeUs) and the software job times. Each job goes to
+//  the engine expected to finish it first, allowing for the work already
+//  queued on each, so that software workers take jobs whilst the codec is
+//  saturated.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_SCHEDULER_H_
+#define _SLZW_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "slzw_driver.h"
+#include "slzw_model.h"
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Engine selection
+#define SLZW_SCHED_AUTO                         0   // Expected fastest engine
+#define SLZW_SCHED_CODEC_ONLY                   1
+#define SLZW_SCHED_SOFTWARE_ONLY                2
+
+// Job size buckets, by log2 of the input length (the last taking all larger)
+#define SLZW_SCHED_NUM_BUCKETS                  25
+
+// Jobs in a bucket between runs on the engine not expected to be fastest,
+// to keep its estimate current
+#define SLZW_SCHED_PROBE_INTERVAL               64
+
+// Estimates move by 1/2^SLZW_SCHED_EWMA_SHIFT of the difference to each new
+// job time
+#define SLZW_SCHED_EWMA_SHIFT                   3
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITION
+// -------------------------------------------------------------------------
+
+class slzwScheduler
+{
+public:
+    // Constructor. The driver may be NULL, for software only. The codec's
+    // memory is mapped at virtBase (of mapSize bytes), and at physBase for
+    // the codec, for the software workers to access job buffers. The
+    // software model is configured with the codec's CWMAX.
+    slzwScheduler(slzwDriver*    pDriver,
+                  uint8_t*       virtBase,
+                  const uint32_t physBase,
+                  const uint32_t mapSize,
+                  const uint32_t maxCodeWidth,
+                  const uint32_t numWorkers);
+
+    // Destructor. Retires all outstanding jobs before returning.
+    ~slzwScheduler();
+
+    // Submit a job. Scatter-gather jobs, and jobs with buffers outside of the
+    // mapping, always go to the codec. Results are not in submission order.
+    // Callbacks, if given, are called one at a time, before the future is
+    // made ready.
+    std::future<slzwJobResult_t> submit (const slzwJob_t &job, slzwJobCallback_t callback = nullptr);
+
+    // Wait until all outstanding jobs are retired
+    void     drain       ();
+
+    // Select the engines used (SLZW_SCHED_AUTO by default)
+    void     setEngines  (const uint32_t sel) { engineSel = sel; };
+
+    // Estimated job time, in microseconds, for a mode, input length and
+    // engine (0 if not yet calibrated)
+    uint32_t estimateUs  (const uint32_t mode, const uint32_t len, const uint32_t engine);
+
+    // Jobs run on each engine
+    uint64_t engineJobs  (const uint32_t engine) { return jobCount[engine]; };
+
+private:
+
+    // Running job time estimate for a bucket and engine
+    typedef struct {
+        double                          usPerByte;
+        uint32_t                        samples;
+    } estimate_t;
+
+    typedef std::shared_ptr<std::promise<slzwJobResult_t>> promisePtr_t;
+
+    // Software queue entry
+    typedef struct {
+        uint64_t                        jobId;
+        slzwJob_t                       job;
+        slzwJobCallback_t               callback;
+        promisePtr_t                    result;
+        double                          estUs;
+    } swEntry_t;
+
+    // Software worker thread loop
+    void     workerThread ();
+
+    // Run a job on a worker's models
+    void     runSoftware  (slzwModel* models[2], const slzwJob_t &job, slzwJobResult_t &result);
+
+    // Choose the engine for a job, returning its estimated time
+    uint32_t selectEngine (const slzwJob_t &job, const uint32_t len, double &estUs);
+
+    // Update the estimate, and the engine's backlog, for a finished job,
+    // call its callback and fulfil its promise
+    void     complete     (const uint32_t mode, const uint32_t len, const double estUs, const slzwJobResult_t &result,
+                           const slzwJobCallback_t &callback, const promisePtr_t &promise);
+
+    // Whether a buffer is wholly in the codec memory mapping
+    bool     inMap        (const uint32_t addr, const uint32_t len);
+
+    static uint32_t bucket  (const uint32_t len);
+    static uint32_t jobLen  (const slzwJob_t &job);
+    static uint64_t nowUs   ();
+
+    slzwDriver*                         pDriver;
+    uint8_t*                            virtBase;
+    const uint32_t                      physBase;
+    const uint32_t                      mapSize;
+    const uint32_t                      maxCodeWidth;
+    std::atomic<uint32_t>               engineSel;
+
+    // Estimates and backlogs, guarded by sMutex
+    estimate_t                          est[2][SLZW_SCHED_NUM_BUCKETS][2];
+    uint32_t                            sinceProbe[2][SLZW_SCHED_NUM_BUCKETS];
+    double                              backlogUs[2];   // Estimated time of queued and running jobs
+    uint64_t                            nextJobId;
+    uint32_t                            outstanding;
+    std::atomic<uint64_t>               jobCount[2];
+    std::mutex                          sMutex;
+    std::condition_variable             sEmpty;
+
+    // Callbacks are serialised
+    std::mutex                          cbMutex;
+
+    // Software jobs
+    std::deque<swEntry_t>               swQueue;
+    bool                                terminate;
+    std::mutex                          qMutex;
+    std::condition_variable             qNotEmpty;
+    std::vector<std::thread>            workers;
+};
+
+#endif
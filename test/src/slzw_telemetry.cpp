@@ -0,0 +1,410 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec job telemetry
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_telemetry.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-13
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods for the codec job telemetry histograms
+//  and their Prometheus text format output.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "slzw_telemetry.h"
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#define SUB_MASK                  ((1ULL << SLZW_HIST_SUB_BITS) - 1)
+#define MAX_VALUE                 ((1ULL << (SLZW_HIST_MAX_BITS + 1)) - 1)
+
+// --------------------------------------------------
+// LOCAL STATICS
+// --------------------------------------------------
+
+// Summary quantiles written to the Prometheus file
+static const double   quantiles[]  = {0.5, 0.9, 0.99, 0.999};
+
+static const char*    modeNames[]  = {"decompress", "compress"};
+static const char*    statusNames[SLZW_TLM_NUM_STATUS] = {"ok", "timeout", "badseg", "swerr", "overflow"};
+
+// Prometheus metric names, help text and value scaling of each histogram
+static const struct {
+    const char* name;
+    const char* help;
+    double      scale;
+} metrics[SLZW_TLM_NUM_METRICS] = {
+    {"slzw_job_latency_seconds",             "Codec job latency, from submit to complete",            1e-6},
+    {"slzw_job_setup_seconds",               "Codec job register setup time, to start",               1e-6},
+    {"slzw_job_wait_seconds",                "Codec job wait time, from start to finished",           1e-6},
+    {"slzw_job_throughput_bytes_per_second", "Codec job input bytes per second of wait time",         1.0},
+    {"slzw_job_codec_cycles",                "Codec job clock cycles, from the job_cycles counter",   1.0}
+};
+
+// ==================================================
+// slzwHistogram
+// ==================================================
+
+void slzwHistogram::reset()
+{
+    memset(counts, 0, sizeof(counts));
+
+    total    = 0;
+    valueSum = 0;
+    minValue = 0;
+    maxValue = 0;
+}
+
+// --------------------------------------------------
+// Values below 2^SUB_BITS have their own buckets.
+// Above that, the bucket is the value's power of two,
+// and its SUB_BITS bits below the leading one.
+// --------------------------------------------------
+
+uint32_t slzwHistogram::bucket(const uint64_t valueIn)
+{
+    const uint64_t value = (valueIn > MAX_VALUE) ? MAX_VALUE : valueIn;
+
+    if (value <= SUB_MASK)
+    {
+        return (uint32_t)value;
+    }
+
+    const uint32_t msb = 63 - __builtin_clzll(value);
+
+    return ((msb - SLZW_HIST_SUB_BITS + 1) << SLZW_HIST_SUB_BITS) + ((value >> (msb - SLZW_HIST_SUB_BITS)) & SUB_MASK);
+}
+
+uint64_t slzwHistogram::bucketHigh(const uint32_t idx)
+{
+    if (idx <= SUB_MASK)
+    {
+        return idx;
+    }
+
+    const uint32_t shift = (idx >> SLZW_HIST_SUB_BITS) - 1;
+
+    return (((SUB_MASK + 1) + (idx & SUB_MASK)) << shift) + (1ULL << shift) - 1;
+}
+
+void slzwHistogram::record(const uint64_t value)
+{
+    counts[bucket(value)]++;
+
+    minValue  = (total == 0 || value < minValue) ? value : minValue;
+    maxValue  = (value > maxValue) ? value : maxValue;
+    valueSum += value;
+    total++;
+}
+
+void slzwHistogram::merge(const slzwHistogram &other)
+{
+    if (other.total == 0)
+    {
+        return;
+    }
+
+    for (uint32_t idx = 0; idx < SLZW_HIST_BUCKETS; idx++)
+    {
+        counts[idx] += other.counts[idx];
+    }
+
+    minValue  = (total == 0 || other.minValue < minValue) ? other.minValue : minValue;
+    maxValue  = (other.maxValue > maxValue) ? other.maxValue : maxValue;
+    valueSum += other.valueSum;
+    total    += other.total;
+}
+
+// --------------------------------------------------
+// The percentile is the top of the bucket holding the
+// nth value, limited to the largest value recorded
+// --------------------------------------------------
+
+uint64_t slzwHistogram::percentile(const double pc) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(pc / 100.0 * total + 0.5);
+    uint64_t seen = 0;
+
+    rank = (rank == 0) ? 1 : (rank > total) ? total : rank;
+
+    for (uint32_t idx = 0; idx < SLZW_HIST_BUCKETS; idx++)
+    {
+        seen += counts[idx];
+
+        if (seen >= rank)
+        {
+            const uint64_t high = bucketHigh(idx);
+
+            return (high > maxValue) ? maxValue : (high < minValue) ? minValue : high;
+        }
+    }
+
+    return maxValue;
+}
+
+// ==================================================
+// slzwTelemetry
+// ==================================================
+
+void slzwTelemetry::reset()
+{
+    std::lock_guard<std::mutex> lock(tMutex);
+
+    for (auto &h : hist)
+    {
+        h.reset();
+    }
+
+    memset(jobCount, 0, sizeof(jobCount));
+    memset(inBytes,  0, sizeof(inBytes));
+    memset(outBytes, 0, sizeof(outBytes));
+}
+
+// --------------------------------------------------
+// Size classes are powers of four, from 1KB
+// --------------------------------------------------
+
+uint32_t slzwTelemetry::sizeClass(const uint32_t len)
+{
+    uint32_t sc = 0;
+
+    while (sc < SLZW_TLM_NUM_SIZES - 1 && len > sizeClassMax(sc))
+    {
+        sc++;
+    }
+
+    return sc;
+}
+
+uint32_t slzwTelemetry::sizeClassMax(const uint32_t sc)
+{
+    return (sc < SLZW_TLM_NUM_SIZES - 1) ? 1U << (SLZW_TLM_MIN_SIZE_LOG2 + 2 * sc) : 0;
+}
+
+// --------------------------------------------------
+// Record a job. Failed jobs are only counted.
+// --------------------------------------------------
+
+void slzwTelemetry::record(const slzwTlmSample_t &sample)
+{
+    const uint32_t mode   = sample.mode & 1;
+    const uint32_t sc     = sizeClass(sample.inLen);
+    const uint32_t status = (sample.status >= 0 && sample.status < SLZW_TLM_NUM_STATUS) ? sample.status : 0;
+
+    std::lock_guard<std::mutex> lock(tMutex);
+
+    jobCount[mode][status]++;
+
+    if (sample.status != 0)
+    {
+        return;
+    }
+
+    inBytes[mode]  += sample.inLen;
+    outBytes[mode] += sample.outLen;
+
+    hist[histIdx(mode, sc, SLZW_TLM_LATENCY)].record(sample.latencyUs);
+    hist[histIdx(mode, sc, SLZW_TLM_SETUP)].record(sample.setupUs);
+    hist[histIdx(mode, sc, SLZW_TLM_WAIT)].record(sample.waitUs);
+
+    if (sample.waitUs)
+    {
+        hist[histIdx(mode, sc, SLZW_TLM_THROUGHPUT)].record((uint64_t)sample.inLen * 1000000ULL / sample.waitUs);
+    }
+
+    // A zero count is from a codec without the counter
+    if (sample.codecCycles)
+    {
+        hist[histIdx(mode, sc, SLZW_TLM_CODEC_CYCLES)].record(sample.codecCycles);
+    }
+}
+
+// --------------------------------------------------
+// Histogram and counter read back
+// --------------------------------------------------
+
+slzwHistogram slzwTelemetry::snapshot(const uint32_t mode, const uint32_t sc, const uint32_t metric)
+{
+    std::lock_guard<std::mutex> lock(tMutex);
+
+    return hist[histIdx(mode, sc, metric)];
+}
+
+slzwHistogram slzwTelemetry::snapshot(const uint32_t mode, const uint32_t metric)
+{
+    slzwHistogram               all;
+    std::lock_guard<std::mutex> lock(tMutex);
+
+    for (uint32_t sc = 0; sc < SLZW_TLM_NUM_SIZES; sc++)
+    {
+        all.merge(hist[histIdx(mode, sc, metric)]);
+    }
+
+    return all;
+}
+
+uint64_t slzwTelemetry::jobs(const uint32_t mode, const int status)
+{
+    std::lock_guard<std::mutex> lock(tMutex);
+
+    return (status >= 0 && status < SLZW_TLM_NUM_STATUS) ? jobCount[mode & 1][status] : 0;
+}
+
+uint64_t slzwTelemetry::bytesIn(const uint32_t mode)
+{
+    std::lock_guard<std::mutex> lock(tMutex);
+
+    return inBytes[mode & 1];
+}
+
+uint64_t slzwTelemetry::bytesOut(const uint32_t mode)
+{
+    std::lock_guard<std::mutex> lock(tMutex);
+
+    return outBytes[mode & 1];
+}
+
+// --------------------------------------------------
+// Write the Prometheus text format file, as a summary
+// per histogram metric, with op (mode) and size
+// (class maximum input length) labels, and counters.
+// Empty histograms are skipped.
+// --------------------------------------------------
+
+int slzwTelemetry::writePrometheus(const char* filename)
+{
+    std::vector<slzwHistogram> h;
+    uint64_t                   jc[2][SLZW_TLM_NUM_STATUS];
+    uint64_t                   ib[2];
+    uint64_t                   ob[2];
+
+    // Copy the telemetry, so as not to hold up the driver whilst writing
+    {
+        std::lock_guard<std::mutex> lock(tMutex);
+
+        h = hist;
+        memcpy(jc, jobCount, sizeof(jc));
+        memcpy(ib, inBytes,  sizeof(ib));
+        memcpy(ob, outBytes, sizeof(ob));
+    }
+
+    std::string tmpName = std::string(filename) + ".tmp";
+    FILE*       fp;
+
+    if ((fp = fopen(tmpName.c_str(), "w")) == NULL)
+    {
+        fprintf(stderr, "*** writePrometheus(): Unable to open file %s for writing\n", tmpName.c_str());
+        return 1;
+    }
+
+    for (uint32_t metric = 0; metric < SLZW_TLM_NUM_METRICS; metric++)
+    {
+        const double scale = metrics[metric].scale;
+
+        fprintf(fp, "# HELP %s %s\n", metrics[metric].name, metrics[metric].help);
+        fprintf(fp, "# TYPE %s summary\n", metrics[metric].name);
+
+        for (uint32_t mode = 0; mode < 2; mode++)
+        {
+            for (uint32_t sc = 0; sc < SLZW_TLM_NUM_SIZES; sc++)
+            {
+                const slzwHistogram &m = h[histIdx(mode, sc, metric)];
+                char                 labels[64];
+
+                if (m.count() == 0)
+                {
+                    continue;
+                }
+
+                if (sizeClassMax(sc))
+                {
+                    snprintf(labels, sizeof(labels), "op=\"%s\",size=\"%u\"", modeNames[mode], sizeClassMax(sc));
+                }
+                else
+                {
+                    snprintf(labels, sizeof(labels), "op=\"%s\",size=\"+Inf\"", modeNames[mode]);
+                }
+
+                for (auto q : quantiles)
+                {
+                    fprintf(fp, "%s{%s,quantile=\"%g\"} %.9g\n", metrics[metric].name, labels, q,
+                            m.percentile(q * 100.0) * scale);
+                }
+
+                fprintf(fp, "%s_sum{%s} %.9g\n", metrics[metric].name, labels, m.sum() * scale);
+                fprintf(fp, "%s_count{%s} %llu\n", metrics[metric].name, labels, (unsigned long long)m.count());
+            }
+        }
+    }
+
+    fprintf(fp, "# HELP slzw_jobs_total Codec jobs retired, by status\n");
+    fprintf(fp, "# TYPE slzw_jobs_total counter\n");
+
+    for (uint32_t mode = 0; mode < 2; mode++)
+    {
+        for (uint32_t status = 0; status < SLZW_TLM_NUM_STATUS; status++)
+        {
+            fprintf(fp, "slzw_jobs_total{op=\"%s\",status=\"%s\"} %llu\n", modeNames[mode], statusNames[status],
+                    (unsigned long long)jc[mode][status]);
+        }
+    }
+
+    fprintf(fp, "# HELP slzw_bytes_in_total Codec input bytes of successful jobs\n");
+    fprintf(fp, "# TYPE slzw_bytes_in_total counter\n");
+
+    for (uint32_t mode = 0; mode < 2; mode++)
+    {
+        fprintf(fp, "slzw_bytes_in_total{op=\"%s\"} %llu\n", modeNames[mode], (unsigned long long)ib[mode]);
+    }
+
+    fprintf(fp, "# HELP slzw_bytes_out_total Codec output bytes of successful jobs\n");
+    fprintf(fp, "# TYPE slzw_bytes_out_total counter\n");
+
+    for (uint32_t mode = 0; mode < 2; mode++)
+    {
+        fprintf(fp, "slzw_bytes_out_total{op=\"%s\"} %llu\n", modeNames[mode], (unsigned long long)ob[mode]);
+    }
+
+    if (fclose(fp) != 0 || rename(tmpName.c_str(), filename) != 0)
+    {
+        fprintf(stderr, "*** writePrometheus(): Error writing file %s\n", filename);
+        remove(tmpName.c_str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+// -----------------------------------------------------------------------------
+//  Title      : SLZW codec job telemetry header
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : slzw_telemetry.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-13
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the class definitions for the codec job telemetry
+//  kept by slzwDriver: latency and throughput histograms, per mode and for
+//  job sizes in classes of powers of four, with job and byte counters.
+//
+//  The histograms are log-linear, as HdrHistogram: each power of two range
+//  is split into 2^SLZW_HIST_SUB_BITS linear sub-buckets, so that recorded
+//  values, and the percentiles read back, are within 1/2^SLZW_HIST_SUB_BITS
+//  of the true value, over the whole range, in a fixed size table.
+//
+//  The telemetry can be read back as histogram snapshots, or written as a
+//  Prometheus text exposition format file, with summaries of each histogram
+//  and the counters, for a node exporter textfile collector.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _SLZW_TELEMETRY_H_
+#define _SLZW_TELEMETRY_H_
+
+#include <stdint.h>
+
+#include <vector>
+#include <mutex>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+// Histogram sub-buckets per power of two (log2), and the largest recorded
+// value (log2), above which values are counted in the last bucket
+#define SLZW_HIST_SUB_BITS                      4
+#define SLZW_HIST_MAX_BITS                      40
+#define SLZW_HIST_BUCKETS                       ((SLZW_HIST_MAX_BITS - SLZW_HIST_SUB_BITS + 2) << SLZW_HIST_SUB_BITS)
+
+// Job size classes, by input length: up to 1KB, 4KB, 16KB ... 1MB, and larger
+#define SLZW_TLM_NUM_SIZES                      7
+#define SLZW_TLM_MIN_SIZE_LOG2                  10
+
+// Histogram metrics
+#define SLZW_TLM_LATENCY                        0   // Submit to complete, in us
+#define SLZW_TLM_SETUP                          1   // Register setup to start, in us
+#define SLZW_TLM_WAIT                           2   // Start to finished seen, in us (polls in simulation)
+#define SLZW_TLM_THROUGHPUT                     3   // Input bytes per second of wait time
+#define SLZW_TLM_CODEC_CYCLES                   4   // Codec job_cycles counter, if present
+#define SLZW_TLM_NUM_METRICS                    5
+
+// Job status counters, matching the slzwJobResult_t status values
+#define SLZW_TLM_NUM_STATUS                     5
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// Measurements of a retired codec job
+typedef struct {
+    uint32_t     mode;          // SLZW_DRV_COMPRESS or SLZW_DRV_DECOMPRESS
+    int          status;        // slzwJobResult_t status
+    uint32_t     inLen;         // Input bytes
+    uint32_t     outLen;        // Output bytes produced
+    uint64_t     latencyUs;     // Submit to complete
+    uint64_t     setupUs;       // Start of register setup to start
+    uint64_t     waitUs;        // Start to finished seen
+    uint32_t     codecCycles;   // Codec job_cycles counter (0 if not present)
+} slzwTlmSample_t;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITIONS
+// -------------------------------------------------------------------------
+
+class slzwHistogram
+{
+public:
+    slzwHistogram() { reset(); };
+
+    void     reset      ();
+
+    // Record a value
+    void     record     (const uint64_t value);
+
+    // Add the counts of another histogram
+    void     merge      (const slzwHistogram &other);
+
+    // Value at or below which the given percentage (0 to 100) of the
+    // recorded values lie, to the histogram's resolution (0 if empty)
+    uint64_t percentile (const double pc) const;
+
+    uint64_t count      () const { return total; };
+    uint64_t sum        () const { return valueSum; };
+    uint64_t min        () const { return total ? minValue : 0; };
+    uint64_t max        () const { return maxValue; };
+    double   mean       () const { return total ? (double)valueSum / total : 0.0; };
+
+    // Bucket of a value, and the largest value in a bucket
+    static uint32_t bucket     (const uint64_t value);
+    static uint64_t bucketHigh (const uint32_t idx);
+
+private:
+    uint64_t     counts[SLZW_HIST_BUCKETS];
+    uint64_t     total;
+    uint64_t     valueSum;
+    uint64_t     minValue;
+    uint64_t     maxValue;
+};
+
+class slzwTelemetry
+{
+public:
+    slzwTelemetry() : hist(2 * SLZW_TLM_NUM_SIZES * SLZW_TLM_NUM_METRICS) { reset(); };
+
+    void     reset       ();
+
+    // Record a retired job's measurements
+    void     record      (const slzwTlmSample_t &sample);
+
+    // Copy of a metric's histogram for a mode and size class
+    slzwHistogram snapshot (const uint32_t mode, const uint32_t sizeClass, const uint32_t metric);
+
+    // Copy of a metric's histogram for a mode, over all sizes
+    slzwHistogram snapshot (const uint32_t mode, const uint32_t metric);
+
+    // Jobs retired with a status, and bytes in and out of successful jobs,
+    // for a mode
+    uint64_t jobs        (const uint32_t mode, const int status);
+    uint64_t bytesIn     (const uint32_t mode);
+    uint64_t bytesOut    (const uint32_t mode);
+
+    // Write the telemetry to a file in the Prometheus text format. The file
+    // is written under a temporary name and renamed, so that a collector
+    // never reads a partial file. Returns non-zero on error.
+    int      writePrometheus (const char* filename);
+
+    // Size class of an input length, and the largest length in a class
+    // (0 for the unbounded last class)
+    static uint32_t sizeClass    (const uint32_t len);
+    static uint32_t sizeClassMax (const uint32_t sizeClass);
+
+private:
+    // Index of a histogram
+    static uint32_t histIdx (const uint32_t mode, const uint32_t sizeClass, const uint32_t metric)
+                            { return ((mode & 1) * SLZW_TLM_NUM_SIZES + sizeClass) * SLZW_TLM_NUM_METRICS + metric; };
+
+    // Histograms for each mode, size class and metric. Held on the heap, as
+    // they are several hundred KB, and drivers may be on a thread's stack.
+    std::vector<slzwHistogram>  hist;
+    uint64_t                    jobCount[2][SLZW_TLM_NUM_STATUS];
+    uint64_t                    inBytes[2];
+    uint64_t                    outBytes[2];
+
+    std::mutex                  tMutex;
+};
+
+#endif
@@ -45,6 +45,12 @@
 #define TB_CAPTURE_ADDR                         (TB_BASE_ADDR + 4)
 #define TB_IMG_WIDTH_PX                         (TB_BASE_ADDR + 8)
 
+// Test bench ticket lock, queueing VProc nodes for the codec
+#define TB_LOCK_BASE_ADDR                       0x70000000
+#define TB_LOCK_TICKET_REG                      (TB_LOCK_BASE_ADDR + 0)
+#define TB_LOCK_SERVING_REG                     (TB_LOCK_BASE_ADDR + 4)
+#define TB_LOCK_QUEUED_REG                      (TB_LOCK_BASE_ADDR + 8)
+
 #define TB_SIM_CTRL_ERROR_MASK                  0x00000001
 #define TB_SIM_CTRL_STOP_MASK                   0x00000002
 #define TB_SIM_CTRL_FINISH_MASK                 0x00000004
@@ -43,6 +43,8 @@
 #include "tests.h"
 #include "testsLocal.h"
 #include "utils.h"
+#include "slzw_model.h"
+#include "slzw_driver.h"
 
 using namespace std;
 
@@ -94,7 +96,46 @@ int tests::start(uint32_t* coreBaseAddr, config_t config, int node)
 
 
 // --------------------------------------------------
-// Test serialisation of real nozzle data and images
+// Read back len bytes of memory at addr in one block
+// and compare against golden data. Returns
+// TEST_ERROR on a mismatch.
+// --------------------------------------------------
+
+int tests::checkMem (const uint32_t addr, const uint8_t* golden, const uint32_t len, const char* name)
+{
+    std::vector<uint8_t> data(len);
+    uint32_t             mismatches = 0;
+
+    directReadMemBlock(addr, data.data(), len);
+
+    for (uint32_t idx = 0; idx < len; idx++)
+    {
+        if (data[idx] != golden[idx])
+        {
+            if (mismatches == 0)
+            {
+                VPrint("***ERROR: %s mismatch at byte %d (addr 0x%08x): got 0x%02x, expected 0x%02x\n",
+                       name, idx, addr + idx, data[idx], golden[idx]);
+            }
+            mismatches++;
+        }
+    }
+
+    if (mismatches)
+    {
+        VPrint("***ERROR: %s has %d of %d bytes mismatched\n", name, mismatches, len);
+        return TEST_ERROR;
+    }
+
+    VPrint("%s matched (%d bytes)\n", name, len);
+
+    return NOERROR;
+}
+
+// --------------------------------------------------
+// Codec test: load input data to memory in one block,
+// compress it, and optionally check the output against
+// the software model's stream
 // --------------------------------------------------
 
 int tests::codecTest (CCoreAuto*     pCore,
@@ -102,21 +143,45 @@ int tests::codecTest (CCoreAuto*     pCore,
                         int            node)
 {
 
-    int      error = 0;
-    
-    uint32_t start_addr = START_PHY_MEM + 104;
+    int                  error = 0;
+    std::vector<uint8_t> rxData;
 
-    // Fill in some test data in memory
-    uint32_t addr = start_addr;
-    for (int idx; idx < 1024; idx++, addr+=4)
+    // Get the input data from file, or generate it
+    if (!config.dataFile.empty())
+    {
+        if (readFile(config.dataFile.c_str(), rxData))
+        {
+            return TEST_ERROR;
+        }
+    }
+    else
     {
-        WriteRamWord(addr, idx, 1, node);
+        genTestData(rxData, config.dataLen, config, pCore->pSlzwCodec->pConfig->GetMaxCw(),
+                    pCore->pSlzwCodec->pConfig->GetMemSize());
+    }
+
+    uint32_t rx_addr = START_PHY_MEM + RX_BUF_OFFSET;
+    uint32_t tx_addr = (rx_addr + rxData.size() + TX_BUF_GAP + 3) & ~3;
+    uint32_t tx_len  = rxData.size() * 2 + 16;
+
+    // Preload the input data directly into memory
+    directWriteMemBlock(rx_addr, rxData.data(), rxData.size());
+
+    // Set up RX and TX config
+    pCore->pSlzwCodec->pRxStartAddr->SetRxStartAddr(rx_addr);
+    pCore->pSlzwCodec->pRxLen->SetRxLen(rxData.size());
+    pCore->pSlzwCodec->pTxStartAddr->SetTxStartAddr(tx_addr);
+    pCore->pSlzwCodec->pTxLen->SetTxLen(tx_len);
+    pCore->pSlzwCodec->pControl->SetMode(1);
+
+    // Capture the job's event trace, if requested
+    slzwDriver drv(pCore, 1, false);
+
+    if (!config.traceFile.empty())
+    {
+        drv.enableTrace(true);
     }
 
-    // Set up RX config
-    pCore->pSlzwCodec->pRxStartAddr->SetRxStartAddr(start_addr);
-    pCore->pSlzwCodec->pRxLen->SetRxLen(1600);
-    
     // Start DMA
     pCore->pSlzwCodec->pControl->SetStart(1);
 
@@ -129,5 +194,45 @@ int tests::codecTest (CCoreAuto*     pCore,
     }
     while(!finished);
 
+    VPrint("Codec job of %zu bytes took %d cycles\n", rxData.size(), pCore->pSlzwCodec->pJobCycles->GetJobCycles());
+
+    if (!config.traceFile.empty())
+    {
+        std::vector<slzwTraceEntry_t> trace;
+
+        if (drv.readTrace(trace))
+        {
+            VPrint("***WARNING: event trace entries dropped\n");
+        }
+
+        drv.enableTrace(false);
+
+        VPrint("%zu event trace entries written to %s\n", trace.size(), config.traceFile.c_str());
+
+        error |= slzwDriver::writeTrace(config.traceFile.c_str(), trace) ? TEST_ERROR : NOERROR;
+    }
+
+    // Check the output against the software model, configured to match the codec build
+    if (config.checkOutput)
+    {
+        slzwConfig_t cfg;
+        cfg.policy       = SLZW_RESET_ON_FULL;
+        cfg.maxCodeWidth = pCore->pSlzwCodec->pConfig->GetMaxCw();
+        cfg.memSize      = pCore->pSlzwCodec->pConfig->GetMemSize();
+        cfg.checkGap     = SLZW_DEFAULT_CHECKGAP;
+
+        slzwModel            model(&cfg);
+        std::vector<uint8_t> golden(tx_len);
+        uint32_t             golden_len;
+
+        if (model.compress(rxData.data(), rxData.size(), golden.data(), golden.size(), golden_len) != SLZW_OK)
+        {
+            VPrint("***ERROR: software model failed to compress test data\n");
+            return TEST_ERROR;
+        }
+
+        error |= checkMem(tx_addr, golden.data(), golden_len, "Codec output");
+    }
+
     return error;
 }
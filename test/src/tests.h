@@ -58,6 +58,8 @@ private:
 
     int      codecTest  (CCoreAuto* pCore, const config_t config, const int node);
 
+    int      checkMem   (const uint32_t addr, const uint8_t* golden, const uint32_t len, const char* name);
+
 };
 
 #endif
@@ -40,6 +40,11 @@
 // Address of physical memory where output data starts
 #define START_PHY_MEM                           0x20000000
 
+// Codec test buffer placement: input offset from start of memory, and gap
+// between the end of the input and the output
+#define RX_BUF_OFFSET                           104
+#define TX_BUF_GAP                              0x1000
+
 #define TEST_ERROR                              1
 #define NOERROR                                 0
 
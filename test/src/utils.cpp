@@ -68,7 +68,22 @@ int parseArgs(int argcIn, char** argvIn, config_t &cfg)
     char   delim[2];
     FILE* fp;
     
-    cfg.testnum    = 0;
+    cfg.testnum     = 0;
+    cfg.dataFile    = "";
+    cfg.dataLen     = DEFAULT_TEST_DATA_LEN;
+    cfg.corpus      = SLZW_CORPUS_COUNTER;
+    cfg.seed        = SLZW_CORPUS_DEFAULT_SEED;
+    cfg.checkOutput = false;
+    cfg.traceFile   = "";
+
+    cfg.clientJobs     = DEFAULT_CLIENT_JOBS;
+    cfg.clientIdleNs   = 0;
+
+    cfg.memRdLatency   = 0;
+    cfg.memWrLatency   = 0;
+    cfg.memJitter      = 0;
+    cfg.memOutstanding = 0;
+    cfg.memStallRate   = 0;
 
     if (argcIn > 1)
     {
@@ -106,17 +121,90 @@ int parseArgs(int argcIn, char** argvIn, config_t &cfg)
 
 
     opterr = 0;
-    while ((c = getopt (argc, argv, "ht:")) != -1)
+    while ((c = getopt (argc, argv, "ht:f:l:g:s:cmR:W:J:O:S:T:n:i:")) != -1)
     {
         switch (c)
         {
         case 't':
             cfg.testnum      = atoi(optarg);
             break;
+        case 'f':
+            cfg.dataFile     = optarg;
+            break;
+        case 'l':
+            cfg.dataLen      = strtol(optarg, NULL, 0);
+            break;
+        case 'g':
+            if (slzwCorpus::lookup(optarg) < 0)
+            {
+                fprintf(stderr, "*** parseArgs(): unknown test data family %s\n", optarg);
+                returnVal = 1;
+            }
+            else
+            {
+                cfg.corpus   = slzwCorpus::lookup(optarg);
+            }
+            break;
+        case 's':
+            cfg.seed         = strtoull(optarg, NULL, 0);
+            break;
+        case 'c':
+            cfg.checkOutput  = true;
+            break;
+        case 'T':
+            cfg.traceFile    = optarg;
+            break;
+        case 'n':
+            cfg.clientJobs     = strtol(optarg, NULL, 0);
+            break;
+        case 'i':
+            cfg.clientIdleNs   = strtol(optarg, NULL, 0);
+            break;
+        case 'm':
+            cfg.memRdLatency   = MEM_DE10_RD_LATENCY;
+            cfg.memWrLatency   = MEM_DE10_WR_LATENCY;
+            cfg.memJitter      = MEM_DE10_JITTER;
+            cfg.memOutstanding = MEM_DE10_OUTSTANDING;
+            cfg.memStallRate   = MEM_DE10_STALL_RATE;
+            break;
+        case 'R':
+            cfg.memRdLatency   = strtol(optarg, NULL, 0);
+            break;
+        case 'W':
+            cfg.memWrLatency   = strtol(optarg, NULL, 0);
+            break;
+        case 'J':
+            cfg.memJitter      = strtol(optarg, NULL, 0);
+            break;
+        case 'O':
+            cfg.memOutstanding = strtol(optarg, NULL, 0);
+            break;
+        case 'S':
+            cfg.memStallRate   = strtol(optarg, NULL, 0);
+            break;
         case 'h':
         default:
-            printf("Usage: vusermain.cfg [-h] [-t <test num>]\n");
+            printf("Usage: vusermain.cfg [-h] [-t <test num>] [-f <file>] [-l <len>] [-g <family>] [-s <seed>] [-c] [-T <file>] [-n <jobs>] [-i <ns>] [-m] [-R <cycles>] [-W <cycles>] [-J <cycles>] [-O <num>] [-S <rate>]\n");
             printf("         -t Specify test (default 0)\n");
+            printf("         -f Codec test input data file (default generated data)\n");
+            printf("         -l Generated codec test data length in bytes (default %d)\n", DEFAULT_TEST_DATA_LEN);
+            printf("         -g Generated codec test data family (default counter):");
+            for (int idx = 0; idx < SLZW_CORPUS_NUM_TYPES; idx++)
+            {
+                printf(" %s", slzwCorpus::name((slzwCorpusType_t)idx));
+            }
+            printf("\n");
+            printf("         -s Generated codec test data seed (default %d)\n", SLZW_CORPUS_DEFAULT_SEED);
+            printf("         -c Check codec output against the software model\n");
+            printf("         -T Write the codec event trace to file\n");
+            printf("         -n Codec jobs run by each client node (default %d)\n", DEFAULT_CLIENT_JOBS);
+            printf("         -i Client node idle time between jobs in ns (default 0)\n");
+            printf("         -m Memory model timing like the DE10-nano F2SDRAM port (later options override)\n");
+            printf("         -R Memory model read latency in cycles (default 0)\n");
+            printf("         -W Memory model write response latency in cycles (default 0)\n");
+            printf("         -J Memory model maximum random latency jitter in cycles (default 0)\n");
+            printf("         -O Memory model outstanding bursts per direction (default 0, model maximum)\n");
+            printf("         -S Memory model stall probability each cycle, in 256ths (default 0)\n");
             printf("\n");
             returnVal = 1;
             break;
@@ -125,3 +213,17 @@ int parseArgs(int argcIn, char** argvIn, config_t &cfg)
 
     return returnVal;
 }
+
+// --------------------------------------------------
+// Generate len bytes of test data, of the configured
+// family and seed, with hash collision data for the
+// codec's dictionary size
+// --------------------------------------------------
+
+void genTestData(std::vector<uint8_t> &buf, const uint32_t len, const config_t &cfg,
+                 const uint32_t maxCodeWidth, const uint32_t memSize)
+{
+    slzwCorpus corpus(cfg.seed, maxCodeWidth, memSize);
+
+    corpus.generate((slzwCorpusType_t)cfg.corpus, buf, len);
+}
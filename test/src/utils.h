@@ -29,16 +29,51 @@
 // -----------------------------------------------------------------------------
 
 #include <string>
+#include <vector>
+#include <stdint.h>
 
 #ifndef _UTILS_H_
 #define _UTILS_H_
 
+#include "slzw_corpus.h"
+#include "slzw_file.h"
+
+// Default length of generated codec test data, in bytes
+#define DEFAULT_TEST_DATA_LEN 4096
+
+// Default codec jobs run by each client VProc node in the contention test
+#define DEFAULT_CLIENT_JOBS   4
+
+// Memory model timing approximating the DE10-nano F2SDRAM port (-m option)
+#define MEM_DE10_RD_LATENCY   30
+#define MEM_DE10_WR_LATENCY   20
+#define MEM_DE10_JITTER       8
+#define MEM_DE10_OUTSTANDING  8
+#define MEM_DE10_STALL_RATE   51
+
 typedef struct {
     int         testnum;
     uint32_t    clkFreqMHz;
+    std::string dataFile;       // Codec test input file (generated data if empty)
+    uint32_t    dataLen;        // Generated codec test data length in bytes
+    uint32_t    corpus;         // Generated codec test data family (slzwCorpusType_t)
+    uint64_t    seed;           // Generated codec test data seed
+    bool        checkOutput;    // Check codec output against the software model
+    std::string traceFile;      // Codec event trace output file (no trace if empty)
+    uint32_t    clientJobs;     // Codec jobs run by each client node in the contention test
+    uint32_t    clientIdleNs;   // Client node idle time between its jobs, in ns
+
+    // Test bench memory model timing (all zero for ideal memory)
+    uint32_t    memRdLatency;   // Read latency in cycles
+    uint32_t    memWrLatency;   // Write response latency in cycles
+    uint32_t    memJitter;      // Maximum random latency added, in cycles
+    uint32_t    memOutstanding; // Outstanding bursts per direction (0 for model maximum)
+    uint32_t    memStallRate;   // Probability of a ready/data stall each cycle, in 256ths
 
 } config_t;
 
 extern int           parseArgs   (int argcIn, char** argvIn, config_t &cfg);
+extern void          genTestData (std::vector<uint8_t> &buf, const uint32_t len, const config_t &cfg,
+                                  const uint32_t maxCodeWidth, const uint32_t memSize);
 
 #endif
@@ -8,6 +8,11 @@
 // -----------------------------------------------------------------------------
 //  Description:
 //  This block is the top level test bench for the vslzw core component
+//
+//  Node 0's VProc runs the directed tests. NUM_CLIENTS further VProc nodes
+//  (1 to NUM_CLIENTS) can be added, as independent host threads submitting
+//  codec jobs. All the nodes share the CSR bus through a round robin arbiter,
+//  and queue for the codec on a ticket lock.
 // -----------------------------------------------------------------------------
 //  Copyright (c) 2022 Simon Southwell
 // -----------------------------------------------------------------------------
@@ -33,13 +38,17 @@ module tb
 #(parameter
     GUI_RUN                            = 0,
     CLK_FREQ_MHZ                       = 100,
-    SLZW_MEMSIZE                       = 10240,
+    SLZW_CWMAX                         = 12,
+    SLZW_MEMSIZE                       = (5 * (1 << SLZW_CWMAX)) / 2,
+    NUM_CLIENTS                        = 0,       // Client VProc nodes, in addition to node 0 (max 15)
     EN_MEM_MODEL_RD_Q                  = 1,
     ARUSER                             = 1'b1,    // If Cacheable accesses required, this must be 1
     ARCACHE                            = 4'b1110  // For cacheable accesses, bit 3 must be 1, and the rest a valid value as per A4.4 of AXI4 spec.
 )
 (/* no ports */);
 
+localparam NUM_NODES                   = NUM_CLIENTS + 1;
+
 // ---------------------------------------------
 // -- Signal declarations
 // ---------------------------------------------
@@ -71,6 +80,19 @@ wire                                   avs_csr_write_tb;
 wire                                   avs_csr_read_tb;
 wire [31:0]                            avs_csr_readdata_tb;
 
+wire                                   avs_csr_write_lock;
+wire                                   avs_csr_read_lock;
+wire [31:0]                            avs_csr_readdata_lock;
+
+// VProc node Avalon buses, to the arbiter (node 0 in the least significant bits)
+wire [NUM_NODES*32-1:0]                vp_address;
+wire [NUM_NODES-1:0]                   vp_write;
+wire [NUM_NODES*32-1:0]                vp_writedata;
+wire [NUM_NODES-1:0]                   vp_read;
+wire [31:0]                            vp_readdata;
+wire [NUM_NODES-1:0]                   vp_readdatavalid;
+wire [NUM_NODES-1:0]                   vp_waitrequest;
+
 // Avalon Master read interface from memory model
 wire                                   avm_rx_waitrequest;
 wire [11:0]                            avm_rx_burstcount;
@@ -109,6 +131,32 @@ wire [31:0]                            axm_rdata;
 wire                                   axm_rvalid;
 wire                                   axm_rready;
 
+// AXI-4 bus signals, from the memory latency model to the converter
+wire [31:0]                            axm_awaddr_mem;
+wire  [7:0]                            axm_awlen_mem;
+wire                                   axm_awvalid_mem;
+wire                                   axm_awready_mem;
+wire [31:0]                            axm_wdata_mem;
+wire                                   axm_wlast_mem;
+wire                                   axm_wvalid_mem;
+wire                                   axm_wready_mem;
+wire                                   axm_bvalid_mem;
+wire                                   axm_bready_mem;
+wire [31:0]                            axm_araddr_mem;
+wire  [7:0]                            axm_arlen_mem;
+wire                                   axm_arvalid_mem;
+wire                                   axm_arready_mem;
+wire [31:0]                            axm_rdata_mem;
+wire                                   axm_rvalid_mem;
+wire                                   axm_rready_mem;
+
+// Memory latency model configuration
+wire [15:0]                            mem_rd_latency;
+wire [15:0]                            mem_wr_latency;
+wire  [7:0]                            mem_jitter;
+wire  [7:0]                            mem_max_outstanding;
+wire  [7:0]                            mem_stall_rate;
+
 // Memory model write port
 wire                                   wr_valid;
 wire [31:0]                            wr_data;
@@ -167,6 +215,10 @@ wire                                   failed;
     .memory_read                       (avs_csr_read_mem),
     .memory_readdata                   (avs_csr_readdata_mem),
 
+    .lock_write                        (avs_csr_write_lock),
+    .lock_read                         (avs_csr_read_lock),
+    .lock_readdata                     (avs_csr_readdata_lock),
+
     .avs_address                       (avs_csr_address[28:24]),
     .avs_write                         (avs_csr_write),
     .avs_read                          (avs_csr_read),
@@ -188,10 +240,17 @@ wire                                   failed;
     .control_partial_test              (partial_test),
 
     .config_clk_freq                   (CLK_FREQ_MHZ[8:0]),
+    .config_clients                    (NUM_CLIENTS[3:0]),
 
     .time_count                        (count_vec),
     .timeout                           (timeout),
 
+    .mem_rd_latency                    (mem_rd_latency),
+    .mem_wr_latency                    (mem_wr_latency),
+    .mem_jitter                        (mem_jitter),
+    .mem_max_outstanding               (mem_max_outstanding),
+    .mem_stall_rate                    (mem_stall_rate),
+
     .avs_address                       (avs_csr_address[4:0]),
     .avs_write                         (avs_csr_write_tb),
     .avs_writedata                     (avs_csr_writedata),
@@ -201,25 +260,91 @@ wire                                   failed;
  );
 
 // ---------------------------------------------
-//  Virtual processor with Avalon bus
+//  Virtual processors with Avalon bus
 // ---------------------------------------------
 
-  avsvproc #(0, 1) avsproc_inst
+  avsvproc #(0, 0) avsproc_inst
   (
     .clk                               (clk),
     .rst_n                             (rst_n),
 
     // Avalon memory mapped master interface
-    .avs_csr_address                   (avs_csr_address),
-    .avs_csr_write                     (avs_csr_write),
-    .avs_csr_writedata                 (avs_csr_writedata),
-    .avs_csr_read                      (avs_csr_read),
-    .avs_csr_readdata                  (avs_csr_readdata),
-    .avs_csr_readdatavalid             (1'b0),
+    .avs_csr_address                   (vp_address[31:0]),
+    .avs_csr_write                     (vp_write[0]),
+    .avs_csr_writedata                 (vp_writedata[31:0]),
+    .avs_csr_read                      (vp_read[0]),
+    .avs_csr_readdata                  (vp_readdata),
+    .avs_csr_readdatavalid             (vp_readdatavalid[0]),
+    .avs_csr_waitrequest               (vp_waitrequest[0]),
 
     .irq                               (1'b0)
   );
 
+  // Client nodes, submitting codec jobs concurrently
+  genvar node;
+
+  generate
+    for (node = 1; node < NUM_NODES; node = node + 1)
+    begin : clients
+
+      avsvproc #(node, 0) avsproc_client_inst
+      (
+        .clk                           (clk),
+        .rst_n                         (rst_n),
+
+        // Avalon memory mapped master interface
+        .avs_csr_address               (vp_address[node*32 +: 32]),
+        .avs_csr_write                 (vp_write[node]),
+        .avs_csr_writedata             (vp_writedata[node*32 +: 32]),
+        .avs_csr_read                  (vp_read[node]),
+        .avs_csr_readdata              (vp_readdata),
+        .avs_csr_readdatavalid         (vp_readdatavalid[node]),
+        .avs_csr_waitrequest           (vp_waitrequest[node]),
+
+        .irq                           (1'b0)
+      );
+    end
+  endgenerate
+
+// ---------------------------------------------
+//  CSR bus arbitration between the nodes
+// ---------------------------------------------
+
+  avs_arbiter #(NUM_NODES) avs_arbiter_inst
+  (
+    .clk                               (clk),
+    .rst_n                             (rst_n),
+
+    .avs_address                       (vp_address),
+    .avs_write                         (vp_write),
+    .avs_writedata                     (vp_writedata),
+    .avs_read                          (vp_read),
+    .avs_readdata                      (vp_readdata),
+    .avs_readdatavalid                 (vp_readdatavalid),
+    .avs_waitrequest                   (vp_waitrequest),
+
+    .avm_address                       (avs_csr_address),
+    .avm_write                         (avs_csr_write),
+    .avm_writedata                     (avs_csr_writedata),
+    .avm_read                          (avs_csr_read),
+    .avm_readdata                      (avs_csr_readdata)
+  );
+
+// ---------------------------------------------
+//  Ticket lock queueing the nodes for the codec
+// ---------------------------------------------
+
+  tb_ticket_lock tb_ticket_lock_inst
+  (
+    .clk                               (clk),
+    .rst_n                             (rst_n),
+
+    .avs_address                       (avs_csr_address[1:0]),
+    .avs_write                         (avs_csr_write_lock),
+    .avs_writedata                     (avs_csr_writedata),
+    .avs_read                          (avs_csr_read_lock),
+    .avs_readdata                      (avs_csr_readdata_lock)
+  );
 
 // ---------------------------------------------
 //  Instantiation of memory model
@@ -262,18 +387,24 @@ wire                                   failed;
   );
 
 // ---------------------------------------------
-// Convert AXI bus signalling to Avalon bus
+// Memory latency, outstanding transaction and
+// backpressure model
 // ---------------------------------------------
 
-  axi_av_conv axi_av_conv_i
+  axi_mem_lat axi_mem_lat_i
   (
-    .aclk                              (clk),
-    .aresetn                           (rst_n),
+    .clk                               (clk),
+    .rst_n                             (rst_n),
 
-    // AXI4 slave interface
+    .rd_latency                        (mem_rd_latency),
+    .wr_latency                        (mem_wr_latency),
+    .jitter                            (mem_jitter),
+    .max_outstanding                   (mem_max_outstanding),
+    .stall_rate                        (mem_stall_rate),
+
+    // AXI4 slave interface, from the core
     .axs_awaddr                        (axm_awaddr),
     .axs_awlen                         (axm_awlen),
-    .axs_awprot                        (axm_arprot),
     .axs_awvalid                       (axm_awvalid),
     .axs_awready                       (axm_awready),
 
@@ -287,9 +418,6 @@ wire                                   failed;
 
     .axs_araddr                        (axm_araddr),
     .axs_arlen                         (axm_arlen),
-    .axs_arcache                       (axm_arcache),
-    .axs_aruser                        (axm_aruser),
-    .axs_arprot                        (axm_arprot),
     .axs_arvalid                       (axm_arvalid),
     .axs_arready                       (axm_arready),
 
@@ -297,6 +425,66 @@ wire                                   failed;
     .axs_rvalid                        (axm_rvalid),
     .axs_rready                        (axm_rready),
 
+    // AXI4 master interface, to the converter
+    .axm_awaddr                        (axm_awaddr_mem),
+    .axm_awlen                         (axm_awlen_mem),
+    .axm_awvalid                       (axm_awvalid_mem),
+    .axm_awready                       (axm_awready_mem),
+
+    .axm_wdata                         (axm_wdata_mem),
+    .axm_wlast                         (axm_wlast_mem),
+    .axm_wvalid                        (axm_wvalid_mem),
+    .axm_wready                        (axm_wready_mem),
+
+    .axm_bvalid                        (axm_bvalid_mem),
+    .axm_bready                        (axm_bready_mem),
+
+    .axm_araddr                        (axm_araddr_mem),
+    .axm_arlen                         (axm_arlen_mem),
+    .axm_arvalid                       (axm_arvalid_mem),
+    .axm_arready                       (axm_arready_mem),
+
+    .axm_rdata                         (axm_rdata_mem),
+    .axm_rvalid                        (axm_rvalid_mem),
+    .axm_rready                        (axm_rready_mem)
+  );
+
+// ---------------------------------------------
+// Convert AXI bus signalling to Avalon bus
+// ---------------------------------------------
+
+  axi_av_conv axi_av_conv_i
+  (
+    .aclk                              (clk),
+    .aresetn                           (rst_n),
+
+    // AXI4 slave interface
+    .axs_awaddr                        (axm_awaddr_mem),
+    .axs_awlen                         (axm_awlen_mem),
+    .axs_awprot                        (axm_arprot),
+    .axs_awvalid                       (axm_awvalid_mem),
+    .axs_awready                       (axm_awready_mem),
+
+    .axs_wdata                         (axm_wdata_mem),
+    .axs_wlast                         (axm_wlast_mem),
+    .axs_wvalid                        (axm_wvalid_mem),
+    .axs_wready                        (axm_wready_mem),
+
+    .axs_bvalid                        (axm_bvalid_mem),
+    .axs_bready                        (axm_bready_mem),
+
+    .axs_araddr                        (axm_araddr_mem),
+    .axs_arlen                         (axm_arlen_mem),
+    .axs_arcache                       (axm_arcache),
+    .axs_aruser                        (axm_aruser),
+    .axs_arprot                        (axm_arprot),
+    .axs_arvalid                       (axm_arvalid_mem),
+    .axs_arready                       (axm_arready_mem),
+
+    .axs_rdata                         (axm_rdata_mem),
+    .axs_rvalid                        (axm_rvalid_mem),
+    .axs_rready                        (axm_rready_mem),
+
     // Avalon read burst bus
     .avm_rx_waitrequest                (avm_rx_waitrequest),
     .avm_rx_burstcount                 (avm_rx_burstcount),
@@ -321,6 +509,7 @@ wire                                   failed;
   core
   #(
     .CLK_FREQ_MHZ                      (CLK_FREQ_MHZ),
+    .CWMAX                             (SLZW_CWMAX),
     .MEMSIZE                           (SLZW_MEMSIZE),
     .ARUSER                            (ARUSER),
     .ARCACHE                           (ARCACHE)
@@ -374,6 +563,8 @@ wire                                   failed;
 
     .axm_awaddr                        (axm_awaddr),
     .axm_awlen                         (axm_awlen),
+    .axm_awcache                       (),            // Unused, no cache coherency issues
+    .axm_awuser                        (),            // Unused, no cache coherency issues
     .axm_awprot                        (axm_arprot), // Unused, no privilege levels
     .axm_awvalid                       (axm_awvalid),
     .axm_awready                       (axm_awready),
@@ -0,0 +1,100 @@
+// -----------------------------------------------------------------------------
+//  Title      : Test bench ticket lock
+// -----------------------------------------------------------------------------
+//  File       : tb_ticket_lock.v
+//  Author     : Simon Southwell
+//  Created    : 2022-03-14
+//  Platform   :
+//  Standard   : Verilog 2001
+// -----------------------------------------------------------------------------
+//  Description:
+//  This block is a ticket lock on the test bench CSR bus, used to queue VProc
+//  nodes contending for the codec in first come, first served order. A node
+//  takes a ticket by reading the ticket register, which returns the next
+//  ticket number and advances it. It owns the lock when the serving register
+//  reads back its ticket, and releases it by writing to the serving register,
+//  which advances it to the next ticket. The queued register reads the number
+//  of tickets taken and not yet released.
+//
+//  Accesses from the nodes are serialised by the CSR bus arbiter, so taking a
+//  ticket is atomic. As with the other CSR bus slaves, read data is returned
+//  in the cycle after the read.
+//
+//  Registers (word offsets):
+//    0 : ticket  (r)  Take the next ticket
+//    1 : serving (rw) Ticket now served. Any write releases the lock
+//    2 : queued  (r)  Tickets outstanding, including the one served
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+`timescale 1ns / 10ps
+
+module tb_ticket_lock
+(
+  input                                clk,
+  input                                rst_n,
+
+  // Avalon CSR slave bus
+  input  [1:0]                         avs_address,
+  input                                avs_write,
+  input  [31:0]                        avs_writedata,  // Unused, any write releases
+  input                                avs_read,
+  output reg [31:0]                    avs_readdata
+);
+
+localparam                             TICKET_REG        = 2'd0;
+localparam                             SERVING_REG       = 2'd1;
+localparam                             QUEUED_REG        = 2'd2;
+
+reg [15:0]                             next_ticket;
+reg [15:0]                             serving;
+
+always @(posedge clk or negedge rst_n)
+begin
+  if (rst_n == 1'b0)
+  begin
+    next_ticket                        <= 16'h0;
+    serving                            <= 16'h0;
+    avs_readdata                       <= 32'h0;
+  end
+  else
+  begin
+    if (avs_read)
+    begin
+      case (avs_address)
+      TICKET_REG:
+      begin
+        avs_readdata                   <= {16'h0, next_ticket};
+        next_ticket                    <= next_ticket + 16'h1;
+      end
+      SERVING_REG: avs_readdata        <= {16'h0, serving};
+      QUEUED_REG:  avs_readdata        <= {16'h0, next_ticket - serving};
+      default:     avs_readdata        <= 32'h0;
+      endcase
+    end
+
+    // Release the lock to the next ticket
+    if (avs_write && avs_address == SERVING_REG && serving != next_ticket)
+    begin
+      serving                          <= serving + 16'h1;
+    end
+  end
+end
+
+endmodule
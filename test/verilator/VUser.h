@@ -0,0 +1,44 @@
+// -----------------------------------------------------------------------------
+//  Title      : VProc user API substitute for Verilator simulation
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : VUser.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file stands in for the VProc VUser.h header when the test code is
+//  built for the Verilator simulation, providing the parts of the API used
+//  by the test code. VTick() is implemented by sim_main.cpp.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _VUSER_H_
+#define _VUSER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define VPrint printf
+
+// Advance the simulation by ticks clock cycles
+extern void VTick (const uint32_t ticks, const uint32_t node);
+
+#endif
@@ -0,0 +1,186 @@
+// -----------------------------------------------------------------------------
+//  Title      : AXI-4 memory model for Verilator simulation
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : axi_mem.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the methods of the AXI-4 memory model
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdlib.h>
+
+#include "axi_mem.h"
+
+// -------------------------------------------------------------------------
+// Return a pointer to the word at byte address addr,
+// allocating a zeroed page on first access
+// -------------------------------------------------------------------------
+
+uint32_t* axiMem::getWord(const uint32_t addr)
+{
+    const uint32_t word = addr >> 2;
+    const uint32_t page = word >> AXI_MEM_PAGE_WORDS_LOG2;
+
+    std::vector<uint32_t> &p = pages[page];
+
+    if (p.empty())
+    {
+        p.resize(1 << AXI_MEM_PAGE_WORDS_LOG2, 0);
+    }
+
+    return &p[word & ((1 << AXI_MEM_PAGE_WORDS_LOG2) - 1)];
+}
+
+// -------------------------------------------------------------------------
+// Set the memory timing
+// -------------------------------------------------------------------------
+
+void axiMem::setTiming(const uint32_t rdLat, const uint32_t wrLat, const uint32_t jit,
+                       const uint32_t outstanding, const uint32_t stall)
+{
+    rdLatency      = rdLat;
+    wrLatency      = wrLat;
+    jitter         = jit;
+    maxOutstanding = (outstanding == 0 || outstanding > AXI_MEM_MAX_OUTSTANDING) ? AXI_MEM_MAX_OUTSTANDING : outstanding;
+    stallRate      = stall;
+}
+
+// -------------------------------------------------------------------------
+// Cycle after which data or a response with the given latency, plus
+// random jitter, is available
+// -------------------------------------------------------------------------
+
+uint64_t axiMem::readyAt(const uint32_t latency)
+{
+    return cycle + latency + (jitter ? (rand() % (jitter + 1)) : 0);
+}
+
+// -------------------------------------------------------------------------
+// Randomly choose whether a signal stalls for a cycle
+// -------------------------------------------------------------------------
+
+bool axiMem::stall()
+{
+    return stallRate && (uint32_t)(rand() & 0xff) < stallRate;
+}
+
+// -------------------------------------------------------------------------
+// Direct access
+// -------------------------------------------------------------------------
+
+uint32_t axiMem::readWord(const uint32_t addr)
+{
+    return *getWord(addr);
+}
+
+void axiMem::writeWord(const uint32_t addr, const uint32_t data)
+{
+    *getWord(addr) = data;
+}
+
+// -------------------------------------------------------------------------
+// Set the slave outputs for the current cycle
+// -------------------------------------------------------------------------
+
+void axiMem::drive(axiPins_t &pins)
+{
+    pins.arready = !stallAr && rdq.size() < maxOutstanding;
+    pins.rvalid  = !stallR  && !rdq.empty() && cycle >= rdq.front().readyCycle;
+    pins.rdata   = rdq.empty() ? 0 : readWord(rdq.front().addr);
+
+    // Write bursts are outstanding until their response
+    pins.awready = !stallAw && (awq.size() + bq.size()) < maxOutstanding;
+
+    // Write data is accepted once its burst's address is known
+    pins.wready  = !stallW  && !awq.empty();
+
+    pins.bvalid  = !bq.empty() && cycle >= bq.front().readyCycle;
+}
+
+// -------------------------------------------------------------------------
+// Update state from the handshakes at the clock edge
+// -------------------------------------------------------------------------
+
+void axiMem::sample(const axiPins_t &pins)
+{
+    // Read data beat
+    if (pins.rvalid && pins.rready)
+    {
+        rdq.front().addr += 4;
+        rdBeats++;
+
+        if (--rdq.front().beats == 0)
+        {
+            rdq.pop_front();
+        }
+    }
+
+    // Write data beat
+    if (pins.wvalid && pins.wready)
+    {
+        writeWord(awq.front().addr, pins.wdata);
+        awq.front().addr += 4;
+        wrBeats++;
+
+        if (--awq.front().beats == 0 || pins.wlast)
+        {
+            burst_t b = awq.front();
+            b.readyCycle = readyAt(wrLatency) + 1;
+            bq.push_back(b);
+            awq.pop_front();
+        }
+    }
+
+    // Write response
+    if (pins.bvalid && pins.bready)
+    {
+        bq.pop_front();
+    }
+
+    // New bursts are queued after this cycle's data so that
+    // data is returned no earlier than the following cycle
+    if (pins.arvalid && pins.arready)
+    {
+        burst_t b = {pins.araddr, pins.arlen + 1, readyAt(rdLatency) + 1};
+        rdq.push_back(b);
+    }
+
+    if (pins.awvalid && pins.awready)
+    {
+        burst_t b = {pins.awaddr, pins.awlen + 1, 0};
+        awq.push_back(b);
+    }
+
+    // Choose the stalls for the next cycle
+    stallAr = stall();
+    stallAw = stall();
+    stallR  = stall();
+    stallW  = stall();
+
+    cycle++;
+}
@@ -0,0 +1,160 @@
+// -----------------------------------------------------------------------------
+//  Title      : AXI-4 memory model for Verilator simulation
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : axi_mem.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the definition of a cycle based AXI-4 slave memory
+//  model, for connection to the core's AXI master ports in the Verilator
+//  simulation. Memory is sparse, allocated in pages on first access, and is
+//  also accessible directly (bypassing the simulation) for test preload and
+//  checking.
+//
+//  Each cycle, drive() sets the slave's outputs from the model's state,
+//  and sample() updates the state from the handshakes seen at the clock
+//  edge. Reads and writes accept up to AXI_MEM_MAX_OUTSTANDING bursts, with
+//  a read burst returning one beat per cycle, in order.
+//
+//  By default the memory is ideal. setTiming() adds read latency, write
+//  response latency, random jitter, a lower outstanding burst limit and a
+//  random stall rate on the ready and read data signals, matching the
+//  ModelSim test bench's axi_mem_lat.v.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _AXI_MEM_H_
+#define _AXI_MEM_H_
+
+// -------------------------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+// -------------------------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------------------------
+
+#define AXI_MEM_MAX_OUTSTANDING   16
+#define AXI_MEM_PAGE_WORDS_LOG2   12
+
+// -------------------------------------------------------------------------
+// TYPEDEFS
+// -------------------------------------------------------------------------
+
+// AXI signals, as seen by the slave
+typedef struct {
+    // Write address
+    uint32_t awaddr;
+    uint32_t awlen;
+    bool     awvalid;
+    bool     awready;
+
+    // Write data
+    uint32_t wdata;
+    bool     wlast;
+    bool     wvalid;
+    bool     wready;
+
+    // Write response
+    bool     bvalid;
+    bool     bready;
+
+    // Read address
+    uint32_t araddr;
+    uint32_t arlen;
+    bool     arvalid;
+    bool     arready;
+
+    // Read data
+    uint32_t rdata;
+    bool     rvalid;
+    bool     rready;
+} axiPins_t;
+
+// -------------------------------------------------------------------------
+// CLASS DEFINITION
+// -------------------------------------------------------------------------
+
+class axiMem
+{
+public:
+    axiMem() : rdBeats(0), wrBeats(0), cycle(0), rdLatency(0), wrLatency(0), jitter(0),
+               maxOutstanding(AXI_MEM_MAX_OUTSTANDING), stallRate(0),
+               stallAr(false), stallAw(false), stallR(false), stallW(false) {};
+
+    // Set the memory timing. An outstanding limit of 0 selects AXI_MEM_MAX_OUTSTANDING,
+    // and stallRate is the probability, in 256ths, of a stall on each signal each cycle
+    void     setTiming       (const uint32_t rdLat, const uint32_t wrLat, const uint32_t jit,
+                              const uint32_t outstanding, const uint32_t stall);
+
+    // Direct (backdoor) access, with byte addresses
+    uint32_t readWord        (const uint32_t addr);
+    void     writeWord       (const uint32_t addr, const uint32_t data);
+
+    // Per cycle bus interface
+    void     drive           (axiPins_t &pins);
+    void     sample          (const axiPins_t &pins);
+
+    // Beats transferred over the bus
+    uint64_t getReadBeats    () { return rdBeats; };
+    uint64_t getWriteBeats   () { return wrBeats; };
+
+private:
+
+    typedef struct {
+        uint32_t addr;
+        uint32_t beats;
+        uint64_t readyCycle;        // Cycle from which read data or write response is available
+    } burst_t;
+
+    uint32_t* getWord        (const uint32_t addr);
+    uint64_t  readyAt        (const uint32_t latency);
+    bool      stall          ();
+
+    std::unordered_map<uint32_t, std::vector<uint32_t> > pages;
+
+    std::deque<burst_t> rdq;
+    std::deque<burst_t> awq;
+    std::deque<burst_t> bq;
+
+    uint64_t            rdBeats;
+    uint64_t            wrBeats;
+    uint64_t            cycle;
+
+    uint32_t            rdLatency;
+    uint32_t            wrLatency;
+    uint32_t            jitter;
+    uint32_t            maxOutstanding;
+    uint32_t            stallRate;
+
+    bool                stallAr;
+    bool                stallAw;
+    bool                stallR;
+    bool                stallW;
+};
+
+#endif
@@ -0,0 +1,42 @@
+// -----------------------------------------------------------------------------
+//  Title      : Memory model API substitute for Verilator simulation
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : mem_model.h
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file stands in for the mem_model direct access API header when the
+//  test code is built for the Verilator simulation. The functions access
+//  the AXI memory model, and are implemented by sim_main.cpp. As with
+//  mem_model, addresses are word addresses.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef _MEM_MODEL_H_
+#define _MEM_MODEL_H_
+
+#include <stdint.h>
+
+extern void     WriteRamWord (const uint64_t addr, const uint32_t data, const int little_endian, const uint32_t node);
+extern uint32_t ReadRamWord  (const uint64_t addr, const int little_endian, const uint32_t node);
+
+#endif
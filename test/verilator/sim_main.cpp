@@ -0,0 +1,455 @@
+// -----------------------------------------------------------------------------
+//  Title      : Verilator simulation top level
+//  Project    : vslzw
+// -----------------------------------------------------------------------------
+//  File       : sim_main.cpp
+//  Author     : Simon Southwell
+//  Created    : 2022-03-02
+//  Standard   : C++11
+// -----------------------------------------------------------------------------
+//  Description:
+//  This file contains the top level for the Verilator simulation of the core.
+//  It clocks the Verilated core, connecting its AXI master ports to the AXI
+//  memory model, and implements the test bench functions of VUserMain0.h,
+//  so that the same tests class used with VProc in ModelSim is run, with CSR
+//  accesses driven directly on the core's Avalon slave port.
+//
+//  Address decode follows the ModelSim test bench: test bench registers at
+//  TB_BASE_ADDR, memory at MEM_BASE_ADDR, and the core below that.
+//
+//  The core's clk_x2 and clk_div2 inputs are driven in phase with clk, as in
+//  the ModelSim test bench, for builds with a CODEC_CLK_SEL selecting them.
+// -----------------------------------------------------------------------------
+//  Copyright (c) 2022 Simon Southwell
+// -----------------------------------------------------------------------------
+//
+//  This is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  It is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+
+// --------------------------------------------------
+// INCLUDES
+// --------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Vcore.h"
+#include "verilated.h"
+#ifdef VM_TRACE
+#include "verilated_vcd_c.h"
+#endif
+
+#include "VUserMain0.h"
+#include "tests.h"
+#include "utils.h"
+#include "tb.h"
+#include "axi_mem.h"
+
+extern "C" {
+#include "mem_model.h"
+}
+
+// --------------------------------------------------
+// DEFINES
+// --------------------------------------------------
+
+#ifndef CORE_0_BASE
+#define CORE_0_BASE            0
+#endif
+
+// Must match the core's CLK_FREQ_MHZ parameter
+#ifndef SIM_CLK_FREQ_MHZ
+#define SIM_CLK_FREQ_MHZ       100
+#endif
+
+// Must match the core's CODEC_CLK_SEL parameter. Only a clk_x2 codec clock
+// needs evaluating between the clk edges.
+#ifndef SIM_CODEC_CLK_SEL
+#define SIM_CODEC_CLK_SEL      0
+#endif
+
+// Simulation time limit, in clock cycles
+#ifndef SIM_MAX_CYCLES
+#define SIM_MAX_CYCLES         2000000000ULL
+#endif
+
+#define RESET_CYCLES           10
+
+#define ALIVE_TEST_NUM         0x12345678
+#define ALIVE_TEST_OFFSET      0x1000
+#define ALIVE_TEST_NUM1        0xface900d
+
+// --------------------------------------------------
+// STATIC VARIABLES
+// --------------------------------------------------
+
+static Vcore*          top    = NULL;
+static axiMem*         mem    = NULL;
+static uint64_t        cycle  = 0;
+
+#ifdef VM_TRACE
+static VerilatedVcdC*  tfp    = NULL;
+#endif
+
+// --------------------------------------------------
+// Finish the simulation, reporting statistics
+// --------------------------------------------------
+
+static void endSim(const int error)
+{
+    top->final();
+
+#ifdef VM_TRACE
+    tfp->close();
+#endif
+
+    printf("\nSimulation finished at cycle %llu with status %d (AXI read beats %llu, write beats %llu)\n\n",
+           (unsigned long long)cycle, error,
+           (unsigned long long)mem->getReadBeats(), (unsigned long long)mem->getWriteBeats());
+
+    exit(error);
+}
+
+// --------------------------------------------------
+// Advance the simulation one clock cycle
+// --------------------------------------------------
+
+static void tick()
+{
+    axiPins_t pins;
+
+    // Slave outputs for this cycle
+    mem->drive(pins);
+
+    top->axm_arready = pins.arready;
+    top->axm_rvalid  = pins.rvalid;
+    top->axm_rdata   = pins.rdata;
+    top->axm_awready = pins.awready;
+    top->axm_wready  = pins.wready;
+    top->axm_bvalid  = pins.bvalid;
+    top->eval();
+
+    // Master outputs, as seen at the clock edge
+    pins.araddr      = top->axm_araddr;
+    pins.arlen       = top->axm_arlen;
+    pins.arvalid     = top->axm_arvalid;
+    pins.rready      = top->axm_rready;
+    pins.awaddr      = top->axm_awaddr;
+    pins.awlen       = top->axm_awlen;
+    pins.awvalid     = top->axm_awvalid;
+    pins.wdata       = top->axm_wdata;
+    pins.wlast       = top->axm_wlast;
+    pins.wvalid      = top->axm_wvalid;
+    pins.bready      = top->axm_bready;
+
+    mem->sample(pins);
+
+    // clk_x2 rises with each clk edge, and clk_div2 toggles on each rising
+    // edge of clk. clk_x2's falling edges are only simulated when it clocks
+    // the codec.
+    top->clk      = 1;
+    top->clk_x2   = 1;
+    top->clk_div2 = !top->clk_div2;
+    top->eval();
+#ifdef VM_TRACE
+    tfp->dump(cycle * 4 + 1);
+#endif
+
+#if SIM_CODEC_CLK_SEL == 1
+    top->clk_x2   = 0;
+    top->eval();
+#ifdef VM_TRACE
+    tfp->dump(cycle * 4 + 2);
+#endif
+
+    top->clk      = 0;
+    top->clk_x2   = 1;
+    top->eval();
+#ifdef VM_TRACE
+    tfp->dump(cycle * 4 + 3);
+#endif
+
+    top->clk_x2   = 0;
+    top->eval();
+#ifdef VM_TRACE
+    tfp->dump(cycle * 4 + 4);
+#endif
+#else
+    top->clk      = 0;
+    top->clk_x2   = 0;
+    top->eval();
+#ifdef VM_TRACE
+    tfp->dump(cycle * 4 + 3);
+#endif
+#endif
+
+    if (++cycle >= SIM_MAX_CYCLES)
+    {
+        VPrint("***ERROR: simulation timed out at cycle %llu\n", (unsigned long long)cycle);
+        endSim(1);
+    }
+}
+
+// --------------------------------------------------
+// VProc API substitute
+// --------------------------------------------------
+
+void VTick(const uint32_t ticks, const uint32_t node)
+{
+    for (uint32_t idx = 0; idx < ticks; idx++)
+    {
+        tick();
+    }
+}
+
+// --------------------------------------------------
+// mem_model direct API substitute (word addresses)
+// --------------------------------------------------
+
+void WriteRamWord(const uint64_t addr, const uint32_t data, const int little_endian, const uint32_t node)
+{
+    mem->writeWord(addr * 4, data);
+}
+
+uint32_t ReadRamWord(const uint64_t addr, const int little_endian, const uint32_t node)
+{
+    return mem->readWord(addr * 4);
+}
+
+// --------------------------------------------------
+// Hooks for auto-generated HAL
+// --------------------------------------------------
+
+uint32_t read_ext (uint32_t addr, uint32_t* data)
+{
+    return csrReadMem(addr, data);
+}
+
+void write_ext (uint32_t addr, uint32_t data)
+{
+    csrWriteMem(addr, data);
+}
+
+// --------------------------------------------------
+// Read function to access memory over CSR bus
+// --------------------------------------------------
+
+uint32_t csrReadMem (uint32_t addr, uint32_t* data)
+{
+    if (addr >= TB_BASE_ADDR)
+    {
+        *data = 0;
+    }
+    else if (addr >= MEM_BASE_ADDR)
+    {
+        *data = mem->readWord(addr);
+    }
+    else
+    {
+        // Hold read over the clock edge, and take the data
+        // before it is removed
+        top->avs_csr_address = (addr >> 2) & 0x3ffff;
+        top->avs_csr_read    = 1;
+        tick();
+        *data                = top->avs_csr_readdata;
+        top->avs_csr_read    = 0;
+    }
+
+    // Model some access rate time
+    VTick(AVS_ACCESS_LEN, 0);
+
+    return 0;
+}
+
+// --------------------------------------------------
+// Write function to access memory over CSR bus
+// --------------------------------------------------
+
+void csrWriteMem (uint32_t addr, uint32_t data)
+{
+    if (addr >= TB_BASE_ADDR)
+    {
+        if (addr == TB_SIM_CTRL_REG && (data & (TB_SIM_CTRL_STOP_MASK | TB_SIM_CTRL_FINISH_MASK)))
+        {
+            endSim((data & TB_SIM_CTRL_ERROR_MASK) ? 1 : 0);
+        }
+    }
+    else if (addr >= MEM_BASE_ADDR)
+    {
+        mem->writeWord(addr, data);
+    }
+    else
+    {
+        top->avs_csr_address   = (addr >> 2) & 0x3ffff;
+        top->avs_csr_writedata = data;
+        top->avs_csr_write     = 1;
+        tick();
+        top->avs_csr_write     = 0;
+    }
+
+    // Model some access rate time
+    VTick(AVS_ACCESS_LEN, 0);
+}
+
+// --------------------------------------------------
+// Direct memory access (bypass sim)
+// --------------------------------------------------
+
+uint32_t directReadMem (uint32_t addr, uint32_t* data)
+{
+    *data = mem->readWord(addr);
+
+    return 0;
+}
+
+void directWriteMem (uint32_t addr, uint32_t data)
+{
+    mem->writeWord(addr, data);
+}
+
+uint32_t directReadMemBlock (uint32_t addr, uint8_t* buf, uint32_t len)
+{
+    for (uint32_t idx = 0; idx < len; idx += 4)
+    {
+        uint32_t word = mem->readWord(addr + idx);
+        memcpy(buf + idx, &word, (len - idx) < 4 ? (len - idx) : 4);
+    }
+
+    return 0;
+}
+
+void directWriteMemBlock (uint32_t addr, const uint8_t* buf, uint32_t len)
+{
+    for (uint32_t idx = 0; idx < len; idx += 4)
+    {
+        uint32_t word = 0;
+        memcpy(&word, buf + idx, (len - idx) < 4 ? (len - idx) : 4);
+        mem->writeWord(addr + idx, word);
+    }
+}
+
+// --------------------------------------------------
+// Simulation control functions
+// --------------------------------------------------
+
+void stopSim(bool error)
+{
+    csrWriteMem(TB_SIM_CTRL_REG, TB_SIM_CTRL_STOP_MASK   | (error ? TB_SIM_CTRL_ERROR_MASK : 0));
+}
+
+void finishSim(int error)
+{
+    csrWriteMem(TB_SIM_CTRL_REG, TB_SIM_CTRL_FINISH_MASK | (error ? TB_SIM_CTRL_ERROR_MASK : 0));
+}
+
+void usleepSim(unsigned time)
+{
+    VTick(time * SIM_CLK_FREQ_MHZ, 0);
+}
+
+void nsleepSim(unsigned time)
+{
+    uint32_t ticks = (time * SIM_CLK_FREQ_MHZ + 500) / 1000;
+
+    VTick(ticks ? ticks : 1, 0);
+}
+
+// ==================================================
+// MAIN FUNCTION
+// ==================================================
+
+int main(int argc, char** argv)
+{
+    int             error = 0;
+    uint32_t        tmp1  = 0;
+    uint32_t        tmp2  = 0;
+    uint32_t        tmp3  = 0;
+    config_t        cfg;
+    struct timespec start, end;
+
+    Verilated::commandArgs(argc, argv);
+
+    top = new Vcore;
+    mem = new axiMem;
+
+#ifdef VM_TRACE
+    Verilated::traceEverOn(true);
+    tfp = new VerilatedVcdC;
+    top->trace(tfp, 99);
+    tfp->open("waves.vcd");
+#endif
+
+    VPrint("\n*****************************\n");
+    VPrint(  "*   Wyvern Semiconductors   *\n");
+    VPrint(  "*   Verilator simulation    *\n");
+    VPrint(  "*    Copyright (c) 2022     *\n");
+    VPrint(  "*****************************\n\n");
+
+    // Parse arguments, or vusermain.cfg if none
+    if (argc > 1 && parseArgs(argc, argv, cfg))
+    {
+        return 1;
+    }
+    else if (argc <= 1)
+    {
+        parseArgs(0, NULL, cfg);
+    }
+
+    // Memory timing, as set in the ModelSim test bench's memory latency model
+    mem->setTiming(cfg.memRdLatency, cfg.memWrLatency, cfg.memJitter, cfg.memOutstanding, cfg.memStallRate);
+
+    // Reset the core
+    top->clk      = 0;
+    top->clk_x2   = 0;
+    top->clk_div2 = 0;
+    top->reset_n  = 0;
+    VTick(RESET_CYCLES, 0);
+    top->reset_n  = 1;
+    VTick(1, 0);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    CCoreAuto* pCore = new CCoreAuto(CORE_0_BASE);
+
+    // Start up access checks, as for the VProc test bench
+    pCore->pScratch->SetScratch(ALIVE_TEST_NUM1);
+    csrWriteMem(MEM_BASE_ADDR + ALIVE_TEST_OFFSET, ALIVE_TEST_NUM);
+    csrReadMem (MEM_BASE_ADDR + ALIVE_TEST_OFFSET, &tmp1);
+    directReadMem (MEM_BASE_ADDR + ALIVE_TEST_OFFSET, &tmp2);
+    tmp3 = pCore->pScratch->GetScratch();
+
+    if (tmp1 != ALIVE_TEST_NUM || tmp2 != ALIVE_TEST_NUM || tmp3 != ALIVE_TEST_NUM1)
+    {
+        VPrint("\nsim_main failed start up memory access check (%08x %08x %08x) \n\n", tmp1, tmp2, tmp3);
+        error = 1;
+    }
+    else
+    {
+        tests* pTest = new tests();
+
+        error = pTest->start(CORE_0_BASE, cfg, 0);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    VPrint("\n%llu cycles in %.2f s (%.0f cycles/s)\n", (unsigned long long)cycle, secs, secs > 0 ? cycle / secs : 0.0);
+
+    finishSim(error);
+
+    return error;
+}